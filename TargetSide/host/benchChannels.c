@@ -0,0 +1,175 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//----------------------------------------------------------------------------
+//    Host-run benchmark of channel sampling: compares the time per sample of
+//    DbgChan_ReadValue() for channels that are resolved by DbgChan_Resolve()
+//    (cached address, single load and compare) with unresolved channels
+//    (pointer-chain walk, memcpy + memcmp + memcpy). Both must return the same
+//    values and changes.
+//
+//    usage: benchChannels [million-ticks]
+//----------------------------------------------------------------------------
+#include "debugChannel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHANNEL_COUNT           (16)
+
+
+typedef struct SApplication
+{
+    uint8_t     rguCounter[4];
+    uint16_t    rguAdc[4];
+    uint32_t    uTime;
+    float       rgfSetpoint[3];
+    double      dPosition;
+    double      dVelocity;
+    double*     pdPosition;
+    uint32_t*   puTime;
+} SApplication;
+
+
+static SApplication g_app;
+
+
+static void InitChannel(SDebugChannel* pChan, void* pSource, uint8_t uSize_bytes, uint8_t uPointerDepth, bool fResolve)
+{
+    DbgChan_Init(pChan);
+    pChan->pSource = (uint8_t*)pSource;
+    pChan->uSize_bytes = uSize_bytes;
+    pChan->uPointerDepth = uPointerDepth;
+    pChan->updateMode = updateFast;
+    pChan->fResolveOnce = true;
+    if (fResolve)
+    {
+        DbgChan_Resolve(pChan);
+    }
+}
+
+
+static void InitChannels(SDebugChannel* rgChan, bool fResolve)
+{
+    int32_t i;
+
+    for (i = 0; i < 4; ++i)
+    {
+        InitChannel(&rgChan[i], &g_app.rguCounter[i], 1, 0, fResolve);
+        InitChannel(&rgChan[4 + i], &g_app.rguAdc[i], 2, 0, fResolve);
+    }
+    InitChannel(&rgChan[8], &g_app.uTime, 4, 0, fResolve);
+    for (i = 0; i < 3; ++i)
+    {
+        InitChannel(&rgChan[9 + i], &g_app.rgfSetpoint[i], 4, 0, fResolve);
+    }
+    InitChannel(&rgChan[12], &g_app.dPosition, 8, 0, fResolve);
+    InitChannel(&rgChan[13], &g_app.dVelocity, 8, 0, fResolve);
+    InitChannel(&rgChan[14], &g_app.pdPosition, 8, 1, fResolve);
+    InitChannel(&rgChan[15], &g_app.puTime, 4, 1, fResolve);
+}
+
+
+static void Step(uint32_t uTick)
+{
+    //some values change every tick, others now and then
+    g_app.rguCounter[uTick & 0x03]++;
+    g_app.rguAdc[0] = (uint16_t)(2048 + (uTick & 0x0F));
+    g_app.uTime = uTick;
+    if ((uTick & 0xFF) == 0)
+    {
+        g_app.rgfSetpoint[1] += 0.5f;
+    }
+    g_app.dPosition += 1e-3;
+}
+
+
+static uint64_t Sample(SDebugChannel* rgChan, uint32_t uTicks, uint64_t* puChecksum)
+{
+    uint8_t rgValue[8];
+    uint64_t uChanges = 0;
+    uint32_t t;
+    int32_t i;
+    int32_t j;
+
+    memset(&g_app, 0, sizeof(g_app));
+    g_app.pdPosition = &g_app.dPosition;
+    g_app.puTime = &g_app.uTime;
+    *puChecksum = 0;
+
+    for (t = 0; t < uTicks; ++t)
+    {
+        Step(t);
+        for (i = 0; i < CHANNEL_COUNT; ++i)
+        {
+            if (DbgChan_ReadValue(&rgChan[i], rgValue))
+            {
+                ++uChanges;
+                for (j = 0; j < rgChan[i].uSize_bytes; ++j)
+                {
+                    *puChecksum = (*puChecksum * 31) + rgValue[j];
+                }
+            }
+        }
+    }
+
+    return uChanges;
+}
+
+
+static double Now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char* argv[])
+{
+    static SDebugChannel rgChanWalk[CHANNEL_COUNT];
+    static SDebugChannel rgChanResolved[CHANNEL_COUNT];
+    uint32_t uTicks = ((argc > 1) ? (uint32_t)atoi(argv[1]) : 10) * 1000000;
+    uint64_t uChangesWalk, uChangesResolved;
+    uint64_t uChecksumWalk, uChecksumResolved;
+    double dStart, dWalk_s, dResolved_s, dSamples;
+
+    //the pointers of the pointer-chains must be valid before resolving
+    g_app.pdPosition = &g_app.dPosition;
+    g_app.puTime = &g_app.uTime;
+    InitChannels(rgChanWalk, false);
+    InitChannels(rgChanResolved, true);
+    dSamples = (double)uTicks * CHANNEL_COUNT;
+
+    dStart = Now_s();
+    uChangesWalk = Sample(rgChanWalk, uTicks, &uChecksumWalk);
+    dWalk_s = Now_s() - dStart;
+
+    dStart = Now_s();
+    uChangesResolved = Sample(rgChanResolved, uTicks, &uChecksumResolved);
+    dResolved_s = Now_s() - dStart;
+
+    printf("%u ticks of %d channels\n", uTicks, CHANNEL_COUNT);
+    printf("walk     : %6.2f ns/sample, %llu changes\n", dWalk_s / dSamples * 1e9, (unsigned long long)uChangesWalk);
+    printf("resolved : %6.2f ns/sample, %llu changes\n", dResolved_s / dSamples * 1e9, (unsigned long long)uChangesResolved);
+
+    //both must see the same values
+    return ((uChangesWalk == uChangesResolved) && (uChecksumWalk == uChecksumResolved)) ? 0 : 1;
+}
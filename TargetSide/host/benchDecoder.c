@@ -0,0 +1,279 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//----------------------------------------------------------------------------
+//    Host-run benchmark of the receive path: compares the throughput (bytes/s)
+//    of the streaming decoder in debugMessage.c with the previous two-pass
+//    decoder (STX/ETX search followed by unescape + CRC), which is kept below
+//    as reference.
+//
+//    usage: benchDecoder [megabytes] [chunk-size]
+//----------------------------------------------------------------------------
+#include "debugMessage.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define STX                     0x55
+#define ETX                     0xAA
+#define ESC                     0x66
+
+#define STREAM_SIZE             (64 * 1024)
+#define INDEX_INC(X)            ++X; X &= ~(0xFFFFFFFF << DEBUG_BUF_IN_SIZE_BITS);
+
+
+//reference: the decoder as it was before the streaming decoder
+typedef struct SLegacyMessageIn
+{
+    bool        fBufferOverrun;
+    bool        fValidMessage;
+    uint32_t    uNodeID;
+    uint8_t     uMsgID;
+    EDebugCmd   cmd;
+    int32_t     nCmdParamSize;
+    uint8_t     rgMessage[DEBUG_MSG_SIZE];
+    bool        _fFoundSTX;
+    uint32_t    _uIndexSTX;
+    uint32_t    _uIndexETX;
+    uint32_t    _uIndexParseNext;
+    uint32_t    _uIndexPush;
+    uint8_t     _rgRawMsgData[DEBUG_BUF_IN_SIZE];
+} SLegacyMessageIn;
+
+
+static uint8_t  g_rgStream[STREAM_SIZE];
+static uint32_t g_uStreamSize;
+static uint32_t g_uFramesInStream;
+static uint8_t  g_rgCrcTable[256];
+
+
+static uint8_t CrcAdd(uint8_t uCRC, uint8_t uByte)
+{
+    return g_rgCrcTable[uCRC ^ uByte];
+}
+
+
+static void LegacyAddReceivedData(SLegacyMessageIn* pMsg, uint8_t* rgData, uint32_t uSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < uSize; ++i)
+    {
+        pMsg->_rgRawMsgData[pMsg->_uIndexPush] = rgData[i];
+        INDEX_INC(pMsg->_uIndexPush);
+        if (pMsg->_uIndexPush == pMsg->_uIndexSTX)
+        {
+            pMsg->fBufferOverrun = true;
+            --pMsg->_uIndexPush;
+            pMsg->_uIndexPush &= DEBUG_BUF_IN_SIZE - 1;
+            break;
+        }
+    }
+}
+
+
+static bool LegacyCheckMsgIn(SLegacyMessageIn* pMsg)
+{
+    bool fValidMsg = false;
+
+    if (pMsg->_fFoundSTX == true)
+    {
+        int32_t nMsgSize;
+        uint8_t uCRC, uNextByte;
+
+        INDEX_INC(pMsg->_uIndexSTX);
+        nMsgSize = 0;
+        uCRC = 0;
+        while (pMsg->_uIndexSTX != pMsg->_uIndexETX)
+        {
+            uNextByte = pMsg->_rgRawMsgData[pMsg->_uIndexSTX];
+            if (uNextByte == ESC)
+            {
+                INDEX_INC(pMsg->_uIndexSTX);
+                uNextByte = pMsg->_rgRawMsgData[pMsg->_uIndexSTX] ^ ESC;
+            }
+            pMsg->rgMessage[nMsgSize] = uNextByte;
+            uCRC = CrcAdd(uCRC, uNextByte);
+            INDEX_INC(pMsg->_uIndexSTX);
+            ++nMsgSize;
+        }
+
+        if ((nMsgSize >= 4) && (uCRC == 0))
+        {
+            pMsg->nCmdParamSize = nMsgSize - 4;
+            pMsg->uNodeID = pMsg->rgMessage[0];
+            pMsg->uMsgID = pMsg->rgMessage[1];
+            pMsg->cmd = (EDebugCmd)pMsg->rgMessage[2];
+            fValidMsg = true;
+        }
+    }
+    pMsg->_fFoundSTX = false;
+
+    return fValidMsg;
+}
+
+
+static bool LegacyDecodeAndCheck(SLegacyMessageIn* pMsg)
+{
+    pMsg->fValidMessage = false;
+
+    while ((pMsg->fValidMessage == false) && (pMsg->_uIndexParseNext != pMsg->_uIndexPush))
+    {
+        if (pMsg->_rgRawMsgData[pMsg->_uIndexParseNext] == STX)
+        {
+            pMsg->_uIndexSTX = pMsg->_uIndexParseNext;
+            pMsg->_fFoundSTX = true;
+        }
+        if (pMsg->_rgRawMsgData[pMsg->_uIndexParseNext] == ETX)
+        {
+            pMsg->_uIndexETX = pMsg->_uIndexParseNext;
+            pMsg->fValidMessage = LegacyCheckMsgIn(pMsg);
+        }
+        INDEX_INC(pMsg->_uIndexParseNext);
+    }
+
+    return pMsg->fValidMessage;
+}
+
+
+//create a stream of valid, encoded messages with random payload (so escape-chars occur)
+static void CreateStream(void)
+{
+    SDebugMessageOut msg;
+    uint8_t rgRaw[DEBUG_MSG_RAW_SIZE];
+    uint32_t uRawSize;
+    uint32_t uRandom = 12345;
+    uint32_t uSize;
+    uint32_t i;
+
+    g_uStreamSize = 0;
+    g_uFramesInStream = 0;
+    while (true)
+    {
+        DebugMsgOut_Init(&msg);
+        msg.uNodeID = 1;
+        msg.uMsgID = (uint8_t)g_uFramesInStream;
+        msg.cmd = cmdReadChannelData;
+        uRandom = uRandom * 1103515245 + 12345;
+        uSize = (uRandom >> 16) % 60;
+        for (i = 0; i < uSize; ++i)
+        {
+            uRandom = uRandom * 1103515245 + 12345;
+            DebugMsgOut_AddByte(&msg, (uint8_t)(uRandom >> 16));
+        }
+        uRawSize = DebugMsgOut_Encode(&msg, rgRaw);
+
+        if (g_uStreamSize + uRawSize > STREAM_SIZE)
+        {
+            break;
+        }
+        memcpy(&g_rgStream[g_uStreamSize], rgRaw, uRawSize);
+        g_uStreamSize += uRawSize;
+        ++g_uFramesInStream;
+    }
+}
+
+
+static double Now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char* argv[])
+{
+    static SDebugMessageIn msgIn;
+    static SLegacyMessageIn msgLegacy;
+    uint32_t uMegabytes = (argc > 1) ? (uint32_t)atoi(argv[1]) : 64;
+    uint32_t uChunk = (argc > 2) ? (uint32_t)atoi(argv[2]) : 32;
+    uint32_t uRepeat;
+    uint32_t uPos;
+    uint32_t uSize;
+    uint32_t r;
+    uint64_t uFramesLegacy = 0;
+    uint64_t uFramesStreaming = 0;
+    double dStart, dLegacy_s, dStreaming_s, dBytes;
+    uint32_t i, j;
+
+    //build the CRC-table (CRC-8 Dallas/Maxim, reflected polynomial 0x8C)
+    for (i = 0; i < 256; ++i)
+    {
+        uint8_t uCRC = (uint8_t)i;
+        for (j = 0; j < 8; ++j)
+        {
+            uCRC = (uCRC & 0x01) ? ((uCRC >> 1) ^ 0x8C) : (uCRC >> 1);
+        }
+        g_rgCrcTable[i] = uCRC;
+    }
+
+    if ((uChunk == 0) || (uChunk >= DEBUG_BUF_IN_SIZE))
+    {
+        fprintf(stderr, "chunk-size must be 1...%d\n", DEBUG_BUF_IN_SIZE - 1);
+        return 1;
+    }
+
+    CreateStream();
+    uRepeat = (uint32_t)(((uint64_t)uMegabytes << 20) / g_uStreamSize) + 1;
+    dBytes = (double)uRepeat * g_uStreamSize;
+
+    //legacy decoder
+    memset(&msgLegacy, 0, sizeof(msgLegacy));
+    dStart = Now_s();
+    for (r = 0; r < uRepeat; ++r)
+    {
+        for (uPos = 0; uPos < g_uStreamSize; uPos += uSize)
+        {
+            uSize = (g_uStreamSize - uPos < uChunk) ? (g_uStreamSize - uPos) : uChunk;
+            LegacyAddReceivedData(&msgLegacy, &g_rgStream[uPos], uSize);
+            while (LegacyDecodeAndCheck(&msgLegacy))
+            {
+                ++uFramesLegacy;
+            }
+        }
+    }
+    dLegacy_s = Now_s() - dStart;
+
+    //streaming decoder
+    DebugMsgIn_Init(&msgIn);
+    dStart = Now_s();
+    for (r = 0; r < uRepeat; ++r)
+    {
+        for (uPos = 0; uPos < g_uStreamSize; uPos += uSize)
+        {
+            uSize = (g_uStreamSize - uPos < uChunk) ? (g_uStreamSize - uPos) : uChunk;
+            DebugMsgIn_AddReceivedData(&msgIn, &g_rgStream[uPos], uSize);
+            while (DebugMsgIn_DecodeAndCheck(&msgIn))
+            {
+                ++uFramesStreaming;
+            }
+        }
+    }
+    dStreaming_s = Now_s() - dStart;
+
+    printf("stream: %u bytes, %u frames, repeated %u times, chunk %u bytes\n", g_uStreamSize, g_uFramesInStream, uRepeat, uChunk);
+    printf("legacy    : %8.1f MB/s, %llu frames\n", dBytes / dLegacy_s / 1e6, (unsigned long long)uFramesLegacy);
+    printf("streaming : %8.1f MB/s, %llu frames (framing errors %u, crc errors %u, overruns %u)\n",
+           dBytes / dStreaming_s / 1e6, (unsigned long long)uFramesStreaming,
+           msgIn.uFramingErrorCount, msgIn.uCrcErrorCount, msgIn.uOverrunCount);
+
+    //both decoders must find all frames
+    return ((uFramesLegacy == uFramesStreaming) && (uFramesStreaming == (uint64_t)g_uFramesInStream * uRepeat)) ? 0 : 1;
+}
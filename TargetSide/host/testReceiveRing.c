@@ -0,0 +1,218 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//----------------------------------------------------------------------------
+//    Host-run stress test of the receive ring-buffer: a producer thread (the
+//    ISR on a target) pushes encoded messages in random chunks with
+//    DebugMsgIn_AddReceivedData() as fast as it can, while a consumer thread
+//    (the main loop) decodes them with DebugMsgIn_DecodeAndCheck().
+//
+//    free-running : the producer never waits, so overruns drop bytes from the
+//                   middle of messages, which are then discarded by the CRC
+//                   (a CRC-8 lets 1 in 256 of them pass, so they are reported)
+//    flow-control : the producer waits while the consumer is behind, so no
+//                   byte may be dropped and every message must arrive
+//
+//    usage: testReceiveRing [messages]
+//----------------------------------------------------------------------------
+#include "debugMessage.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MSG_PARAM_SIZE_MAX      (40)
+#define MSG_IN_FLIGHT_MAX       (8)     //flow-control: 8 messages of at most 2*(3+4+40+1)+2 bytes fit in the buffer
+#define CHUNK_SIZE_MAX          (64)
+
+
+typedef struct STest
+{
+    SDebugMessageIn     msgIn;
+    uint32_t            uMessages;
+    bool                fFlowControl;
+    atomic_bool         fProducerDone;
+    atomic_uint         uConsumed;
+    uint32_t            uReceived;
+    uint32_t            uBad;
+} STest;
+
+
+static uint32_t ParamSize(uint32_t uSeq)
+{
+    return 4 + (uSeq % (MSG_PARAM_SIZE_MAX - 3));
+}
+
+
+static void* Producer(void* pArg)
+{
+    STest* pTest = (STest*)pArg;
+    SDebugMessageOut msgOut;
+    uint8_t rgRaw[DEBUG_MSG_RAW_SIZE];
+    uint32_t uRawSize;
+    uint32_t uPos;
+    uint32_t uChunk;
+    uint32_t uSeed = 12345;
+    uint32_t uSeq;
+    uint32_t i;
+
+    for (uSeq = 1; uSeq <= pTest->uMessages; ++uSeq)
+    {
+        //message with the sequence-nr and a pattern that depends on it
+        DebugMsgOut_Init(&msgOut);
+        msgOut.uNodeID = 1;
+        msgOut.uMsgID = (uint8_t)uSeq;
+        msgOut.cmd = cmdDebugString;
+        DebugMsgOut_AddData(&msgOut, (uint8_t*)&uSeq, 4);
+        for (i = 4; i < ParamSize(uSeq); ++i)
+        {
+            DebugMsgOut_AddByte(&msgOut, (uint8_t)(uSeq + i));
+        }
+        uRawSize = DebugMsgOut_Encode(&msgOut, rgRaw);
+
+        //flow-control: wait until the consumer has room for this message
+        while (pTest->fFlowControl && (uSeq - atomic_load(&pTest->uConsumed) > MSG_IN_FLIGHT_MAX))
+        {
+            sched_yield();
+        }
+
+        //push it in random chunks, like an UART or DMA interrupt
+        for (uPos = 0; uPos < uRawSize; uPos += uChunk)
+        {
+            uSeed = uSeed * 1103515245 + 12345;
+            uChunk = 1 + ((uSeed >> 16) % CHUNK_SIZE_MAX);
+            if (uChunk > uRawSize - uPos)
+            {
+                uChunk = uRawSize - uPos;
+            }
+            DebugMsgIn_AddReceivedData(&pTest->msgIn, &rgRaw[uPos], uChunk);
+        }
+    }
+
+    atomic_store(&pTest->fProducerDone, true);
+    return NULL;
+}
+
+
+static void* Consumer(void* pArg)
+{
+    STest* pTest = (STest*)pArg;
+    SDebugMessageIn* pMsg = &pTest->msgIn;
+    uint32_t uSeqPrev = 0;
+    uint32_t uSeq;
+    uint32_t uReceived;
+    bool fDone = false;
+    int32_t i;
+
+    while (true)
+    {
+        //check the done-flag before decoding, so everything pushed before it is decoded once more
+        fDone = atomic_load(&pTest->fProducerDone);
+        uReceived = pTest->uReceived;
+        while (DebugMsgIn_DecodeAndCheck(pMsg))
+        {
+            memcpy(&uSeq, &pMsg->rgMessage[3], 4);
+
+            //messages must be intact and in order (messages hit by an overrun are dropped as a whole)
+            if ((pMsg->cmd != cmdDebugString) || (pMsg->uMsgID != (uint8_t)uSeq) || (uSeq <= uSeqPrev) ||
+                (uSeq > pTest->uMessages) || ((uint32_t)pMsg->nCmdParamSize != ParamSize(uSeq)))
+            {
+                ++pTest->uBad;
+            }
+            else
+            {
+                for (i = 4; i < pMsg->nCmdParamSize; ++i)
+                {
+                    if (pMsg->rgMessage[3 + i] != (uint8_t)(uSeq + i))
+                    {
+                        ++pTest->uBad;
+                        break;
+                    }
+                }
+            }
+            uSeqPrev = uSeq;
+            ++pTest->uReceived;
+            atomic_store(&pTest->uConsumed, uSeq);
+        }
+        if (fDone)
+        {
+            break;
+        }
+
+        //let the producer run when there was nothing to decode (matters on a single core)
+        if (uReceived == pTest->uReceived)
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+
+static bool Run(uint32_t uMessages, bool fFlowControl)
+{
+    static STest test;
+    pthread_t threadProducer;
+    pthread_t threadConsumer;
+    bool fPassed;
+
+    memset(&test, 0, sizeof(test));
+    DebugMsgIn_Init(&test.msgIn);
+    test.uMessages = uMessages;
+    test.fFlowControl = fFlowControl;
+    atomic_init(&test.fProducerDone, false);
+    atomic_init(&test.uConsumed, 0);
+
+    pthread_create(&threadConsumer, NULL, Consumer, &test);
+    pthread_create(&threadProducer, NULL, Producer, &test);
+    pthread_join(threadProducer, NULL);
+    pthread_join(threadConsumer, NULL);
+
+    //without overruns, every message must arrive intact and in order
+    fPassed = (test.uReceived > 0);
+    if (test.msgIn.uOverrunCount == 0)
+    {
+        fPassed &= (test.uBad == 0) && (test.uReceived == uMessages);
+        fPassed &= (test.msgIn.uFramingErrorCount == 0) && (test.msgIn.uCrcErrorCount == 0);
+    }
+    if (fFlowControl)
+    {
+        fPassed &= (test.msgIn.uOverrunCount == 0);
+    }
+
+    printf("%-13s: %u of %u messages, %u bad, overrun %u bytes, framing errors %u, crc errors %u: %s\n",
+           fFlowControl ? "flow-control" : "free-running", test.uReceived, uMessages, test.uBad,
+           (uint32_t)test.msgIn.uOverrunCount, test.msgIn.uFramingErrorCount, test.msgIn.uCrcErrorCount,
+           fPassed ? "ok" : "FAILED");
+    return fPassed;
+}
+
+
+int main(int argc, char* argv[])
+{
+    uint32_t uMessages = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+    bool fPassed = true;
+
+    fPassed &= Run(uMessages, false);
+    fPassed &= Run(uMessages, true);
+
+    return fPassed ? 0 : 1;
+}
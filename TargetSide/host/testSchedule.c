@@ -0,0 +1,188 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//----------------------------------------------------------------------------
+//    Host-run test of the scheduled writes: the host sends the adds and the
+//    commit of a step back to back, without waiting for the replies. When
+//    the first add of a step that is split over two messages fails (no free
+//    write), the second add and the commit must be refused as well, so no
+//    part of the step is applied, until the host cancels the group.
+//
+//    usage: testSchedule
+//----------------------------------------------------------------------------
+#include "debugProtocol.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INPUT_SIZE_MAX          (1024)
+#define REPLY_COUNT_MAX         (256)
+
+
+typedef struct SApp
+{
+    uint32_t    uA;
+    uint32_t    uB;
+} SApp;
+
+
+static SDebugProtocol   g_debug;
+static SApp             g_app;
+static uint8_t          g_rgInput[INPUT_SIZE_MAX];
+static uint32_t         g_uInputSize;
+static uint32_t         g_uInputPos;
+static SDebugMessageIn  g_reply;
+static uint8_t          g_rgResult[REPLY_COUNT_MAX];   //result of the schedule reply per msg-ID
+static uint8_t          g_uMsgID;
+
+
+static bool GetByte(uint8_t* pData)
+{
+    if (g_uInputPos >= g_uInputSize)
+    {
+        return false;
+    }
+    *pData = g_rgInput[g_uInputPos++];
+    return true;
+}
+
+
+static void WriteData(uint8_t* pData, uint16_t uSize)
+{
+    DebugMsgIn_AddReceivedData(&g_reply, pData, uSize);
+    while (DebugMsgIn_DecodeAndCheck(&g_reply))
+    {
+        //sub-command, group, result
+        if ((g_reply.cmd == cmdSchedule) && (g_reply.nCmdParamSize >= 3))
+        {
+            g_rgResult[g_reply.uMsgID] = g_reply.rgMessage[5];
+        }
+    }
+}
+
+
+static void GetRegisterAddress(SDebugChannel* pChan)
+{
+    pChan->pSource = (uint8_t*)&g_app + pChan->_uOffset;
+}
+
+
+//queue a schedule command as the host sends it, returns its msg-ID
+static uint8_t Send(const uint8_t* rgParam, uint32_t uSize)
+{
+    SDebugMessageOut msgOut;
+
+    DebugMsgOut_Init(&msgOut);
+    msgOut.uNodeID = 1;
+    msgOut.uMsgID = ++g_uMsgID;
+    msgOut.cmd = cmdSchedule;
+    DebugMsgOut_AddData(&msgOut, rgParam, uSize);
+    g_uInputSize += DebugMsgOut_Encode(&msgOut, &g_rgInput[g_uInputSize]);
+    g_rgResult[msgOut.uMsgID] = 0xFF;
+    return msgOut.uMsgID;
+}
+
+
+static uint8_t SendAdd(uint8_t uGroup, uint32_t uOffset, uint32_t uValue)
+{
+    uint8_t rgParam[12] = { scheduleCmdAdd, uGroup };
+
+    memcpy(&rgParam[2], &uOffset, 4);
+    rgParam[6] = 0;
+    rgParam[7] = 4;
+    memcpy(&rgParam[8], &uValue, 4);
+    return Send(rgParam, sizeof(rgParam));
+}
+
+
+static uint8_t SendCommit(uint8_t uGroup, uint32_t uTime_tick)
+{
+    uint8_t rgParam[6] = { scheduleCmdCommit, uGroup };
+
+    memcpy(&rgParam[2], &uTime_tick, 4);
+    return Send(rgParam, sizeof(rgParam));
+}
+
+
+static uint8_t SendCancel(uint8_t uGroup)
+{
+    uint8_t rgParam[2] = { scheduleCmdCancel, uGroup };
+
+    return Send(rgParam, sizeof(rgParam));
+}
+
+
+static void Run(uint32_t uTicks)
+{
+    uint32_t i;
+
+    for (i = 0; i < uTicks; ++i)
+    {
+        DebugProt_DoISR(&g_debug);
+        DebugProt_DoMain(&g_debug);
+    }
+    g_uInputSize = 0;
+    g_uInputPos = 0;
+}
+
+
+static bool Check(const char* szName, bool fPassed)
+{
+    printf("%-40s: %s\n", szName, fPassed ? "ok" : "FAILED");
+    return fPassed;
+}
+
+
+int main(void)
+{
+    static const uint8_t rgVersion[4] = { 0, 0, 0, 1 };
+    uint8_t uAddA;
+    uint8_t uAddB;
+    uint8_t uCommit;
+    bool fPassed = true;
+
+    DebugMsgIn_Init(&g_reply);
+    DebugProt_Init(&g_debug, rgVersion, "testSchedule", "0", 1, GetByte, WriteData, GetRegisterAddress);
+    Run(1);
+
+    //group 1 takes both writes, so the first add of group 0 finds no free write. The cancel of group 1 frees them
+    //again before the second add, which must not refill group 0
+    SendAdd(1, offsetof(SApp, uA), 1);
+    SendAdd(1, offsetof(SApp, uB), 2);
+    uAddA = SendAdd(0, offsetof(SApp, uA), 5);
+    SendCancel(1);
+    uAddB = SendAdd(0, offsetof(SApp, uB), 6);
+    uCommit = SendCommit(0, g_debug.uTimeDebug_tick + 5);
+    Run(20);
+    fPassed &= Check("first add of the step fails", g_rgResult[uAddA] == scheduleFull);
+    fPassed &= Check("later add of the failed group is refused", g_rgResult[uAddB] == scheduleFailed);
+    fPassed &= Check("commit of the failed group is refused", g_rgResult[uCommit] == scheduleFailed);
+    fPassed &= Check("nothing of the step is applied", (g_app.uA == 0) && (g_app.uB == 0));
+    fPassed &= Check("no write is held", DebugSched_FreeCount(&g_debug._schedule) == DEBUG_SCHEDULE_COUNT);
+
+    //after the cancel, the group takes the step again
+    SendCancel(0);
+    SendAdd(0, offsetof(SApp, uA), 5);
+    uAddB = SendAdd(0, offsetof(SApp, uB), 6);
+    uCommit = SendCommit(0, g_debug.uTimeDebug_tick + 5);
+    Run(20);
+    fPassed &= Check("cancelled group accepts the step", (g_rgResult[uAddB] == scheduleOk) && (g_rgResult[uCommit] == scheduleOk));
+    fPassed &= Check("whole step is applied", (g_app.uA == 5) && (g_app.uB == 6));
+
+    return fPassed ? 0 : 1;
+}
@@ -0,0 +1,510 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//----------------------------------------------------------------------------
+//    Virtual target: runs the unmodified target side library on a Linux PC, as
+//    a load generator for the host. A timerfd drives the debug-tick at a
+//    configurable rate (far above real hardware), and the byte stream is served
+//    over TCP and, optionally, a pseudo-terminal. Each link has its own
+//    debug protocol instance, so each has its own channels and decimation.
+//    The registers are synthetic signals (sine, counters, ramps, bools) and
+//    writable parameters, addressed by their offset in SVirtualApp.
+//
+//    usage: virtualTarget [-p tcp-port] [-t] [-r tick-rate-Hz] [-d seconds] [-n node-id] [-l]
+//        -p  TCP port (default 7000, 0 = no TCP)
+//        -t  also serve a pseudo-terminal (its path is printed)
+//        -r  rate of the debug-tick (default 1000 Hz, max 1 MHz)
+//        -d  stop after this many seconds (default: run until Ctrl-C)
+//        -n  node-ID of the target (default 1)
+//        -l  print the registers as a register file for the host, and exit
+//----------------------------------------------------------------------------
+#define _GNU_SOURCE
+#include "debugProtocol.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define LINK_COUNT              (2)
+#define LINK_OUT_SIZE           (1 << 16)   //bytes buffered per link while the host doesn't read
+#define READ_CHUNK_SIZE         (4096)
+#define PI                      (3.14159265358979323846)
+
+
+typedef struct SVirtualApp
+{
+    //signals, updated every tick
+    double      dTime_s;
+    double      dSine;
+    float       fSine;
+    float       fCosine;
+    float       fRamp;                  //sawtooth 0...1 with the frequency of the sine
+    uint32_t    uCounter32;             //+1 every tick
+    uint16_t    uCounter16;
+    uint8_t     uCounter8;
+    uint8_t     uSine8;                 //128 + 100 * sine
+    bool        fSquare;                //sine > 0
+    bool        fToggle;                //toggles every tick
+    //parameters, written by the host
+    float       fFrequency_Hz;
+    float       fAmplitude;
+    uint8_t     rguScratch[16];
+} SVirtualApp;
+
+
+typedef struct SRegisterInfo
+{
+    const char* szName;
+    const char* szType;
+    uint32_t    uOffset;
+    bool        fWritable;
+} SRegisterInfo;
+
+
+typedef struct SLink
+{
+    const char*     szName;
+    int             fdListen;           //TCP: listening socket, -1 for the pty
+    int             fd;                 //connected socket or pty master, -1 when not connected
+    int             fdSlave;            //pty: kept open, so the master doesn't hang up when a client closes it
+    uint8_t         rgOut[LINK_OUT_SIZE];
+    uint32_t        uOutHead;
+    uint32_t        uOutTail;
+    uint64_t        uBytesSent;
+    uint64_t        uDroppedMessages;   //messages that didn't fit while the host was not reading
+    SDebugProtocol  debug;
+} SLink;
+
+
+static void WriteLink0(uint8_t* rgData, uint16_t uSize);
+static void WriteLink1(uint8_t* rgData, uint16_t uSize);
+
+static SVirtualApp g_app;
+static SLink g_rgLink[LINK_COUNT];
+static const funcWriteData g_rgWriteLink[LINK_COUNT] = { WriteLink0, WriteLink1 };
+static volatile sig_atomic_t g_fStop = 0;
+
+static const SRegisterInfo g_rgRegister[] =
+{
+    { "time",       "double",   offsetof(SVirtualApp, dTime_s),         false },
+    { "sine",       "double",   offsetof(SVirtualApp, dSine),           false },
+    { "sine float", "float",    offsetof(SVirtualApp, fSine),           false },
+    { "cosine",     "float",    offsetof(SVirtualApp, fCosine),         false },
+    { "ramp",       "float",    offsetof(SVirtualApp, fRamp),           false },
+    { "counter32",  "uint32_t", offsetof(SVirtualApp, uCounter32),      false },
+    { "counter16",  "uint16_t", offsetof(SVirtualApp, uCounter16),      false },
+    { "counter8",   "uint8_t",  offsetof(SVirtualApp, uCounter8),       false },
+    { "sine8",      "uint8_t",  offsetof(SVirtualApp, uSine8),          false },
+    { "square",     "bool",     offsetof(SVirtualApp, fSquare),         false },
+    { "toggle",     "bool",     offsetof(SVirtualApp, fToggle),         false },
+    { "frequency",  "float",    offsetof(SVirtualApp, fFrequency_Hz),   true },
+    { "amplitude",  "float",    offsetof(SVirtualApp, fAmplitude),      true },
+    { "scratch",    "uint8_t",  offsetof(SVirtualApp, rguScratch),      true },
+};
+
+
+static void Step(double dTick_s)
+{
+    double dPhase;
+
+    g_app.dTime_s = g_app.uCounter32 * dTick_s;
+    dPhase = 2 * PI * g_app.fFrequency_Hz * g_app.dTime_s;
+    g_app.dSine = g_app.fAmplitude * sin(dPhase);
+    g_app.fSine = (float)g_app.dSine;
+    g_app.fCosine = (float)(g_app.fAmplitude * cos(dPhase));
+    g_app.fRamp = (float)(dPhase / (2 * PI) - floor(dPhase / (2 * PI)));
+    g_app.uSine8 = (uint8_t)(128 + 100 * sin(dPhase));
+    g_app.fSquare = (g_app.dSine > 0);
+    g_app.fToggle = !g_app.fToggle;
+    ++g_app.uCounter32;
+    g_app.uCounter16 = (uint16_t)g_app.uCounter32;
+    g_app.uCounter8 = (uint8_t)g_app.uCounter32;
+}
+
+
+static void GetRegisterAddress(SDebugChannel* pChan)
+{
+    //registers are addressed by their offset in the application, anything outside of it has no address
+    if (pChan->_uOffset + pChan->uSize_bytes <= sizeof(SVirtualApp))
+    {
+        pChan->pSource = (uint8_t*)&g_app + pChan->_uOffset;
+    }
+    else
+    {
+        pChan->pSource = NULL;
+    }
+}
+
+
+static void WriteLink(SLink* pLink, uint8_t* rgData, uint16_t uSize)
+{
+    uint32_t uPos;
+    uint32_t i;
+
+    //a message is buffered completely or dropped as a whole, so the host only sees complete frames
+    if (pLink->fd < 0)
+    {
+        return;
+    }
+    if (LINK_OUT_SIZE - (pLink->uOutHead - pLink->uOutTail) < uSize)
+    {
+        ++pLink->uDroppedMessages;
+        return;
+    }
+    for (i = 0; i < uSize; ++i)
+    {
+        uPos = (pLink->uOutHead + i) & (LINK_OUT_SIZE - 1);
+        pLink->rgOut[uPos] = rgData[i];
+    }
+    pLink->uOutHead += uSize;
+}
+
+
+static void WriteLink0(uint8_t* rgData, uint16_t uSize)
+{
+    WriteLink(&g_rgLink[0], rgData, uSize);
+}
+
+
+static void WriteLink1(uint8_t* rgData, uint16_t uSize)
+{
+    WriteLink(&g_rgLink[1], rgData, uSize);
+}
+
+
+static void Disconnect(SLink* pLink)
+{
+    printf("%s: disconnected\n", pLink->szName);
+    close(pLink->fd);
+    pLink->fd = -1;
+    pLink->uOutTail = pLink->uOutHead;
+}
+
+
+static void FlushLink(SLink* pLink)
+{
+    uint32_t uPos;
+    uint32_t uSize;
+    ssize_t nWritten;
+
+    //write until the socket or pty is full, the rest is written when poll() reports it writable
+    while ((pLink->fd >= 0) && (pLink->uOutHead != pLink->uOutTail))
+    {
+        uPos = pLink->uOutTail & (LINK_OUT_SIZE - 1);
+        uSize = pLink->uOutHead - pLink->uOutTail;
+        if (uSize > LINK_OUT_SIZE - uPos)
+        {
+            uSize = LINK_OUT_SIZE - uPos;
+        }
+        nWritten = write(pLink->fd, &pLink->rgOut[uPos], uSize);
+        if (nWritten > 0)
+        {
+            pLink->uOutTail += (uint32_t)nWritten;
+            pLink->uBytesSent += (uint64_t)nWritten;
+        }
+        else
+        {
+            if ((nWritten < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+            {
+                Disconnect(pLink);
+            }
+            break;
+        }
+    }
+}
+
+
+static void ReadLink(SLink* pLink)
+{
+    uint8_t rgData[READ_CHUNK_SIZE];
+    ssize_t nRead;
+
+    //hand the received chunk to the receive buffer, like a DMA or idle-line interrupt
+    nRead = read(pLink->fd, rgData, sizeof(rgData));
+    if (nRead > 0)
+    {
+        DebugProt_AddReceivedData(&pLink->debug, rgData, (uint32_t)nRead);
+    }
+    else if ((nRead == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+    {
+        Disconnect(pLink);
+    }
+}
+
+
+static void AcceptLink(SLink* pLink)
+{
+    int fd;
+    int nOption = 1;
+
+    //a new host replaces the previous one
+    fd = accept(pLink->fdListen, NULL, NULL);
+    if (fd < 0)
+    {
+        return;
+    }
+    if (pLink->fd >= 0)
+    {
+        Disconnect(pLink);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nOption, sizeof(nOption));
+    pLink->fd = fd;
+    printf("%s: connected\n", pLink->szName);
+}
+
+
+static bool OpenTcp(SLink* pLink, uint16_t uPort)
+{
+    struct sockaddr_in addr;
+    int nOption = 1;
+
+    pLink->fdListen = socket(AF_INET, SOCK_STREAM, 0);
+    if (pLink->fdListen < 0)
+    {
+        return false;
+    }
+    setsockopt(pLink->fdListen, SOL_SOCKET, SO_REUSEADDR, &nOption, sizeof(nOption));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(uPort);
+    if ((bind(pLink->fdListen, (struct sockaddr*)&addr, sizeof(addr)) < 0) || (listen(pLink->fdListen, 1) < 0))
+    {
+        close(pLink->fdListen);
+        pLink->fdListen = -1;
+        return false;
+    }
+    printf("%s: listening on port %u\n", pLink->szName, uPort);
+    return true;
+}
+
+
+static bool OpenPty(SLink* pLink)
+{
+    struct termios tio;
+    const char* szSlave;
+
+    pLink->fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((pLink->fd < 0) || (grantpt(pLink->fd) < 0) || (unlockpt(pLink->fd) < 0) || ((szSlave = ptsname(pLink->fd)) == NULL))
+    {
+        return false;
+    }
+
+    //raw bytes, no echo or line editing
+    pLink->fdSlave = open(szSlave, O_RDWR | O_NOCTTY);
+    if ((pLink->fdSlave < 0) || (tcgetattr(pLink->fdSlave, &tio) < 0))
+    {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(pLink->fdSlave, TCSANOW, &tio);
+    printf("%s: %s\n", pLink->szName, szSlave);
+    return true;
+}
+
+
+static void PrintRegisters(void)
+{
+    uint32_t i;
+
+    printf("{\n  \"Registers\": [\n");
+    for (i = 0; i < sizeof(g_rgRegister) / sizeof(g_rgRegister[0]); ++i)
+    {
+        printf("    {\"id\": %u, \"name\": \"%s\", \"ReadWrite\": \"%s\", \"Type\": \"%s\", \"Source\": \"HandWrittenOffset\", "
+               "\"DerefDepth\": 0, \"Offset\": %u}%s\n", i + 1, g_rgRegister[i].szName,
+               g_rgRegister[i].fWritable ? "ReadWrite" : "Read", g_rgRegister[i].szType, g_rgRegister[i].uOffset,
+               (i + 1 < sizeof(g_rgRegister) / sizeof(g_rgRegister[0])) ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+
+static void OnSignal(int nSignal)
+{
+    (void)nSignal;
+    g_fStop = 1;
+}
+
+
+int main(int argc, char* argv[])
+{
+    static const uint8_t rgVersionApp[4] = {1, 0, 0, 0};
+    struct pollfd rgPoll[1 + 2 * LINK_COUNT];
+    SLink* rgPollLink[1 + 2 * LINK_COUNT];
+    struct itimerspec timerSpec;
+    uint32_t uPort = 7000;
+    uint32_t uRate_Hz = 1000;
+    uint32_t uNodeID = 1;
+    uint32_t uDuration_s = 0;
+    bool fPty = false;
+    uint64_t uExpirations;
+    uint64_t uTicks = 0;
+    uint64_t uLateTicks = 0;
+    uint32_t uPollCount;
+    int fdTimer;
+    int nOption;
+    uint32_t i;
+    uint32_t j;
+
+    //the pty path and connects are printed while running, also when the output is redirected
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    while ((nOption = getopt(argc, argv, "p:tr:d:n:l")) != -1)
+    {
+        switch (nOption)
+        {
+            case 'p':   uPort = (uint32_t)atoi(optarg);         break;
+            case 't':   fPty = true;                            break;
+            case 'r':   uRate_Hz = (uint32_t)atoi(optarg);      break;
+            case 'd':   uDuration_s = (uint32_t)atoi(optarg);   break;
+            case 'n':   uNodeID = (uint32_t)atoi(optarg);       break;
+            case 'l':   PrintRegisters();                       return 0;
+            default:
+                fprintf(stderr, "usage: %s [-p tcp-port] [-t] [-r tick-rate-Hz] [-d seconds] [-n node-id] [-l]\n", argv[0]);
+                return 1;
+        }
+    }
+    if ((uRate_Hz == 0) || (uRate_Hz > 1000000) || (uPort > 0xFFFF) || ((uPort == 0) && !fPty))
+    {
+        fprintf(stderr, "invalid rate or port, or no link\n");
+        return 1;
+    }
+
+    //the application: a 1 Hz sine of amplitude 1
+    memset(&g_app, 0, sizeof(g_app));
+    g_app.fFrequency_Hz = 1.0f;
+    g_app.fAmplitude = 1.0f;
+
+    //a debug protocol instance per link, with a tick-period that matches the timer
+    for (i = 0; i < LINK_COUNT; ++i)
+    {
+        g_rgLink[i].szName = (i == 0) ? "tcp" : "pty";
+        g_rgLink[i].fdListen = -1;
+        g_rgLink[i].fd = -1;
+        g_rgLink[i].fdSlave = -1;
+        DebugProt_Init(&g_rgLink[i].debug, rgVersionApp, "VirtualTarget", g_rgLink[i].szName, uNodeID, NULL,
+                       g_rgWriteLink[i], GetRegisterAddress);
+        DebugProt_SetTickPeriod(&g_rgLink[i].debug, 1000000 / uRate_Hz);
+    }
+    if ((uPort > 0) && !OpenTcp(&g_rgLink[0], (uint16_t)uPort))
+    {
+        fprintf(stderr, "can't listen on port %u: %s\n", uPort, strerror(errno));
+        return 1;
+    }
+    if (fPty && !OpenPty(&g_rgLink[1]))
+    {
+        fprintf(stderr, "can't open a pseudo-terminal: %s\n", strerror(errno));
+        return 1;
+    }
+
+    //the timer is the tick-interrupt
+    fdTimer = timerfd_create(CLOCK_MONOTONIC, 0);
+    timerSpec.it_interval.tv_sec = 0;
+    timerSpec.it_interval.tv_nsec = 1000000000L / uRate_Hz;
+    timerSpec.it_value = timerSpec.it_interval;
+    if ((fdTimer < 0) || (timerfd_settime(fdTimer, 0, &timerSpec, NULL) < 0))
+    {
+        fprintf(stderr, "can't start the timer: %s\n", strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    while (!g_fStop && ((uDuration_s == 0) || (uTicks < (uint64_t)uDuration_s * uRate_Hz)))
+    {
+        //wait for the timer, a new host, received bytes or room to write
+        rgPoll[0].fd = fdTimer;
+        rgPoll[0].events = POLLIN;
+        uPollCount = 1;
+        for (i = 0; i < LINK_COUNT; ++i)
+        {
+            if (g_rgLink[i].fdListen >= 0)
+            {
+                rgPoll[uPollCount].fd = g_rgLink[i].fdListen;
+                rgPoll[uPollCount].events = POLLIN;
+                rgPollLink[uPollCount++] = &g_rgLink[i];
+            }
+            if (g_rgLink[i].fd >= 0)
+            {
+                rgPoll[uPollCount].fd = g_rgLink[i].fd;
+                rgPoll[uPollCount].events = POLLIN | ((g_rgLink[i].uOutHead != g_rgLink[i].uOutTail) ? POLLOUT : 0);
+                rgPollLink[uPollCount++] = &g_rgLink[i];
+            }
+        }
+        if (poll(rgPoll, uPollCount, -1) < 0)
+        {
+            continue;
+        }
+
+        //run a tick for every timer expiration, a late tick is caught up (and counted)
+        if ((rgPoll[0].revents & POLLIN) && (read(fdTimer, &uExpirations, sizeof(uExpirations)) == sizeof(uExpirations)))
+        {
+            uLateTicks += uExpirations - 1;
+            for (; uExpirations > 0; --uExpirations)
+            {
+                Step(1.0 / uRate_Hz);
+                for (i = 0; i < LINK_COUNT; ++i)
+                {
+                    DebugProt_Tick(&g_rgLink[i].debug);
+                    DebugProt_DoMain(&g_rgLink[i].debug);
+                }
+                ++uTicks;
+            }
+        }
+
+        for (j = 1; j < uPollCount; ++j)
+        {
+            if (rgPoll[j].fd == rgPollLink[j]->fdListen)
+            {
+                if (rgPoll[j].revents & POLLIN)
+                {
+                    AcceptLink(rgPollLink[j]);
+                }
+            }
+            else if ((rgPoll[j].fd == rgPollLink[j]->fd) && (rgPoll[j].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+                ReadLink(rgPollLink[j]);
+            }
+        }
+        for (i = 0; i < LINK_COUNT; ++i)
+        {
+            FlushLink(&g_rgLink[i]);
+        }
+    }
+
+    printf("%llu ticks at %u Hz, %llu late\n", (unsigned long long)uTicks, uRate_Hz, (unsigned long long)uLateTicks);
+    for (i = 0; i < LINK_COUNT; ++i)
+    {
+        printf("%s: %llu bytes sent, %llu messages dropped\n", g_rgLink[i].szName,
+               (unsigned long long)g_rgLink[i].uBytesSent, (unsigned long long)g_rgLink[i].uDroppedMessages);
+    }
+    return 0;
+}
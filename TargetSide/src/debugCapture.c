@@ -0,0 +1,335 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "debugCapture.h"
+#include <string.h>             //for using memset and memcpy
+
+#if DEBUG_CAPTURE_SIZE > 0
+
+//local function prototypes
+static bool Setup(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation);
+static uint64_t TriggerKey(const uint8_t* pValue, uint8_t uSize, ETriggerFormat format);
+static bool TriggerHit(SDebugCapture* pCapt, const uint8_t* pRecord);
+
+
+void DebugCapt_Init(SDebugCapture* pCapt)
+{
+    memset(pCapt, 0, sizeof(SDebugCapture));
+    pCapt->state = captureIdle;
+}
+
+
+bool DebugCapt_Start(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation)
+{
+    //record until stopped
+    if (!Setup(pCapt, rgChannel, uDecimation))
+    {
+        return false;
+    }
+    pCapt->state = captureRunning;
+
+    return true;
+}
+
+
+bool DebugCapt_Arm(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation, const SDebugTrigger* pTrigger)
+{
+    SDebugChannel* pChan;
+    uint32_t uOffset;
+    uint32_t i;
+
+    if (!Setup(pCapt, rgChannel, uDecimation))
+    {
+        return false;
+    }
+
+    //check the trigger: a valid channel (with 256 channels every channel-nr is valid), and pre- and post-trigger records must fit in the buffer
+#if DEBUG_CHANNEL_COUNT < 256
+    if (pTrigger->uChannel >= DEBUG_CHANNEL_COUNT)
+    {
+        return false;
+    }
+#endif
+    if ((pTrigger->uPostCount == 0) ||
+        (pTrigger->uPostCount > pCapt->uRecordMax) || (pTrigger->uPreCount > pCapt->uRecordMax - pTrigger->uPostCount))
+    {
+        return false;
+    }
+    pChan = &rgChannel[pTrigger->uChannel];
+    if ((pChan->uSize_bytes != 1) && (pChan->uSize_bytes != 2) && (pChan->uSize_bytes != 4) && (pChan->uSize_bytes != 8))
+    {
+        return false;
+    }
+
+    //the trigger is evaluated on its value in the record, so the trigger channel must be captured
+    uOffset = 4;
+    for (i = 0; (i < pCapt->_uChannelCount) && (pCapt->_rgChannel[i] != pTrigger->uChannel); ++i)
+    {
+        uOffset += rgChannel[pCapt->_rgChannel[i]].uSize_bytes;
+    }
+    if (i == pCapt->_uChannelCount)
+    {
+        return false;
+    }
+    pCapt->_uTriggerOffset = uOffset;
+    pCapt->_uTriggerSize = pChan->uSize_bytes;
+
+    //convert the level once, so the evaluation is a plain integer compare
+    pCapt->trigger = *pTrigger;
+    pCapt->_uTriggerLevel = TriggerKey(pTrigger->rgLevel, pChan->uSize_bytes, pTrigger->format);
+    pCapt->_fTriggerPrevValid = false;
+    pCapt->state = captureArmed;
+
+    return true;
+}
+
+
+void DebugCapt_Disarm(SDebugCapture* pCapt)
+{
+    //discard a capture that is waiting for (or completing) its trigger
+    if ((pCapt->state == captureArmed) || (pCapt->state == captureTriggered))
+    {
+        pCapt->state = captureIdle;
+    }
+}
+
+
+bool Setup(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation)
+{
+    int32_t i;
+
+    //stop sampling while the administration is changed
+    pCapt->state = captureIdle;
+
+    //capture all active channels, in the same order as ReadChannelData
+    memset(pCapt->rgMask, 0, DEBUG_CHANNEL_MASK_SIZE);
+    pCapt->_uChannelCount = 0;
+    pCapt->uRecordSize = 4;
+    for (i = DEBUG_CHANNEL_COUNT - 1; i >= 0; --i)
+    {
+        if ((rgChannel[i].updateMode != updateOff) && (rgChannel[i].uSize_bytes <= 8))
+        {
+            pCapt->_rgChannel[pCapt->_uChannelCount++] = (uint8_t)i;
+            pCapt->rgMask[i >> 3] |= (uint8_t)(0x01 << (i & 0x07));
+            pCapt->uRecordSize += rgChannel[i].uSize_bytes;
+        }
+    }
+
+    //check if at least 1 record fits
+    pCapt->uRecordMax = DEBUG_CAPTURE_SIZE / pCapt->uRecordSize;
+    if ((pCapt->_uChannelCount == 0) || (pCapt->uRecordMax == 0))
+    {
+        return false;
+    }
+
+    //start with an empty buffer
+    pCapt->uRecordCount = 0;
+    pCapt->_uIndexPush = 0;
+    pCapt->uDecimation = (uDecimation > 0) ? uDecimation : 1;
+    pCapt->_uDecimationCount = 0;
+    pCapt->uTriggerIndex = DEBUG_CAPTURE_NO_TRIGGER;
+
+    return true;
+}
+
+
+void DebugCapt_Stop(SDebugCapture* pCapt)
+{
+    //a triggered capture that is stopped early has less post-trigger records
+    if (pCapt->state == captureTriggered)
+    {
+        pCapt->uTriggerIndex = pCapt->uRecordCount - (pCapt->trigger.uPostCount - pCapt->_uPostRemaining);
+    }
+
+    //freeze the records for uploading (also forces an armed or triggered capture to complete)
+    if ((pCapt->state == captureRunning) || (pCapt->state == captureArmed) || (pCapt->state == captureTriggered))
+    {
+        pCapt->state = captureDone;
+    }
+}
+
+
+void DebugCapt_Sample(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uTime_tick)
+{
+    uint8_t* pRecordStart;
+    uint8_t* pRecord;
+    SDebugChannel* pChan;
+    uint32_t i;
+
+    //only record when running, every uDecimation ticks
+    if ((pCapt->state != captureRunning) && (pCapt->state != captureArmed) && (pCapt->state != captureTriggered))
+    {
+        return;
+    }
+    if (++pCapt->_uDecimationCount < pCapt->uDecimation)
+    {
+        return;
+    }
+    pCapt->_uDecimationCount = 0;
+
+    //store the tick (LSB first) and the values
+    pRecordStart = &pCapt->_rgData[pCapt->_uIndexPush * pCapt->uRecordSize];
+    pRecord = pRecordStart;
+    *pRecord++ = (uTime_tick >>  0) & 0xFF;
+    *pRecord++ = (uTime_tick >>  8) & 0xFF;
+    *pRecord++ = (uTime_tick >> 16) & 0xFF;
+    *pRecord++ = (uTime_tick >> 24) & 0xFF;
+    for (i = 0; i < pCapt->_uChannelCount; ++i)
+    {
+        pChan = &rgChannel[pCapt->_rgChannel[i]];
+        if (!DbgChan_PeekValue(pChan, pRecord))
+        {
+            memset(pRecord, 0, pChan->uSize_bytes);
+        }
+        pRecord += pChan->uSize_bytes;
+    }
+
+    //advance, overwriting the oldest record when the buffer is full
+    pCapt->_uIndexPush = (pCapt->_uIndexPush + 1) % pCapt->uRecordMax;
+    if (pCapt->uRecordCount < pCapt->uRecordMax)
+    {
+        ++pCapt->uRecordCount;
+    }
+
+    //check the trigger on the recorded tick, the trigger record is the first post-trigger record
+    if ((pCapt->state == captureArmed) && TriggerHit(pCapt, pRecordStart))
+    {
+        pCapt->_uPostRemaining = pCapt->trigger.uPostCount;
+        pCapt->state = captureTriggered;
+    }
+    if (pCapt->state == captureTriggered)
+    {
+        if (--pCapt->_uPostRemaining == 0)
+        {
+            //keep only the pre- and post-trigger records
+            if (pCapt->uRecordCount > pCapt->trigger.uPreCount + pCapt->trigger.uPostCount)
+            {
+                pCapt->uRecordCount = pCapt->trigger.uPreCount + pCapt->trigger.uPostCount;
+            }
+            pCapt->uTriggerIndex = pCapt->uRecordCount - pCapt->trigger.uPostCount;
+            pCapt->state = captureDone;
+        }
+    }
+}
+
+
+uint32_t DebugCapt_Read(SDebugCapture* pCapt, uint32_t uOffset, uint8_t* rgData, uint32_t uSize)
+{
+    uint32_t uTotal;
+    uint32_t uStart;
+    uint32_t uIndex;
+    uint32_t uChunk;
+    uint32_t uRead;
+
+    //only a stopped capture can be read, as a byte-stream of records with the oldest record first
+    if (pCapt->state != captureDone)
+    {
+        return 0;
+    }
+    uTotal = pCapt->uRecordCount * pCapt->uRecordSize;
+    if (uOffset >= uTotal)
+    {
+        return 0;
+    }
+    if (uSize > uTotal - uOffset)
+    {
+        uSize = uTotal - uOffset;
+    }
+
+    //copy in at most 2 parts, because of the wrap-around of the ring-buffer
+    uStart = ((pCapt->_uIndexPush + pCapt->uRecordMax - pCapt->uRecordCount) % pCapt->uRecordMax) * pCapt->uRecordSize;
+    uIndex = (uStart + uOffset) % (pCapt->uRecordMax * pCapt->uRecordSize);
+    uRead = 0;
+    while (uRead < uSize)
+    {
+        uChunk = pCapt->uRecordMax * pCapt->uRecordSize - uIndex;
+        if (uChunk > uSize - uRead)
+        {
+            uChunk = uSize - uRead;
+        }
+        memcpy(&rgData[uRead], &pCapt->_rgData[uIndex], uChunk);
+        uRead += uChunk;
+        uIndex = 0;
+    }
+
+    return uRead;
+}
+
+
+bool TriggerHit(SDebugCapture* pCapt, const uint8_t* pRecord)
+{
+    uint64_t uValue;
+    uint64_t uPrev;
+    bool fPrevValid;
+
+    //the value of the trigger channel as it was stored in the record (a second read may differ)
+    uValue = TriggerKey(&pRecord[pCapt->_uTriggerOffset], pCapt->_uTriggerSize, pCapt->trigger.format);
+    uPrev = pCapt->_uTriggerPrev;
+    fPrevValid = pCapt->_fTriggerPrevValid;
+    pCapt->_uTriggerPrev = uValue;
+    pCapt->_fTriggerPrevValid = true;
+
+    switch (pCapt->trigger.mode)
+    {
+        case triggerRising:     return fPrevValid && (uPrev < pCapt->_uTriggerLevel) && (uValue >= pCapt->_uTriggerLevel);
+        case triggerFalling:    return fPrevValid && (uPrev >= pCapt->_uTriggerLevel) && (uValue < pCapt->_uTriggerLevel);
+        case triggerAbove:      return (uValue > pCapt->_uTriggerLevel);
+        case triggerBelow:      return (uValue < pCapt->_uTriggerLevel);
+        case triggerChange:     return fPrevValid && (uValue != uPrev);
+        default:                return false;
+    }
+}
+
+
+uint64_t TriggerKey(const uint8_t* pValue, uint8_t uSize, ETriggerFormat format)
+{
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t uValue;
+    uint64_t uSignBit;
+
+    //read the value in its native size
+    switch (uSize)
+    {
+        case 1:     memcpy(&u8, pValue, 1);     uValue = u8;    break;
+        case 2:     memcpy(&u16, pValue, 2);    uValue = u16;   break;
+        case 4:     memcpy(&u32, pValue, 4);    uValue = u32;   break;
+        default:    memcpy(&uValue, pValue, 8);                 break;
+    }
+    uSignBit = (uSize < 8) ? ((uint64_t)1 << (8 * uSize - 1)) : ((uint64_t)1 << 63);
+
+    //map to an unsigned key with the same ordering: signed values get their sign bit flipped,
+    //negative floats all their bits (the magnitude counts down), positive floats their sign bit
+    switch (format)
+    {
+        case triggerSigned:
+            return uValue ^ uSignBit;
+
+        case triggerFloat:
+            if (uValue & uSignBit)
+            {
+                return ~uValue & (uSignBit | (uSignBit - 1));
+            }
+            return uValue | uSignBit;
+
+        default:
+            return uValue;
+    }
+}
+
+#endif //DEBUG_CAPTURE_SIZE > 0
@@ -0,0 +1,127 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGCAPTURE_H
+#define DEBUGCAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugChannel.h"
+
+//size in bytes of the on-target capture buffer (oscilloscope mode), 0 = no capture support. Every (decimated) tick
+//a record with the 32-bit tick and the values of all active channels is stored, the host uploads it afterwards
+#ifndef DEBUG_CAPTURE_SIZE
+    #define DEBUG_CAPTURE_SIZE      (0)
+#endif
+
+
+typedef enum ECaptureState
+{
+    captureIdle         = 0x00,     //no capture available
+    captureRunning      = 0x01,     //recording, the oldest records are overwritten when the buffer is full
+    captureDone         = 0x02,     //stopped, the records can be uploaded
+    captureArmed        = 0x03,     //recording pre-trigger records, waiting for the trigger
+    captureTriggered    = 0x04      //triggered, recording post-trigger records
+} ECaptureState;
+
+
+typedef enum ECaptureCmd
+{
+    captureCmdStatus    = 0x00,     //reply: state, record-size, record-count, channel-mask
+    captureCmdStart     = 0x01,     //param: [decimation (2 bytes)], reply: result
+    captureCmdStop      = 0x02,     //reply: state
+    captureCmdRead      = 0x03,     //param: byte-offset (4 bytes), reply: byte-offset, data
+    captureCmdArm       = 0x04,     //param: trigger (see CmdCapture), reply: result
+    captureCmdDisarm    = 0x05      //reply: state
+} ECaptureCmd;
+
+
+typedef enum ETriggerMode
+{
+    triggerRising       = 0x00,     //previous value below the level, value at or above the level
+    triggerFalling      = 0x01,     //previous value at or above the level, value below the level
+    triggerAbove        = 0x02,     //value above the level
+    triggerBelow        = 0x03,     //value below the level
+    triggerChange       = 0x04      //value differs from the previous value
+} ETriggerMode;
+
+
+typedef enum ETriggerFormat
+{
+    triggerUnsigned     = 0x00,
+    triggerSigned       = 0x01,
+    triggerFloat        = 0x02      //float (4 bytes) or double (8 bytes)
+} ETriggerFormat;
+
+
+typedef struct SDebugTrigger
+{
+    uint8_t                 uChannel;
+    ETriggerMode            mode;
+    ETriggerFormat          format;
+    uint8_t                 rgLevel[8];                         //level, in the format and size of the channel
+    uint32_t                uPreCount;                          //nbr of records before the trigger
+    uint32_t                uPostCount;                         //nbr of records from the trigger on (at least 1)
+} SDebugTrigger;
+
+
+#if DEBUG_CAPTURE_SIZE > 0
+
+#define DEBUG_CAPTURE_NO_TRIGGER    (0xFFFFFFFF)
+
+typedef struct SDebugCapture
+{
+    uint8_t                 _rgData[DEBUG_CAPTURE_SIZE];
+    uint8_t                 _rgChannel[DEBUG_CHANNEL_COUNT];    //captured channels, highest channel first
+    uint32_t                _uChannelCount;
+    uint8_t                 rgMask[DEBUG_CHANNEL_MASK_SIZE];    //captured channels, as in ReadChannelData
+    volatile ECaptureState  state;
+    uint32_t                uRecordSize;                        //tick + values, in bytes
+    uint32_t                uRecordMax;                         //nbr of records that fit in the buffer
+    volatile uint32_t       uRecordCount;                       //nbr of valid records
+    volatile uint32_t       _uIndexPush;                        //next record to write
+    uint32_t                uDecimation;
+    uint32_t                _uDecimationCount;
+    SDebugTrigger           trigger;
+    uint64_t                _uTriggerLevel;                     //level and previous value as order-preserving keys
+    uint64_t                _uTriggerPrev;
+    uint32_t                _uTriggerOffset;                    //position of the trigger value in a record
+    uint8_t                 _uTriggerSize;
+    bool                    _fTriggerPrevValid;
+    uint32_t                _uPostRemaining;
+    uint32_t                uTriggerIndex;                      //record of the trigger, or DEBUG_CAPTURE_NO_TRIGGER
+} SDebugCapture;
+
+
+void DebugCapt_Init(SDebugCapture* pCapt);
+bool DebugCapt_Start(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation);
+bool DebugCapt_Arm(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uDecimation, const SDebugTrigger* pTrigger);
+void DebugCapt_Disarm(SDebugCapture* pCapt);
+void DebugCapt_Stop(SDebugCapture* pCapt);
+void DebugCapt_Sample(SDebugCapture* pCapt, SDebugChannel* rgChannel, uint32_t uTime_tick);
+uint32_t DebugCapt_Read(SDebugCapture* pCapt, uint32_t uOffset, uint8_t* rgData, uint32_t uSize);
+
+#endif //DEBUG_CAPTURE_SIZE > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGCAPTURE_H
@@ -1,97 +1,520 @@
-/*
-Embedded Debugger system side which can be used to debug embedded systems at a high level.
-Copyright (C) 2019 DEMCON advanced mechatronics B.V.
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <http://www.gnu.org/licenses/>.
-*/
-#include "debugChannel.h"
-#include <string.h>             //for using memset and memcmp
-
-
-void DbgChan_Init(SDebugChannel* pChan)
-{
-    memset(pChan, 0, sizeof(SDebugChannel));
-}
-
-
-void DbgChan_WriteValue(SDebugChannel* pChan, uint8_t* pValueNew)
-{
-    int32_t i;
-    void* pValue;
-
-    //check if we have a valid source
-    pValue = pChan->pSource;
-    if (pValue == NULL)
-    {
-        return;
-    }
-
-    //dereference the proper number of times
-    for (i = 0; i < pChan->uPointerDepth; ++i)
-    {
-        //trap null-pounters
-        if (pValue == NULL)
-        {
-            return;
-        }
-
-        //dereference 1 level
-        pValue = *((void**)pValue);
-    }
-
-    //write (copy) the actual data
-    memcpy(pChan->pSource, pValueNew, pChan->uSize_bytes);
-}
-
-
-bool DbgChan_ReadValue(SDebugChannel* pChan, uint8_t* pValueRead)
-{
-    int32_t i;
-    void* pValue;
-    bool fValueChanged;
-
-    //check if we have a valid source
-    pValue = pChan->pSource;
-    if (pValue == NULL)
-    {
-        return false;
-    }
-
-    //dereference the proper number of times
-    for (i = 0; i < pChan->uPointerDepth; ++i)
-    {
-        //trap null-pounters
-        if (pValue == NULL)
-        {
-            return false;
-        }
-
-        //dereference 1 level
-        pValue = *((void**)pValue);
-    }
-
-    //always read (copy) the actual data
-    memcpy(pValueRead, pValue, pChan->uSize_bytes);
-
-    //check if the value has changed by comparing memory
-    fValueChanged = (memcmp(pValue, pChan->rgValuePrev, pChan->uSize_bytes) != 0) ? true : false;
-    if (fValueChanged)
-    {
-        //remember the new value for next time
-        memcpy(pChan->rgValuePrev, pValue, pChan->uSize_bytes);
-    }
-
-    //return true if we have a new value
-    return fValueChanged;
-}
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "debugChannel.h"
+#include <string.h>             //for using memset and memcmp
+
+//local function prototypes
+static void* GetValueAddress(SDebugChannel* pChan);
+static bool ReadValueAny(SDebugChannel* pChan, uint8_t* pValueRead);
+static bool ReadValue8(SDebugChannel* pChan, uint8_t* pValueRead);
+static bool ReadValue16(SDebugChannel* pChan, uint8_t* pValueRead);
+static bool ReadValue32(SDebugChannel* pChan, uint8_t* pValueRead);
+static bool ReadValue64(SDebugChannel* pChan, uint8_t* pValueRead);
+#if (DEBUG_CHANNEL_COMPACT > 0) || (DEBUG_CHANNEL_AGGREGATE > 0)
+static uint64_t LoadValue(const uint8_t* pValue, uint8_t uSize_bytes);
+#endif
+#if DEBUG_CHANNEL_AGGREGATE > 0
+static EChannelFormat NumberFormat(const SDebugChannel* pChan);
+static UDebugNumber ToNumber(const SDebugChannel* pChan, EChannelFormat format, const uint8_t* pValue);
+static void FromNumber(const SDebugChannel* pChan, EChannelFormat format, UDebugNumber number, uint8_t* pValue);
+#endif
+
+
+void DbgChan_Init(SDebugChannel* pChan)
+{
+    memset(pChan, 0, sizeof(SDebugChannel));
+    pChan->fResolveOnce = (DEBUG_CHANNEL_RESOLVE_ONCE > 0);
+}
+
+
+void DbgChan_Resolve(SDebugChannel* pChan)
+{
+    void* pValue;
+
+    //resolve the address once: always without dereferences, and for pointer-chains with the resolve-once policy
+    pChan->_pValue = NULL;
+    pChan->_pReadValue = ReadValueAny;
+    if ((pChan->uPointerDepth > 0) && !pChan->fResolveOnce)
+    {
+        return;
+    }
+    pValue = GetValueAddress(pChan);
+    pChan->_pValue = pValue;
+    if (pValue == NULL)
+    {
+        return;
+    }
+
+    //select a single load and compare for values that are properly aligned
+    if (((uintptr_t)pValue & (pChan->uSize_bytes - 1)) == 0)
+    {
+        switch (pChan->uSize_bytes)
+        {
+            case 1:     pChan->_pReadValue = ReadValue8;    break;
+            case 2:     pChan->_pReadValue = ReadValue16;   break;
+            case 4:     pChan->_pReadValue = ReadValue32;   break;
+            case 8:     pChan->_pReadValue = ReadValue64;   break;
+            default:                                        break;
+        }
+    }
+}
+
+
+void DbgChan_WriteValue(SDebugChannel* pChan, uint8_t* pValueNew)
+{
+    void* pValue;
+
+    //get the address of the actual data
+    pValue = (pChan->_pValue != NULL) ? pChan->_pValue : GetValueAddress(pChan);
+    if (pValue == NULL)
+    {
+        return;
+    }
+
+    //write (copy) the actual data
+    memcpy(pValue, pValueNew, pChan->uSize_bytes);
+}
+
+
+bool DbgChan_ReadValue(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    //sample with the routine that is selected by DbgChan_Resolve(), channels that are not resolved read any size
+    if (pChan->_pReadValue != NULL)
+    {
+        return pChan->_pReadValue(pChan, pValueRead);
+    }
+    return ReadValueAny(pChan, pValueRead);
+}
+
+
+bool DbgChan_PeekValue(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    void* pValue;
+
+    //get the address of the actual data
+    pValue = DbgChan_GetAddress(pChan);
+    if (pValue == NULL)
+    {
+        return false;
+    }
+
+    //read (copy) the actual data, without touching the change-detection
+    memcpy(pValueRead, pValue, pChan->uSize_bytes);
+    return true;
+}
+
+
+void* DbgChan_GetAddress(SDebugChannel* pChan)
+{
+    //the resolved address, or walk the pointer-chain (NULL when it can't be resolved)
+    return (pChan->_pValue != NULL) ? pChan->_pValue : GetValueAddress(pChan);
+}
+
+
+bool DbgChan_ReadSample(SDebugChannel* pChan, const uint8_t* pSample, uint8_t* pValueRead)
+{
+    bool fValueChanged;
+
+    //a value that was sampled before (with DbgChan_PeekValue), with the change-detection of DbgChan_ReadValue
+    memcpy(pValueRead, pSample, pChan->uSize_bytes);
+    fValueChanged = (memcmp(pSample, pChan->valuePrev.rgByte, pChan->uSize_bytes) != 0) ? true : false;
+    if (fValueChanged)
+    {
+        memcpy(pChan->valuePrev.rgByte, pSample, pChan->uSize_bytes);
+    }
+
+    return fValueChanged;
+}
+
+
+uint8_t DbgChan_SampleSize(const SDebugChannel* pChan)
+{
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    if (pChan->fAggregate)
+    {
+        return DEBUG_AGGREGATE_VALUES * pChan->uSize_bytes;
+    }
+#endif
+    return pChan->uSize_bytes;
+}
+
+
+#if DEBUG_CHANNEL_AGGREGATE > 0
+void DbgChan_Accumulate(SDebugChannel* pChan)
+{
+    SDebugAggregate* pWindow;
+    EChannelFormat format;
+    UDebugNumber value;
+    uint8_t rgValue[8];
+
+    if ((pChan->uSize_bytes > 8) || !DbgChan_PeekValue(pChan, rgValue))
+    {
+        return;
+    }
+    format = NumberFormat(pChan);
+    value = ToNumber(pChan, format, rgValue);
+
+    //the first value of a window initializes it
+    pWindow = &pChan->_rgWindow[DEBUG_LOAD_ACQUIRE(pChan->_uWindow) & 1];
+    if (pWindow->uCount == 0)
+    {
+        pWindow->min = value;
+        pWindow->max = value;
+        pWindow->sum = value;
+        pWindow->uCount = 1;
+        return;
+    }
+
+    if (format == formatFloat)
+    {
+        pWindow->min.d = (value.d < pWindow->min.d) ? value.d : pWindow->min.d;
+        pWindow->max.d = (value.d > pWindow->max.d) ? value.d : pWindow->max.d;
+        pWindow->sum.d += value.d;
+    }
+    else if (format == formatSigned)
+    {
+        pWindow->min.n = (value.n < pWindow->min.n) ? value.n : pWindow->min.n;
+        pWindow->max.n = (value.n > pWindow->max.n) ? value.n : pWindow->max.n;
+        pWindow->sum.u += value.u;      //two's complement, without the undefined signed overflow
+    }
+    else
+    {
+        pWindow->min.u = (value.u < pWindow->min.u) ? value.u : pWindow->min.u;
+        pWindow->max.u = (value.u > pWindow->max.u) ? value.u : pWindow->max.u;
+        pWindow->sum.u += value.u;
+    }
+    ++pWindow->uCount;
+}
+
+
+bool DbgChan_TakeWindow(SDebugChannel* pChan, uint8_t* pValue)
+{
+    SDebugAggregate* pWindow;
+    EChannelFormat format;
+    UDebugNumber mean;
+    uint32_t uWindow;
+    int64_t nCount;
+
+    //the tick continues in the other (emptied) window. The tick preempts the side that takes the window and is never
+    //preempted by it, so it doesn't write the taken window anymore after the switch
+    uWindow = DEBUG_LOAD_RELAXED(pChan->_uWindow) & 1;
+    pChan->_rgWindow[uWindow ^ 1].uCount = 0;
+    DEBUG_STORE_RELEASE(pChan->_uWindow, uWindow ^ 1);
+    DEBUG_FENCE();
+    pWindow = &pChan->_rgWindow[uWindow];
+    if (pWindow->uCount == 0)
+    {
+        return false;
+    }
+
+    //mean rounded to the nearest value for integers
+    format = NumberFormat(pChan);
+    nCount = (int64_t)pWindow->uCount;
+    if (format == formatFloat)
+    {
+        mean.d = pWindow->sum.d / (double)nCount;
+    }
+    else if (format == formatSigned)
+    {
+        mean.n = (pWindow->sum.n >= 0) ? ((pWindow->sum.n + nCount / 2) / nCount) : ((pWindow->sum.n - nCount / 2) / nCount);
+    }
+    else
+    {
+        mean.u = (pWindow->sum.u + (uint64_t)nCount / 2) / (uint64_t)nCount;
+    }
+
+    FromNumber(pChan, format, pWindow->min, pValue);
+    FromNumber(pChan, format, pWindow->max, pValue + pChan->uSize_bytes);
+    FromNumber(pChan, format, mean, pValue + 2 * pChan->uSize_bytes);
+    return true;
+}
+#endif
+
+
+bool ReadValueAny(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    void* pValue;
+    bool fValueChanged;
+
+    //get the address of the actual data
+    pValue = (pChan->_pValue != NULL) ? pChan->_pValue : GetValueAddress(pChan);
+    if (pValue == NULL)
+    {
+        return false;
+    }
+
+    //always read (copy) the actual data
+    memcpy(pValueRead, pValue, pChan->uSize_bytes);
+
+    //check if the value has changed by comparing memory
+    fValueChanged = (memcmp(pValue, pChan->valuePrev.rgByte, pChan->uSize_bytes) != 0) ? true : false;
+    if (fValueChanged)
+    {
+        //remember the new value for next time
+        memcpy(pChan->valuePrev.rgByte, pValue, pChan->uSize_bytes);
+    }
+
+    //return true if we have a new value
+    return fValueChanged;
+}
+
+
+bool ReadValue8(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    uint8_t uValue;
+
+    //single load from the resolved (aligned) address, compare with the previous value
+    uValue = *(uint8_t*)pChan->_pValue;
+    pValueRead[0] = uValue;
+    if (uValue == pChan->valuePrev.rgByte[0])
+    {
+        return false;
+    }
+    pChan->valuePrev.rgByte[0] = uValue;
+    return true;
+}
+
+
+bool ReadValue16(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    uint16_t uValue;
+
+    //single load from the resolved (aligned) address, compare with the previous value
+    uValue = *(uint16_t*)pChan->_pValue;
+    memcpy(pValueRead, &uValue, sizeof(uValue));
+    if (uValue == pChan->valuePrev.u16)
+    {
+        return false;
+    }
+    pChan->valuePrev.u16 = uValue;
+    return true;
+}
+
+
+bool ReadValue32(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    uint32_t uValue;
+
+    //single load from the resolved (aligned) address, compare with the previous value
+    uValue = *(uint32_t*)pChan->_pValue;
+    memcpy(pValueRead, &uValue, sizeof(uValue));
+    if (uValue == pChan->valuePrev.u32)
+    {
+        return false;
+    }
+    pChan->valuePrev.u32 = uValue;
+    return true;
+}
+
+
+bool ReadValue64(SDebugChannel* pChan, uint8_t* pValueRead)
+{
+    uint64_t uValue;
+
+    //single (on 32-bit cores: double) load from the resolved (aligned) address, compare with the previous value
+    uValue = *(uint64_t*)pChan->_pValue;
+    memcpy(pValueRead, &uValue, sizeof(uValue));
+    if (uValue == pChan->valuePrev.u64)
+    {
+        return false;
+    }
+    pChan->valuePrev.u64 = uValue;
+    return true;
+}
+
+
+void* GetValueAddress(SDebugChannel* pChan)
+{
+    int32_t i;
+    void* pValue;
+
+    //check if we have a valid source
+    pValue = pChan->pSource;
+    if (pValue == NULL)
+    {
+        return NULL;
+    }
+
+    //dereference the proper number of times
+    for (i = 0; i < pChan->uPointerDepth; ++i)
+    {
+        //trap null-pounters
+        if (pValue == NULL)
+        {
+            return NULL;
+        }
+
+        //dereference 1 level
+        pValue = *((void**)pValue);
+    }
+
+    return pValue;
+}
+
+
+#if DEBUG_CHANNEL_COMPACT > 0
+uint8_t DbgChan_EncodeCompact(SDebugChannel* pChan, const uint8_t* pValue, bool fKeyValue, uint8_t* rgEncoded)
+{
+    uint64_t uValue;
+    uint64_t uPrev;
+    uint64_t uDelta;
+    uint32_t uBits;
+
+    //key-values (and sizes that can't be encoded) are sent raw, and become the reference for the next value
+    uBits = 8 * (uint32_t)pChan->uSize_bytes;
+    if (fKeyValue || (uBits == 0) || (uBits > 64))
+    {
+        memcpy(rgEncoded, pValue, pChan->uSize_bytes);
+        memcpy(pChan->_rgValueSent, pValue, (pChan->uSize_bytes <= 8) ? pChan->uSize_bytes : 8);
+        return pChan->uSize_bytes;
+    }
+
+    uValue = LoadValue(pValue, pChan->uSize_bytes);
+    uPrev = LoadValue(pChan->_rgValueSent, pChan->uSize_bytes);
+    memcpy(pChan->_rgValueSent, pValue, pChan->uSize_bytes);
+
+    if (pChan->format == formatFloat)
+    {
+        //floats that drift slowly share sign, exponent and the high mantissa-bits, so the XOR has many leading zeros
+        uDelta = uValue ^ uPrev;
+    }
+    else
+    {
+        //difference in the width of the channel, sign-extended to 64 bits and zig-zag encoded (small negative -> small)
+        uDelta = uValue - uPrev;
+        if (uBits < 64)
+        {
+            uDelta &= ((uint64_t)1 << uBits) - 1;
+            if ((uDelta >> (uBits - 1)) & 1)
+            {
+                uDelta |= ~(uint64_t)0 << uBits;
+            }
+        }
+        uDelta = (uDelta & ((uint64_t)1 << 63)) ? ~(uDelta << 1) : (uDelta << 1);
+    }
+
+    return DbgChan_EncodeVarint(uDelta, rgEncoded);
+}
+
+
+uint8_t DbgChan_EncodeVarint(uint64_t uValue, uint8_t* rgEncoded)
+{
+    uint8_t uSize;
+
+    //7 bits per byte, LSB first, MSB of a byte is set when more bytes follow
+    uSize = 0;
+    while (uValue >= 0x80)
+    {
+        rgEncoded[uSize++] = (uint8_t)(uValue | 0x80);
+        uValue >>= 7;
+    }
+    rgEncoded[uSize++] = (uint8_t)uValue;
+
+    return uSize;
+}
+#endif
+
+
+#if (DEBUG_CHANNEL_COMPACT > 0) || (DEBUG_CHANNEL_AGGREGATE > 0)
+uint64_t LoadValue(const uint8_t* pValue, uint8_t uSize_bytes)
+{
+    uint64_t uValue;
+    int32_t i;
+
+    //values are little endian (as they are sent raw)
+    uValue = 0;
+    for (i = uSize_bytes - 1; i >= 0; --i)
+    {
+        uValue = (uValue << 8) | pValue[i];
+    }
+
+    return uValue;
+}
+#endif
+
+
+#if DEBUG_CHANNEL_AGGREGATE > 0
+EChannelFormat NumberFormat(const SDebugChannel* pChan)
+{
+    //only floats and doubles are floating point, other sizes are aggregated as integers
+    if (pChan->format == formatFloat)
+    {
+        return ((pChan->uSize_bytes == sizeof(float)) || (pChan->uSize_bytes == sizeof(double))) ? formatFloat : formatUnsigned;
+    }
+    return pChan->format;
+}
+
+
+UDebugNumber ToNumber(const SDebugChannel* pChan, EChannelFormat format, const uint8_t* pValue)
+{
+    UDebugNumber number;
+    uint32_t uBits;
+    float f;
+
+    if (format == formatFloat)
+    {
+        if (pChan->uSize_bytes == sizeof(float))
+        {
+            memcpy(&f, pValue, sizeof(f));
+            number.d = f;
+        }
+        else
+        {
+            memcpy(&number.d, pValue, sizeof(number.d));
+        }
+        return number;
+    }
+
+    //integers are sign-extended to 64 bits
+    number.u = LoadValue(pValue, pChan->uSize_bytes);
+    uBits = 8 * (uint32_t)pChan->uSize_bytes;
+    if ((format == formatSigned) && (uBits < 64) && ((number.u >> (uBits - 1)) & 1))
+    {
+        number.u |= ~(uint64_t)0 << uBits;
+    }
+    return number;
+}
+
+
+void FromNumber(const SDebugChannel* pChan, EChannelFormat format, UDebugNumber number, uint8_t* pValue)
+{
+    float f;
+    int32_t i;
+
+    if (format == formatFloat)
+    {
+        if (pChan->uSize_bytes == sizeof(float))
+        {
+            f = (float)number.d;
+            memcpy(pValue, &f, sizeof(f));
+        }
+        else
+        {
+            memcpy(pValue, &number.d, sizeof(number.d));
+        }
+        return;
+    }
+
+    //little endian, like LoadValue
+    for (i = 0; i < pChan->uSize_bytes; ++i)
+    {
+        pValue[i] = (uint8_t)number.u;
+        number.u >>= 8;
+    }
+}
+#endif
@@ -1,76 +1,181 @@
-/*
-Embedded Debugger system side which can be used to debug embedded systems at a high level.
-Copyright (C) 2019 DEMCON advanced mechatronics B.V.
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <http://www.gnu.org/licenses/>.
-*/
-
-#ifndef DEBUGCHANNEL_H
-#define DEBUGCHANNEL_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include <stdint.h>
-#include <stdbool.h>
-
-typedef enum EUpdateMode
-{
-    updateOff       = 0x00,     //not active
-    updateFast      = 0x01,     //typically every ms (use decimation!!)
-    updateSlow      = 0x02,     //typically 1Hz
-    updateOnce      = 0x03,     //update once, goes to off after sending 1 sample
-    updateAll       = 0x04      //send all
-} EUpdateMode;
-
-
-typedef enum ESource
-{
-    sourceHandwrittenOffset = 0x00,
-    sourceHandwrittenIndex  = 0x10,
-    sourceSimulinkOffset    = 0x40,
-    sourceSimulinkIndex     = 0x50,
-    sourceAbsoluteAddress   = 0x70,
-} ESource;
-
-
-typedef enum EDirection
-{
-    debugRead               = 0x00,
-    debugWrite              = 0x80
-} EDirection;
-
-
-typedef struct SDebugChannel
-{
-    uint8_t*            pSource;
-    uint8_t             rgValuePrev[8];
-    uint8_t             uSize_bytes;
-    uint8_t             uPointerDepth;
-    EUpdateMode         updateMode;
-    uint8_t             _uCtrl;
-    uint32_t            _uOffset;
-} SDebugChannel;
-
-
-void DbgChan_Init(SDebugChannel* pChan);
-void DbgChan_WriteValue(SDebugChannel* pChan, uint8_t* pValue);
-bool DbgChan_ReadValue(SDebugChannel* pChan, uint8_t* pValue);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif //DEBUGCHANNEL_H
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGCHANNEL_H
+#define DEBUGCHANNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "debugMessage.h"
+
+//nbr of debug-channels (max 256), advertised to the host in the GetInfo reply. The channel-mask in ReadChannelData
+//has 1 bit per channel, with a minimum of 2 bytes (16 channels) for compatibility with hosts that don't read the count
+#ifndef DEBUG_CHANNEL_COUNT
+    #define DEBUG_CHANNEL_COUNT     (16)
+#endif
+#define DEBUG_CHANNEL_MASK_SIZE     ((DEBUG_CHANNEL_COUNT > 16) ? ((DEBUG_CHANNEL_COUNT + 7) / 8) : 2)
+
+//support for the compact channel-data encoding (delta-varint for integers, XOR-varint for floats), which the host
+//selects with the ReadChannelData command. Costs 8 bytes of RAM per channel for the last sent value
+#ifndef DEBUG_CHANNEL_COMPACT
+    #define DEBUG_CHANNEL_COMPACT   (1)
+#endif
+#define DEBUG_VARINT_SIZE_MAX       (10)    //nbr of bytes of a 64-bit varint
+
+//channels with pointer dereferences resolve the pointer-chain at every sample (0), or once when configured (1). With
+//resolve-once, the application calls DebugProt_ResolveChannels() when its pointers change (a mode-only ConfigChannel
+//from the host re-resolves that channel as well)
+#ifndef DEBUG_CHANNEL_RESOLVE_ONCE
+    #define DEBUG_CHANNEL_RESOLVE_ONCE  (0)
+#endif
+
+//support for aggregated channels, which send the min, max and mean of the values of every tick since they were sent
+//last (the window), instead of the value at the tick they are sent. Spikes between two samples are not lost at a
+//high decimation. Costs 64 bytes of RAM per channel, and the tick accumulates the aggregated channels
+#ifndef DEBUG_CHANNEL_AGGREGATE
+    #define DEBUG_CHANNEL_AGGREGATE     (0)
+#endif
+#define DEBUG_AGGREGATE_VALUES      (3)     //nbr of values of an aggregated channel: min, max and mean
+
+typedef enum EUpdateMode
+{
+    updateOff       = 0x00,     //not active
+    updateFast      = 0x01,     //typically every ms (use decimation!!)
+    updateSlow      = 0x02,     //typically 1Hz
+    updateOnce      = 0x03,     //update once, goes to off after sending 1 sample
+    updateAll       = 0x04      //send all
+} EUpdateMode;
+
+
+typedef enum ESource
+{
+    sourceHandwrittenOffset = 0x00,
+    sourceHandwrittenIndex  = 0x10,
+    sourceSimulinkOffset    = 0x40,
+    sourceSimulinkIndex     = 0x50,
+    sourceStimulusTable     = 0x60,     //waveform table of the stimulus generator (memory transfers), offset is ignored
+    sourceAbsoluteAddress   = 0x70,
+} ESource;
+
+
+typedef enum EChannelFormat
+{
+    formatUnsigned          = 0x00,
+    formatSigned            = 0x01,
+    formatFloat             = 0x02
+} EChannelFormat;
+
+
+typedef enum EDirection
+{
+    debugRead               = 0x00,
+    debugWrite              = 0x80
+} EDirection;
+
+
+typedef union UDebugValue
+{
+    uint8_t             rgByte[8];
+    uint16_t            u16;
+    uint32_t            u32;
+    uint64_t            u64;
+} UDebugValue;
+
+
+#if DEBUG_CHANNEL_AGGREGATE > 0
+//a value as a number: signed, unsigned or floating point by the format of the channel
+typedef union UDebugNumber
+{
+    int64_t             n;
+    uint64_t            u;
+    double              d;
+} UDebugNumber;
+
+
+//the window of an aggregated channel (uCount values, none when 0)
+typedef struct SDebugAggregate
+{
+    UDebugNumber        min;
+    UDebugNumber        max;
+    UDebugNumber        sum;
+    uint32_t            uCount;
+} SDebugAggregate;
+#endif
+
+
+typedef struct SDebugChannel SDebugChannel;
+typedef bool (*funcReadChannel)(SDebugChannel* pChan, uint8_t* pValue);
+
+struct SDebugChannel
+{
+    uint8_t*            pSource;
+    UDebugValue         valuePrev;
+    uint8_t             uSize_bytes;
+    uint8_t             uPointerDepth;
+    EUpdateMode         updateMode;
+    uint8_t             _uCtrl;
+    uint32_t            _uOffset;
+    uint8_t             uRateGroup;
+    bool                fResolveOnce;
+    void*               _pValue;        //resolved address of the value (NULL: resolve at every access)
+    funcReadChannel     _pReadValue;    //sampling routine for the size and alignment of the value
+    EChannelFormat      format;
+#if DEBUG_CHANNEL_COMPACT > 0
+    uint8_t             _rgValueSent[8];
+#endif
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    bool                fAggregate;     //send min, max and mean of the window (3 values) instead of the value
+    SDebugAggregate     _rgWindow[2];   //the tick accumulates into one, the other is taken when the channel is sent
+    DebugAtomic32       _uWindow;       //window of the tick, only switched by the side that takes the window
+#endif
+};
+
+
+void DbgChan_Init(SDebugChannel* pChan);
+void DbgChan_Resolve(SDebugChannel* pChan);
+void DbgChan_WriteValue(SDebugChannel* pChan, uint8_t* pValue);
+bool DbgChan_ReadValue(SDebugChannel* pChan, uint8_t* pValue);
+bool DbgChan_PeekValue(SDebugChannel* pChan, uint8_t* pValue);
+void* DbgChan_GetAddress(SDebugChannel* pChan);
+bool DbgChan_ReadSample(SDebugChannel* pChan, const uint8_t* pSample, uint8_t* pValue);
+
+//nbr of bytes of the value(s) of a channel in a sample
+uint8_t DbgChan_SampleSize(const SDebugChannel* pChan);
+
+#if DEBUG_CHANNEL_AGGREGATE > 0
+//add the current value to the window (called by DebugProt_Tick for every aggregated channel)
+void DbgChan_Accumulate(SDebugChannel* pChan);
+//start a new window and add min, max and mean of the previous one to pValue (3 values), false when it is empty
+bool DbgChan_TakeWindow(SDebugChannel* pChan, uint8_t* pValue);
+#endif
+
+#if DEBUG_CHANNEL_COMPACT > 0
+//encode a value relative to the last encoded value of the channel (a key-value is copied as is), returns the nbr of bytes
+uint8_t DbgChan_EncodeCompact(SDebugChannel* pChan, const uint8_t* pValue, bool fKeyValue, uint8_t* rgEncoded);
+uint8_t DbgChan_EncodeVarint(uint64_t uValue, uint8_t* rgEncoded);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGCHANNEL_H
@@ -0,0 +1,157 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "debugMemory.h"
+#include <string.h>             //for using memset and memcpy
+
+#if DEBUG_MEMORY_TRANSFER > 0
+
+
+void DebugMem_Init(SDebugMemory* pMem)
+{
+    memset(pMem, 0, sizeof(SDebugMemory));
+}
+
+
+void DebugMem_StartRead(SDebugMemory* pMem, uint8_t* pAddress, uint32_t uSize)
+{
+    //a new read replaces the read in progress, its fragments are numbered from 0
+    pMem->_pRead = pAddress;
+    pMem->_uReadRemaining = uSize;
+    pMem->_uReadSequence = 0;
+}
+
+
+void DebugMem_StartWrite(SDebugMemory* pMem, uint8_t* pAddress, uint32_t uSize)
+{
+    //a new write replaces the write in progress, the host numbers its fragments from 0
+    pMem->_pWrite = pAddress;
+    pMem->_uWriteRemaining = uSize;
+    pMem->_uWriteSequence = 0;
+}
+
+
+void DebugMem_Abort(SDebugMemory* pMem)
+{
+    pMem->_pRead = NULL;
+    pMem->_uReadRemaining = 0;
+    pMem->_pWrite = NULL;
+    pMem->_uWriteRemaining = 0;
+}
+
+
+uint32_t DebugMem_GetReadFragment(SDebugMemory* pMem, uint8_t* rgFragment)
+{
+    uint32_t uSize;
+    uint16_t uCrc;
+
+    if ((pMem->_pRead == NULL) || (pMem->_uReadRemaining == 0))
+    {
+        return 0;
+    }
+
+    //sequence-nr (LSB first), data and the CRC over both
+    uSize = (pMem->_uReadRemaining < DEBUG_MEMORY_FRAGMENT_SIZE) ? pMem->_uReadRemaining : DEBUG_MEMORY_FRAGMENT_SIZE;
+    rgFragment[0] = (pMem->_uReadSequence >> 0) & 0xFF;
+    rgFragment[1] = (pMem->_uReadSequence >> 8) & 0xFF;
+    memcpy(&rgFragment[2], pMem->_pRead, uSize);
+    uCrc = DebugMem_Crc16(0xFFFF, rgFragment, uSize + 2);
+    rgFragment[uSize + 2] = (uCrc >> 0) & 0xFF;
+    rgFragment[uSize + 3] = (uCrc >> 8) & 0xFF;
+
+    return uSize + 4;
+}
+
+
+void DebugMem_NextReadFragment(SDebugMemory* pMem)
+{
+    uint32_t uSize;
+
+    uSize = (pMem->_uReadRemaining < DEBUG_MEMORY_FRAGMENT_SIZE) ? pMem->_uReadRemaining : DEBUG_MEMORY_FRAGMENT_SIZE;
+    pMem->_pRead += uSize;
+    pMem->_uReadRemaining -= uSize;
+    ++pMem->_uReadSequence;
+    if (pMem->_uReadRemaining == 0)
+    {
+        pMem->_pRead = NULL;
+    }
+}
+
+
+EMemoryResult DebugMem_WriteFragment(SDebugMemory* pMem, const uint8_t* rgFragment, uint32_t uSize)
+{
+    uint16_t uSequence;
+    uint16_t uCrc;
+    uint32_t uDataSize;
+
+    //sequence-nr, at least 1 data byte and the CRC
+    if (uSize < 5)
+    {
+        return memoryInvalid;
+    }
+    uDataSize = uSize - 4;
+    uCrc = (uint16_t)(rgFragment[uSize - 2] | (rgFragment[uSize - 1] << 8));
+    if (DebugMem_Crc16(0xFFFF, rgFragment, uSize - 2) != uCrc)
+    {
+        return memoryCrcError;
+    }
+
+    //fragments are written in order only, the host resends everything from the next expected sequence-nr (also
+    //after the block is complete, when only the last reply was lost)
+    uSequence = (uint16_t)(rgFragment[0] | (rgFragment[1] << 8));
+    if (uSequence != pMem->_uWriteSequence)
+    {
+        return memorySequenceError;
+    }
+    if ((pMem->_pWrite == NULL) || (uDataSize > pMem->_uWriteRemaining))
+    {
+        return memoryNoTransfer;
+    }
+
+    memcpy(pMem->_pWrite, &rgFragment[2], uDataSize);
+    pMem->_pWrite += uDataSize;
+    pMem->_uWriteRemaining -= uDataSize;
+    ++pMem->_uWriteSequence;
+    if (pMem->_uWriteRemaining == 0)
+    {
+        pMem->_pWrite = NULL;
+    }
+
+    return memoryOk;
+}
+
+
+uint16_t DebugMem_Crc16(uint16_t uCrc, const uint8_t* rgData, uint32_t uSize)
+{
+    uint32_t i;
+    int32_t nBit;
+
+    //bitwise, fragments are only checked once and a table would cost 512 bytes of flash
+    for (i = 0; i < uSize; ++i)
+    {
+        uCrc ^= (uint16_t)(rgData[i] << 8);
+        for (nBit = 0; nBit < 8; ++nBit)
+        {
+            uCrc = (uCrc & 0x8000) ? (uint16_t)((uCrc << 1) ^ 0x1021) : (uint16_t)(uCrc << 1);
+        }
+    }
+
+    return uCrc;
+}
+
+#endif //DEBUG_MEMORY_TRANSFER > 0
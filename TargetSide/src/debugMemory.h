@@ -0,0 +1,95 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGMEMORY_H
+#define DEBUGMEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugMessage.h"
+
+//block transfers of target memory (cmdMemory), 0 = no support. A read is streamed by the target, a write is sent by
+//the host, both in fragments with a sequence-nr and a CRC-16 (the CRC-8 of a message lets 1 in 256 corruptions pass)
+#ifndef DEBUG_MEMORY_TRANSFER
+    #define DEBUG_MEMORY_TRANSFER       (1)
+#endif
+
+//nbr of data bytes per fragment: a fragment-message also holds the sub-command, sequence-nr and CRC (5 bytes)
+#ifndef DEBUG_MEMORY_FRAGMENT_SIZE
+    #define DEBUG_MEMORY_FRAGMENT_SIZE  (DEBUG_MSG_SIZE - 6 - 5)
+#endif
+
+
+typedef enum EMemoryCmd
+{
+    memoryCmdRead       = 0x01,     //param: offset (4 bytes), ctrl, position (4 bytes), size (4 bytes), reply: result, fragment-size (2 bytes)
+    memoryCmdData       = 0x02,     //sent by the target: sequence-nr (2 bytes), data, CRC-16 (2 bytes)
+    memoryCmdWrite      = 0x03,     //param: offset (4 bytes), ctrl, position (4 bytes), size (4 bytes), reply: result, fragment-size (2 bytes)
+    memoryCmdWriteData  = 0x04,     //param: sequence-nr (2 bytes), data, CRC-16 (2 bytes), reply: next sequence-nr (2 bytes), result
+    memoryCmdAbort      = 0x05      //reply: result
+} EMemoryCmd;
+
+
+typedef enum EMemoryResult
+{
+    memoryOk            = 0x00,
+    memoryInvalid       = 0x01,     //unknown sub-command, invalid address or parameters
+    memoryCrcError      = 0x02,     //fragment discarded, the host resends from the next sequence-nr
+    memorySequenceError = 0x03,     //fragment discarded, the host resends from the next sequence-nr
+    memoryNoTransfer    = 0x04      //no write in progress, or the fragment exceeds the block
+} EMemoryResult;
+
+
+#if DEBUG_MEMORY_TRANSFER > 0
+
+typedef struct SDebugMemory
+{
+    uint8_t*                _pRead;                             //next byte to send, NULL when no read is in progress
+    uint32_t                _uReadRemaining;
+    uint16_t                _uReadSequence;
+    uint8_t*                _pWrite;                            //next byte to write, NULL when no write is in progress
+    uint32_t                _uWriteRemaining;
+    uint16_t                _uWriteSequence;                    //sequence-nr of the next expected fragment
+} SDebugMemory;
+
+
+void DebugMem_Init(SDebugMemory* pMem);
+void DebugMem_StartRead(SDebugMemory* pMem, uint8_t* pAddress, uint32_t uSize);
+void DebugMem_StartWrite(SDebugMemory* pMem, uint8_t* pAddress, uint32_t uSize);
+void DebugMem_Abort(SDebugMemory* pMem);
+
+//build the next read-fragment (sequence-nr, data, CRC) in rgFragment (DEBUG_MEMORY_FRAGMENT_SIZE + 4 bytes) and
+//return its size, 0 when there is none. The read only advances by DebugMem_NextReadFragment(), once it is sent
+uint32_t DebugMem_GetReadFragment(SDebugMemory* pMem, uint8_t* rgFragment);
+void DebugMem_NextReadFragment(SDebugMemory* pMem);
+
+//check and write a write-fragment (sequence-nr, data, CRC), the reply holds pMem->_uWriteSequence and the result
+EMemoryResult DebugMem_WriteFragment(SDebugMemory* pMem, const uint8_t* rgFragment, uint32_t uSize);
+
+//CRC-16/CCITT (polynomial 0x1021, start with 0xFFFF)
+uint16_t DebugMem_Crc16(uint16_t uCrc, const uint8_t* rgData, uint32_t uSize);
+
+#endif //DEBUG_MEMORY_TRANSFER > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGMEMORY_H
@@ -1,93 +1,151 @@
-/*
-Embedded Debugger system side which can be used to debug embedded systems at a high level.
-Copyright (C) 2019 DEMCON advanced mechatronics B.V.
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <http://www.gnu.org/licenses/>.
-*/
-
-#ifndef DEBUGMESSAGE_H
-#define DEBUGMESSAGE_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include <stdlib.h>
-#include <stdint.h>
-#include <stdbool.h>
-
-#define DEBUG_MSG_SIZE              (128)
-#define DEBUG_BUF_IN_SIZE_BITS      (10)
-#define DEBUG_BUF_IN_SIZE           (1024)      //2^DEBUG_BUF_SIZE_BITS
-
-
-typedef enum EDebugCmd
-{
-    cmdVersion          = 'V',
-    cmdInfo             = 'I',
-    cmdWriteRegister    = 'W',
-    cmdQueryRegister    = 'Q',
-    cmdConfigChannel    = 'C',
-    cmdDecimation       = 'D',
-    cmdResetTime        = 'T',
-    cmdReadChannelData  = 'R',
-    cmdDebugString      = 'S'
-} EDebugCmd;
-
-
-typedef struct SDebugMessageIn
-{
-    bool        fBufferOverrun;
-    bool        fValidMessage;
-    uint32_t    uNodeID;
-    uint8_t     uMsgID;
-    EDebugCmd   cmd;
-    int32_t     nCmdParamSize;
-    uint8_t     rgMessage[DEBUG_MSG_SIZE];
-    bool        _fFoundSTX;
-    uint32_t    _uIndexSTX;
-    uint32_t    _uIndexETX;
-    uint32_t    _uIndexParseNext;
-    uint32_t    _uIndexPush;
-    uint8_t    _rgRawMsgData[DEBUG_BUF_IN_SIZE];
-} SDebugMessageIn;
-
-
-typedef struct SDebugMessageOut
-{
-    uint32_t    uNodeID;
-    EDebugCmd   cmd;
-    uint8_t     uMsgID;
-    uint8_t     rgMessage[DEBUG_MSG_SIZE];
-    uint32_t    _uIndexMessage;
-    uint8_t     _rgRawMsgData[DEBUG_MSG_SIZE];
-    uint32_t    _uIndexRawData;
-} SDebugMessageOut;
-
-
-void DebugMsgIn_Init(SDebugMessageIn* pMsg);
-void DebugMsgIn_AddReceivedData(SDebugMessageIn* pMsg, uint8_t* rgData, uint32_t uSize);
-bool DebugMsgIn_DecodeAndCheck(SDebugMessageIn* pMsg);
-
-void DebugMsgOut_Init(SDebugMessageOut* pMsg);
-bool DebugMsgOut_AddByte(SDebugMessageOut* pMsg, const uint8_t uData);
-bool DebugMsgOut_AddData(SDebugMessageOut* pMsg, const uint8_t* rgParam, uint32_t uSize);
-void DebugMsgOut_Encode(SDebugMessageOut* pMsg);
-
-#ifdef __cplusplus
-}
-#endif
-
-
-#endif //DEBUGMESSAGE_H
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGMESSAGE_H
+#define DEBUGMESSAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DEBUG_MSG_SIZE              (128)
+#define DEBUG_MSG_RAW_SIZE          (2 * DEBUG_MSG_SIZE)    //worst case size of an encoded message (all bytes escaped)
+#define DEBUG_BUF_IN_SIZE_BITS      (10)
+#define DEBUG_BUF_IN_SIZE           (1024)      //2^DEBUG_BUF_SIZE_BITS
+
+//the receive ring-buffer has a single producer (DebugMsgIn_AddReceivedData, typically in ISR context) and a single
+//consumer (DebugMsgIn_DecodeAndCheck, main loop), which only share the push- and pop-index. The data is published
+//with a release-store of the index and taken with an acquire-load. C11 atomics are used when available, otherwise
+//the indexes are volatile and DEBUG_MEMORY_BARRIER orders the accesses: define it as the data memory barrier of the
+//core when it reorders memory accesses (e.g. __DMB() on Cortex-M7, a compiler barrier is sufficient on Cortex-M0/3/4)
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    typedef _Atomic uint32_t        DebugAtomic32;
+    #define DEBUG_LOAD_ACQUIRE(X)           atomic_load_explicit(&(X), memory_order_acquire)
+    #define DEBUG_LOAD_RELAXED(X)           atomic_load_explicit(&(X), memory_order_relaxed)
+    #define DEBUG_STORE_RELEASE(X, V)       atomic_store_explicit(&(X), (V), memory_order_release)
+    #define DEBUG_FENCE()                   atomic_thread_fence(memory_order_seq_cst)
+#else
+    #ifndef DEBUG_MEMORY_BARRIER
+        #if defined(__GNUC__)
+            #define DEBUG_MEMORY_BARRIER()  __sync_synchronize()
+        #else
+            #define DEBUG_MEMORY_BARRIER()
+        #endif
+    #endif
+    typedef volatile uint32_t       DebugAtomic32;
+    #define DEBUG_LOAD_ACQUIRE(X)           DebugAtomic_LoadAcquire(&(X))
+    #define DEBUG_LOAD_RELAXED(X)           (X)
+    #define DEBUG_STORE_RELEASE(X, V)       DebugAtomic_StoreRelease(&(X), (V))
+    #define DEBUG_FENCE()                   DEBUG_MEMORY_BARRIER()
+
+    static inline uint32_t DebugAtomic_LoadAcquire(const volatile uint32_t* pValue)
+    {
+        uint32_t uValue = *pValue;
+        DEBUG_MEMORY_BARRIER();
+        return uValue;
+    }
+
+    static inline void DebugAtomic_StoreRelease(volatile uint32_t* pValue, uint32_t uValue)
+    {
+        DEBUG_MEMORY_BARRIER();
+        *pValue = uValue;
+    }
+#endif
+
+
+typedef enum EDebugCmd
+{
+    cmdVersion          = 'V',
+    cmdInfo             = 'I',
+    cmdWriteRegister    = 'W',
+    cmdQueryRegister    = 'Q',
+    cmdConfigChannel    = 'C',
+    cmdDecimation       = 'D',
+    cmdResetTime        = 'T',
+    cmdReadChannelData  = 'R',
+    cmdDebugString      = 'S',
+    cmdCapture          = 'O',
+    cmdCompactData      = 'P',
+    cmdMemory           = 'M',
+    cmdQueryRegisters   = 'q',
+    cmdWriteRegisters   = 'w',
+    cmdStats            = 'Z',
+    cmdCapabilities     = 'K',
+    cmdSchedule         = 'A',
+    cmdStimulus         = 'G'
+} EDebugCmd;
+
+
+typedef enum EDebugMsgInState
+{
+    msgInIdle           = 0,    //waiting for STX
+    msgInFrame          = 1,    //receiving message-bytes
+    msgInEscape         = 2     //received ESC, next byte must be decoded
+} EDebugMsgInState;
+
+
+typedef struct SDebugMessageIn
+{
+    bool                fValidMessage;
+    uint32_t            uNodeID;
+    uint8_t             uMsgID;
+    EDebugCmd           cmd;
+    int32_t             nCmdParamSize;
+    uint8_t             rgMessage[DEBUG_MSG_SIZE];
+    DebugAtomic32       uOverrunCount;          //nbr of received bytes dropped because the buffer was full
+    uint32_t            uFramingErrorCount;     //nbr of discarded messages due to missing STX/ETX or invalid size
+    uint32_t            uCrcErrorCount;         //nbr of discarded messages due to a CRC-error
+    EDebugMsgInState    _state;
+    uint8_t             _uCRC;
+    uint32_t            _uIndexMessage;
+    DebugAtomic32       _uIndexPop;             //next byte to consume, only written by the consumer
+    DebugAtomic32       _uIndexPush;            //next byte to store, only written by the producer
+    uint8_t             _rgRawMsgData[DEBUG_BUF_IN_SIZE];
+} SDebugMessageIn;
+
+
+typedef struct SDebugMessageOut
+{
+    uint32_t    uNodeID;
+    EDebugCmd   cmd;
+    uint8_t     uMsgID;
+    uint8_t     rgMessage[DEBUG_MSG_SIZE];
+    uint32_t    _uIndexMessage;
+} SDebugMessageOut;
+
+
+void DebugMsgIn_Init(SDebugMessageIn* pMsg);
+void DebugMsgIn_AddReceivedData(SDebugMessageIn* pMsg, uint8_t* rgData, uint32_t uSize);
+bool DebugMsgIn_DecodeAndCheck(SDebugMessageIn* pMsg);
+
+void DebugMsgOut_Init(SDebugMessageOut* pMsg);
+bool DebugMsgOut_AddByte(SDebugMessageOut* pMsg, const uint8_t uData);
+bool DebugMsgOut_AddData(SDebugMessageOut* pMsg, const uint8_t* rgParam, uint32_t uSize);
+uint32_t DebugMsgOut_Encode(SDebugMessageOut* pMsg, uint8_t* rgRawMsgData);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //DEBUGMESSAGE_H
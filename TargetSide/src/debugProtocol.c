@@ -1,653 +1,2285 @@
-/*
-Embedded Debugger system side which can be used to debug embedded systems at a high level.
-Copyright (C) 2019 DEMCON advanced mechatronics B.V.
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <http://www.gnu.org/licenses/>.
-*/
-#include "debugProtocol.h"
-#include <string.h>
-
-//defines
-#define REC_SEPARATOR           (0x33)
-#define INDEX_INC(X)            ++X; X &= ~(0xFFFFFFFF << DEBUG_STRING_IN_SIZE_BITS);
-#define INDEX_DEC(X)            --X; X &= ~(0xFFFFFFFF << DEBUG_STRING_IN_SIZE_BITS);
-#define DEBUG_SLOW_UPDATE_MS    (1000)
-
-//#define ASSERT (void)0;
-
-//global variables
-const uint8_t   g_rgVersionDebug[4] = {0x00, 0x05, 0x00, 0x00};     //major, minor, build-LSB, build-MSB
-SDebugProtocol* g_pProtDebug        = NULL;
-
-extern uint32_t time;
-//local function prototypes
-static void Dispatch(SDebugProtocol* pDebug);
-static void CmdVersion(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdInfo(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdWriteRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdQueryRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdConfigChannel(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdDecimation(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdResetTime(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdReadChannelData(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-static void CmdDebugString(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
-
-static void SendChannelData(SDebugProtocol* pDebug, bool fSlowUpdate);
-static void SendMessage(SDebugProtocol* pDebug, SDebugMessageOut* pMsg);
-
-
-void DebugProt_Init(
-    SDebugProtocol*         pDebug,
-    const uint8_t*          rgVersionApp,
-    const char*             szNodeName,
-    const char*             szSerialNr,
-    uint32_t                uNodeID,
-    funcGetByte             pGetByte,
-    funcWriteData           pWriteData,
-    funcGetRegisterAddress  pGetRegisterAddress
-    )
-{
-    //store access to this debugger, uC node-ID, application-version, app protocol
-    g_pProtDebug = pDebug;
-    memcpy(pDebug->_rgVersionApp, rgVersionApp, 4);
-    pDebug->_szNodeName = szNodeName;
-    pDebug->_szSerialNr = szSerialNr;
-    pDebug->uNodeID = uNodeID;
-    pDebug->pGetByte = pGetByte;
-    pDebug->pWriteData = pWriteData;
-    pDebug->pGetRegisterAddress = pGetRegisterAddress;
-    pDebug->uDecimation = 1;
-    pDebug->fChannelTracingOn = true;
-
-    //init children
-    DebugMsgIn_Init(&pDebug->_msgReceived);
-}
-
-
-void DebugProt_DoMain(SDebugProtocol* pDebug)
-{
-    uint32_t dT_tick;
-
-    //check for debug-messages, and dispatch messages that are complete
-    while (DebugMsgIn_DecodeAndCheck(&pDebug->_msgReceived) == true)
-    {
-        Dispatch(pDebug);
-    }
-
-    //check if we need to send new fast-update channel-data
-    dT_tick = pDebug->uTimeDebug_tick - pDebug->_uTimeDebugPrevFast_tick;
-    if ((pDebug->fChannelTracingOn || pDebug->fChannelTracingOnce) && (dT_tick >= pDebug->uDecimation))
-    {
-        //check if we also need to send slow-update channel-data
-        if (pDebug->uTimeDebug_tick - pDebug->_uTimeDebugPrevSlow_tick >= ((uint32_t)(1000) * DEBUG_SLOW_UPDATE_MS / 1000))
-        {
-            SendChannelData(pDebug, true);
-            pDebug->_uTimeDebugPrevFast_tick = pDebug->uTimeDebug_tick;
-            pDebug->_uTimeDebugPrevSlow_tick = pDebug->uTimeDebug_tick;
-        }
-        else
-        {
-            SendChannelData(pDebug, false);
-            pDebug->_uTimeDebugPrevFast_tick = pDebug->uTimeDebug_tick;
-        }
-
-        //reset the tracing-once mode
-        pDebug->fChannelTracingOnce = false;
-    }
-}
-
-
-void DebugProt_DoISR(SDebugProtocol* pDebug)
-{
-    uint8_t data = 0;
-    //increase the internal debug-time
-    ++pDebug->uTimeDebug_tick;
-
-
-    if (pDebug->pGetByte(&data))
-    {
-        DebugProt_AddReceivedData(pDebug,&data,1);
-    }
-}
-
-
-void DebugProt_AddReceivedData(SDebugProtocol* pDebug, uint8_t* rgData, uint32_t uSize)
-{
-    //store data in message-buffer
-    DebugMsgIn_AddReceivedData(&pDebug->_msgReceived, rgData, uSize);
-}
-
-
-void Dispatch(SDebugProtocol* pDebug)
-{
-    SDebugMessageOut msgReply;
-
-    //check if the message is for us
-    if ((pDebug->_msgReceived.uNodeID != pDebug->uNodeID) && (pDebug->_msgReceived.uNodeID != 0xFF))
-    {
-        //discard the message
-        return;
-    }
-
-    //copy uC nodeID, msgID, command
-    DebugMsgOut_Init(&msgReply);
-    msgReply.uNodeID = pDebug->uNodeID;
-    msgReply.uMsgID = pDebug->_msgReceived.uMsgID;
-    msgReply.cmd = pDebug->_msgReceived.cmd;
-
-    //dispatch the command
-    switch (pDebug->_msgReceived.cmd)
-    {
-        case cmdVersion:            CmdVersion(pDebug, &msgReply);          break;
-        case cmdInfo:               CmdInfo(pDebug, &msgReply);             break;
-        case cmdWriteRegister:      CmdWriteRegister(pDebug, &msgReply);    break;
-        case cmdQueryRegister:      CmdQueryRegister(pDebug, &msgReply);    break;
-        case cmdConfigChannel:      CmdConfigChannel(pDebug, &msgReply);    break;
-        case cmdDecimation:         CmdDecimation(pDebug, &msgReply);       break;
-        case cmdResetTime:          CmdResetTime(pDebug, &msgReply);        break;
-        case cmdReadChannelData:    CmdReadChannelData(pDebug, &msgReply);  break;
-        case cmdDebugString:        CmdDebugString(pDebug, &msgReply);      break;
-        default:                                                            break;  //ignore, do nothing
-    }
-
-    //send the reply-message (either ACK, or reply-data)
-    if ((msgReply.uMsgID != 0) || (msgReply._uIndexMessage > 3))
-    {
-        SendMessage(pDebug, &msgReply);
-    }
-}
-
-
-void CmdVersion(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    uint8_t uStrLength;
-
-    //check for valid pointers
-    ASSERT(pMsgReply != NULL);
-
-    //copy version-info of debugger (proper endianess of build-UINT16
-    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[0]);
-    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[1]);
-    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[2]);
-    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[3]);
-
-    //copy version-info of application
-    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[0]);
-    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[1]);
-    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[2]);
-    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[3]);
-
-    //copy name of the node
-    uStrLength = strlen(pDebug->_szNodeName);
-    DebugMsgOut_AddByte(pMsgReply, uStrLength);
-    DebugMsgOut_AddData(pMsgReply, (uint8_t*)pDebug->_szNodeName, uStrLength);
-
-    //copy serial-number string
-    uStrLength = strlen(pDebug->_szSerialNr);
-    DebugMsgOut_AddByte(pMsgReply, uStrLength);
-    DebugMsgOut_AddData(pMsgReply, (uint8_t*)pDebug->_szSerialNr, uStrLength);
-}
-
-
-void CmdInfo(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    //check for valid pointers
-    ASSERT(pMsgReply != NULL);
-
-    //byte alignment
-    DebugMsgOut_AddByte(pMsgReply, 0);
-    DebugMsgOut_AddByte(pMsgReply, &pDebug->nDummyForAlignment1 - &pDebug->nDummyForAlignment0);
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //pointer
-    DebugMsgOut_AddByte(pMsgReply, 1);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(void*));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //boolean
-    DebugMsgOut_AddByte(pMsgReply, 2);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(bool));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //char
-    DebugMsgOut_AddByte(pMsgReply, 3);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(char));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //short
-    DebugMsgOut_AddByte(pMsgReply, 4);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(short));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //int
-    DebugMsgOut_AddByte(pMsgReply, 5);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(int));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //long
-    DebugMsgOut_AddByte(pMsgReply, 6);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(long));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //float
-    DebugMsgOut_AddByte(pMsgReply, 7);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(float));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //double
-    DebugMsgOut_AddByte(pMsgReply, 8);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(double));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //long double
-    DebugMsgOut_AddByte(pMsgReply, 9);
-    DebugMsgOut_AddByte(pMsgReply, sizeof(double));
-    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
-
-    //time-stamp units
-    DebugMsgOut_AddByte(pMsgReply, 10);
-    DebugMsgOut_AddByte(pMsgReply, (((uint32_t)1000) >>  0) & 0xFF);   //LSB
-    DebugMsgOut_AddByte(pMsgReply, (((uint32_t)1000) >>  8) & 0xFF);
-    DebugMsgOut_AddByte(pMsgReply, (((uint32_t)1000) >> 16) & 0xFF);
-    DebugMsgOut_AddByte(pMsgReply, (((uint32_t)1000) >> 24) & 0xFF);   //MSB
-}
-
-
-void CmdWriteRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    SDebugChannel debugChannel;
-
-    //extract offset and control-byte from received message
-    DbgChan_Init(&debugChannel);
-    memcpy((uint8_t*)&debugChannel._uOffset, &pDebug->_msgReceived.rgMessage[3], 4);
-    debugChannel._uCtrl = pDebug->_msgReceived.rgMessage[7];
-
-    //get actual variable address
-    pDebug->pGetRegisterAddress(&debugChannel);
-
-    //get the size of the new value
-    debugChannel.uSize_bytes = pDebug->_msgReceived.rgMessage[8];
-
-    //write the new value
-    DbgChan_WriteValue(&debugChannel, &pDebug->_msgReceived.rgMessage[9]);
-}
-
-
-void CmdQueryRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    SDebugChannel debugChannel;
-    uint8_t rgValue[8];
-
-    //extract offset and control-byte from received message
-    DbgChan_Init(&debugChannel);
-    memcpy((uint8_t*)&debugChannel._uOffset, &pDebug->_msgReceived.rgMessage[3], 4);
-    debugChannel._uCtrl = pDebug->_msgReceived.rgMessage[7];
-    //get the size of the register
-    debugChannel.uSize_bytes = pDebug->_msgReceived.rgMessage[8];
-
-    //get actual variable address
-    pDebug->pGetRegisterAddress(&debugChannel);
-
-    //get the value of the register
-    DbgChan_ReadValue(&debugChannel, rgValue);
-
-    //construct a reply: add the parameters of the quesry-cmd to the reply
-    DebugMsgOut_AddData(pMsgReply, &pDebug->_msgReceived.rgMessage[3], 6);
-    //add the value of the register to the reply
-    DebugMsgOut_AddData(pMsgReply, rgValue, 4);
-}
-
-
-void CmdConfigChannel(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    uint8_t uChan;
-    SDebugChannel* pChan;
-
-    //get the proper channel-nr
-    uChan = pDebug->_msgReceived.rgMessage[3];
-
-    //ignore invalid channel-nrs
-    if (uChan > 0x0F)
-    {
-        return;
-    }
-
-    //get access to the proper channel (increase redability)
-    pChan = &pDebug->_rgRegisterRead[uChan];
-
-    switch (pDebug->_msgReceived.nCmdParamSize)
-    {
-        case 1:
-        {
-            //--- query current settings ---
-            //add channel to reply
-            DebugMsgOut_AddByte(pMsgReply, uChan);
-            //add mode to reply
-            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->updateMode);
-            //add offset to reply
-            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pChan->_uOffset), 4);
-            //add control-uint8_t to reply
-            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->_uCtrl);
-            //add data-size to reply
-            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->uSize_bytes);
-            break;
-        }
-
-        case 2:
-        {
-            //--- only change the update-mode ---
-            pChan->updateMode = (EUpdateMode)pDebug->_msgReceived.rgMessage[4];
-            //turn tracing once on if necessary
-            if (pChan->updateMode == updateOnce)
-            {
-                pDebug->fChannelTracingOnce = true;
-            }
-            //add channel to reply
-            DebugMsgOut_AddByte(pMsgReply, uChan);
-            //add (new) mode to reply
-            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->updateMode);
-            break;
-        }
-
-        default:
-        {
-            //--- completely configure channel ---
-            DbgChan_Init(pChan);
-            //set new update-mode
-            pChan->updateMode = (EUpdateMode)pDebug->_msgReceived.rgMessage[4];
-            //turn tracing once on if necessary
-            if (pChan->updateMode == updateOnce)
-            {
-                pDebug->fChannelTracingOnce = true;
-            }
-            //set new offset
-            memcpy((uint8_t*)(&pChan->_uOffset), &pDebug->_msgReceived.rgMessage[5], 4);
-            //set new control-uint8_t
-            pChan->_uCtrl = pDebug->_msgReceived.rgMessage[9];
-            //set new data-size
-            pChan->uSize_bytes = pDebug->_msgReceived.rgMessage[10];
-            //set the pointer-depth
-            pChan->uPointerDepth = pChan->_uCtrl & 0x0F;
-            //get source-address from application
-            if (pDebug->pGetRegisterAddress != NULL)
-            {
-                pDebug->pGetRegisterAddress(pChan);
-            }
-            //make sure to send at least 1 time, by aktering 1 LSB byte
-            pChan->rgValuePrev[0] ^= 0xFF;
-            //add channel to reply
-            DebugMsgOut_AddByte(pMsgReply, uChan);
-            break;
-        }
-    }
-}
-
-
-void CmdDecimation(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    //check for valid pointers
-    ASSERT(pMsgReply != NULL);
-
-    //set the new decimation
-    if (pDebug->_msgReceived.nCmdParamSize == 1)
-    {
-        pDebug->uDecimation = (uint32_t)pDebug->_msgReceived.rgMessage[3];
-        if (pDebug->uDecimation == 0)
-        {
-            pDebug->uDecimation = 1;
-        }
-    }
-
-    //reply with the current decimation
-    DebugMsgOut_AddByte(pMsgReply, (uint8_t)pDebug->uDecimation);
-}
-
-
-void CmdResetTime(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    //reset the debug-time
-    pDebug->uTimeDebug_tick = pDebug->_uTimeDebugPrevFast_tick = pDebug->_uTimeDebugPrevSlow_tick = 0;
-
-    //reply with the same message
-}
-
-
-void CmdReadChannelData(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    //set channel-data tracing-mode
-    switch (pDebug->_msgReceived.rgMessage[3])
-    {
-        default:
-            pDebug->fChannelTracingOn = false;
-            break;
-        case 1:
-            pDebug->fChannelTracingOn = true;
-            break;
-        case 2:
-            pDebug->fChannelTracingOnce = true;
-            break;
-    }
-
-    //no reply
-}
-
-
-void CmdDebugString(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
-{
-    int32_t i;
-
-    //check for valid pointers
-    ASSERT(pMsgReply != NULL);
-
-    //add the new received chars to buffer
-    for (i = 0; i < pDebug->_msgReceived.nCmdParamSize; ++i)
-    {
-        pDebug->_rgDebugCharIn[pDebug->_uIndexPushChar] = pDebug->_msgReceived.rgMessage[i + 3];
-
-        //goto next write-position in buffer
-        INDEX_INC(pDebug->_uIndexPushChar);
-
-        //check if we have a buffer-overrun, ignore extra received chars
-        if (pDebug->_uIndexPushChar == pDebug->_uIndexPopChar)
-        {
-            INDEX_DEC(pDebug->_uIndexPushChar);
-            break;
-        }
-    }
-}
-
-
-void SendChannelData(SDebugProtocol* pDebug, bool fSlowUpdate)
-{
-    int32_t i;
-    SDebugChannel* pDbgChan;
-    SDebugMessageOut msgOut;
-    uint8_t rgValue[8];
-    uint16_t uNewDataMask;
-    bool fNeedUpdate;
-    bool fForceUpdate;
-    bool fChanged;
-
-    //check for valid pointers
-    ASSERT(pDebug->pWriteData != NULL);
-
-    //create new message
-    DebugMsgOut_Init(&msgOut);
-    msgOut.uNodeID = pDebug->uNodeID;
-    msgOut.uMsgID = 0;
-    msgOut.cmd = cmdReadChannelData;
-
-    //create timestamp
-    rgValue[0] = (pDebug->uTimeDebug_tick >>  0) & 0xFF;
-    rgValue[1] = (pDebug->uTimeDebug_tick >>  8) & 0xFF;
-    rgValue[2] = (pDebug->uTimeDebug_tick >> 16) & 0xFF;
-    DebugMsgOut_AddData(&msgOut, rgValue, 3);
-
-    //create mask and values
-    uNewDataMask = 0;
-    DebugMsgOut_AddData(&msgOut, (uint8_t*)(&uNewDataMask), 2);
-    for (i = 15; i >= 0; --i)
-    {
-        //get access to the debug-channel (increase readability)
-        pDbgChan = &pDebug->_rgRegisterRead[i];
-        //check if we need to send data for this channel
-        fNeedUpdate   = (pDbgChan->updateMode == updateFast);
-
-
-        // the force update flag will always send an update
-        fForceUpdate  = (pDbgChan->updateMode == updateAll );
-        fForceUpdate |= (pDbgChan->updateMode == updateSlow) && (fSlowUpdate == true);
-        fForceUpdate |= (pDbgChan->updateMode == updateOnce) && (pDebug->fChannelTracingOnce == true);
-//         //reset updateOnce flag if necessary
-//         if (pDbgChan->updateMode == updateOnce)
-//         {
-//             pDbgChan->updateMode = updateOff;
-//         }
-        //if we need to update, check if the value-data has changed. In case of a force update always send a new value
-        fChanged = DbgChan_ReadValue(pDbgChan, rgValue);
-        if ( (fNeedUpdate && fChanged) ||
-              fForceUpdate
-            )
-        {
-            //set the bit in the mask
-            uNewDataMask |= (0x0001 << i);
-            //add the value to the message
-            DebugMsgOut_AddData(&msgOut, rgValue, pDbgChan->uSize_bytes);
-        }
-    }
-
-    //send the data if it is not empty
-    if (uNewDataMask != 0)
-    {
-        //insert the channel-mask at the proper location in the message
-        msgOut.rgMessage[6] = uNewDataMask & 0xFF;
-        msgOut.rgMessage[7] = uNewDataMask >> 8;
-
-        //encode the message
-        DebugMsgOut_Encode(&msgOut);
-
-        //send the new message over the debug-protocol
-        pDebug->pWriteData( msgOut._rgRawMsgData, msgOut._uIndexRawData );
-    }
-}
-
-
-void SendMessage(SDebugProtocol* pDebug, SDebugMessageOut* pMsg)
-{
-    //check for valid pointers
-    ASSERT(pDebug->pWriteData != NULL);
-
-    //encode the message
-    DebugMsgOut_Encode(pMsg);
-
-    //send the new message over the debug-protocol
-    pDebug->pWriteData( pMsg->_rgRawMsgData, pMsg->_uIndexRawData );
-}
-
-
-//----------------------------------------------------------------------------
-//    Debug tools
-//----------------------------------------------------------------------------
-void DebugProt_AssertFail(const char* szAssertion, const char* szFile, const int32_t nLineNr)
-{
-    char szLineNr[5];
-    int32_t nStringPos = 0;
-    int32_t nLine;
-    int32_t i;
-
-    //convert line-nr to string
-    nLine = nLineNr;
-    i = nLine / 1000;
-    nLine -= i * 1000;
-    if (i > 0)
-    {
-        szLineNr[nStringPos++] = i + '0';
-    }
-    i = nLine / 100;
-    nLine -= i * 100;
-    if ((i > 0) || (nStringPos > 0))
-    {
-        szLineNr[nStringPos++] = i + '0';
-    }
-    i = nLine / 10;
-    nLine -= i * 10;
-    if ((i > 0) || (nStringPos > 0))
-    {
-        szLineNr[nStringPos++] = i + '0';
-    }
-    szLineNr[nStringPos++] = nLine + '0';
-    szLineNr[nStringPos++] = '\0';
-
-    //output an assertion debug-string
-    DebugProt_Trace("Assert fail: '");
-    DebugProt_Trace(szAssertion);
-    DebugProt_Trace("' (file: ");
-    DebugProt_Trace(szFile);
-    DebugProt_Trace(", line: ");
-    DebugProt_Trace(szLineNr);
-    DebugProt_Trace(")\r\n");
-}
-
-
-void DebugProt_Trace(const char* szString)
-{
-    SDebugMessageOut msg;
-
-    //check if we have access to the (global) debug protocol
-    if (g_pProtDebug == NULL)
-    {
-        ASSERT(g_pProtDebug != NULL);
-        return;
-    }
-
-    //create new message
-    DebugMsgOut_Init(&msg);
-    msg.uNodeID = g_pProtDebug->uNodeID;
-    msg.cmd = cmdDebugString;
-    DebugMsgOut_AddData(&msg, (const uint8_t*)szString, strlen(szString));
-
-    //send message
-    SendMessage(g_pProtDebug, &msg);
-}
-
-
-bool DebugProt_GetChar(char* pChar)
-{
-    //check for valid pointers
-    ASSERT(g_pProtDebug != NULL);
-    ASSERT(pChar != NULL);
-
-    //check if we have access to the (global) debug protocol
-    if (g_pProtDebug == NULL)
-    {
-        //indicate no char to read
-        return false;
-    }
-
-    //check if we have a char in the buffer that was not read yet
-    if (g_pProtDebug->_uIndexPopChar != g_pProtDebug->_uIndexPushChar)
-    {
-        //read the char
-        *pChar = g_pProtDebug->_rgDebugCharIn[g_pProtDebug->_uIndexPopChar];
-
-        //increase read-position of ring-buffer
-        INDEX_INC(g_pProtDebug->_uIndexPopChar);
-
-        //indicate we have read a char
-        return true;
-    }
-
-    //indicate no char to read
-    return false;
-}
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "debugProtocol.h"
+#include <string.h>
+
+//defines
+#define REC_SEPARATOR           (0x33)
+#define INDEX_INC(X)            ++X; X &= ~(0xFFFFFFFF << DEBUG_STRING_IN_SIZE_BITS);
+#define INDEX_DEC(X)            --X; X &= ~(0xFFFFFFFF << DEBUG_STRING_IN_SIZE_BITS);
+#define DEBUG_SLOW_UPDATE_MS    (1000)
+
+//#define ASSERT (void)0;
+
+//global variables
+const uint8_t   g_rgVersionDebug[4] = {0x00, 0x05, 0x00, 0x00};     //major, minor, build-LSB, build-MSB
+static SDebugProtocol* g_pProtDebugFirst = NULL;    //instances for the trace-functions without instance
+
+//capabilities and their limits, fixed at compile-time. The host picks the fastest mode the target supports
+static const SDebugCapability g_rgCapability[] =
+{
+    { "capability.query",       2,  { (DEBUG_MSG_SIZE >> 0) & 0xFF, (DEBUG_MSG_SIZE >> 8) & 0xFF } },
+    { "debug.signal.trace",     4,  { (DEBUG_CHANNEL_COUNT >> 0) & 0xFF, (DEBUG_CHANNEL_COUNT >> 8) & 0xFF, DEBUG_RATE_GROUP_COUNT, DEBUG_TIMESTAMP_SIZE } },
+#if DEBUG_CHANNEL_COMPACT > 0
+    { "debug.signal.compact",   0,  { 0 } },
+#endif
+#if DEBUG_CHANNEL_BATCH > 0
+    { "debug.signal.batch",     0,  { 0 } },
+#endif
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    { "debug.signal.aggregate", 0,  { 0 } },
+#endif
+#if DEBUG_CAPTURE_SIZE > 0
+    { "debug.signal.capture",   4,  { (DEBUG_CAPTURE_SIZE >> 0) & 0xFF, (DEBUG_CAPTURE_SIZE >> 8) & 0xFF, (DEBUG_CAPTURE_SIZE >> 16) & 0xFF, (DEBUG_CAPTURE_SIZE >> 24) & 0xFF } },
+#endif
+    { "debug.register.batch",   2,  { ((DEBUG_MSG_SIZE - 6) >> 0) & 0xFF, ((DEBUG_MSG_SIZE - 6) >> 8) & 0xFF } },
+#if DEBUG_MEMORY_TRANSFER > 0
+    { "debug.memory.transfer",  2,  { (DEBUG_MEMORY_FRAGMENT_SIZE >> 0) & 0xFF, (DEBUG_MEMORY_FRAGMENT_SIZE >> 8) & 0xFF } },
+#endif
+#if DEBUG_STATS > 0
+    { "debug.stats",            0,  { 0 } },
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+    { "debug.register.schedule", 3, { (DEBUG_SCHEDULE_COUNT >> 0) & 0xFF, (DEBUG_SCHEDULE_COUNT >> 8) & 0xFF, DEBUG_SCHEDULE_GROUPS } },
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+    { "debug.stimulus",         4,  { (DEBUG_STIMULUS_SIZE >> 0) & 0xFF, (DEBUG_STIMULUS_SIZE >> 8) & 0xFF, (DEBUG_STIMULUS_SIZE >> 16) & 0xFF, (DEBUG_STIMULUS_SIZE >> 24) & 0xFF } },
+#endif
+};
+
+#define DEBUG_CAPABILITY_COUNT  (sizeof(g_rgCapability) / sizeof(g_rgCapability[0]))
+//local function prototypes
+static void Dispatch(SDebugProtocol* pDebug);
+static void CmdVersion(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdInfo(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdWriteRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdQueryRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdQueryRegisters(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdWriteRegisters(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void InitRegister(SDebugProtocol* pDebug, SDebugChannel* pChan, const uint8_t* rgParam);
+static void CmdConfigChannel(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdDecimation(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdResetTime(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdReadChannelData(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdDebugString(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void CmdCapabilities(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+#if DEBUG_CAPTURE_SIZE > 0
+static void CmdCapture(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+#endif
+#if DEBUG_MEMORY_TRANSFER > 0
+static void CmdMemory(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+static void SendMemoryFragments(SDebugProtocol* pDebug);
+#endif
+#if DEBUG_STATS > 0
+static void CmdStats(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+static void CmdSchedule(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+static void CmdStimulus(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply);
+#endif
+
+static void SendChannelTick(SDebugProtocol* pDebug, uint64_t uTime_tick, const uint8_t* pSample);
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+static void SendSampledChannelData(SDebugProtocol* pDebug, uint32_t uTime_tick);
+#endif
+static void SendChannelData(SDebugProtocol* pDebug, bool fSlowUpdate, const uint8_t* pSample);
+static void InitChannelFrame(SDebugProtocol* pDebug, SDebugMessageOut* pMsg);
+static uint32_t AddChannelRecord(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, uint8_t* rgNewDataMask, bool fKeyFrame);
+static void CloseChannelRecord(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, uint32_t uMaskIndex, uint8_t* rgNewDataMask);
+static bool SendChannelFrame(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, bool fKeyFrame, bool fContinued);
+#if DEBUG_CHANNEL_BATCH > 0
+static bool FlushChannelBatch(SDebugProtocol* pDebug);
+#endif
+static bool SendMessage(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, EDebugTxPriority ePriority);
+static bool CanReply(SDebugProtocol* pDebug);
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+static bool CanSendChannelData(SDebugProtocol* pDebug);
+#endif
+static bool DecodeMessage(SDebugProtocol* pDebug);
+static void SendString(SDebugProtocol* pDebug, const char* szString);
+static void SendStrings(SDebugProtocol* pDebug, const char* const* rgszString, uint32_t uCount);
+
+
+void DebugProt_Init(
+    SDebugProtocol*         pDebug,
+    const uint8_t*          rgVersionApp,
+    const char*             szNodeName,
+    const char*             szSerialNr,
+    uint32_t                uNodeID,
+    funcGetByte             pGetByte,
+    funcWriteData           pWriteData,
+    funcGetRegisterAddress  pGetRegisterAddress
+    )
+{
+    SDebugProtocol* pInstance;
+    int32_t i;
+
+    //add this debugger to the instances that get the traces (once, it may be initialized again)
+    for (pInstance = g_pProtDebugFirst; (pInstance != NULL) && (pInstance != pDebug); pInstance = pInstance->_pNextInstance)
+    {
+    }
+    if (pInstance == NULL)
+    {
+        pDebug->_pNextInstance = g_pProtDebugFirst;
+        g_pProtDebugFirst = pDebug;
+    }
+    pDebug->fTraceAll = true;
+
+    //store uC node-ID, application-version, app protocol
+    memcpy(pDebug->_rgVersionApp, rgVersionApp, 4);
+    pDebug->_szNodeName = szNodeName;
+    pDebug->_szSerialNr = szSerialNr;
+    pDebug->uNodeID = uNodeID;
+    pDebug->pGetByte = pGetByte;
+    pDebug->pWriteData = pWriteData;
+    pDebug->pGetRegisterAddress = pGetRegisterAddress;
+    DebugProt_SetTickPeriod(pDebug, DEBUG_TICK_US);
+    pDebug->uDecimation = 1;
+    for (i = 0; i < DEBUG_RATE_GROUP_COUNT; ++i)
+    {
+        pDebug->rguRateDecimation[i] = 1;
+    }
+    pDebug->fChannelTracingOn = true;
+
+    //init children
+    DebugMsgIn_Init(&pDebug->_msgReceived);
+#if DEBUG_TX_BUFFER_COUNT > 0
+    DebugTx_Init(&pDebug->_tx, pWriteData, false);
+#endif
+#if DEBUG_CAPTURE_SIZE > 0
+    DebugCapt_Init(&pDebug->_capture);
+#endif
+#if DEBUG_MEMORY_TRANSFER > 0
+    DebugMem_Init(&pDebug->_memory);
+#endif
+#if DEBUG_STATS > 0
+    DebugStats_Init(&pDebug->_stats, NULL, 0);
+#endif
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+    DebugSample_Init(&pDebug->_sampleQueue);
+    pDebug->_sampleMode = sampleInMain;
+    pDebug->_uSampleDropReported = 0;
+#endif
+#if DEBUG_SNAPSHOT > 0
+    pDebug->_snapshot.pLock = NULL;
+    pDebug->_snapshot.pShadow = NULL;
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+    DebugSched_Init(&pDebug->_schedule);
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+    DebugStim_Init(&pDebug->_stimulus);
+#endif
+}
+
+
+void DebugProt_DoMain(SDebugProtocol* pDebug)
+{
+    uint32_t uTime_tick;
+    uint32_t dT_tick;
+    uint32_t uOverrunCount;
+    uint32_t uStart_cycles;
+
+    uStart_cycles = DEBUG_STATS_START(&pDebug->_stats);
+
+    //check for debug-messages, and dispatch messages that are complete (as long as the reply can be sent)
+    while (CanReply(pDebug) && (DecodeMessage(pDebug) == true))
+    {
+        Dispatch(pDebug);
+    }
+
+    //report a receive-buffer overrun (once per occurrence, the Stats reply holds the number of dropped bytes).
+    //The counter is only written by the receiving side, so it is compared instead of clearing a shared flag
+    uOverrunCount = DEBUG_LOAD_ACQUIRE(pDebug->_msgReceived.uOverrunCount);
+    if (uOverrunCount != pDebug->_uOverrunReported)
+    {
+        pDebug->_uOverrunReported = uOverrunCount;
+        SendString(pDebug, "Debug: receive buffer overrun\r\n");
+    }
+
+    //extend the debug-time to 64 bits (the tick-counter can't wrap twice between 2 calls), the interrupt only
+    //increments the 32 bits counter, so the upper bits are never read half-written
+    uTime_tick = pDebug->uTimeDebug_tick;
+    if (uTime_tick < pDebug->_uTimeDebugLast_tick)
+    {
+        ++pDebug->_uTimeDebugEpoch;
+    }
+    pDebug->_uTimeDebugLast_tick = uTime_tick;
+
+#if DEBUG_CHANNEL_BATCH > 0
+    //send a batch of channel-data when its first tick has waited long enough (also when there is no new data)
+    if ((pDebug->_uBatchCount > 0) && (uTime_tick - pDebug->_uBatchStart_tick >= pDebug->uBatchLatency_tick))
+    {
+        FlushChannelBatch(pDebug);
+    }
+#endif
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+    //send the ticks that were sampled by DebugProt_Sample
+    if (pDebug->_sampleMode != sampleInMain)
+    {
+        SendSampledChannelData(pDebug, uTime_tick);
+    }
+    else
+#endif
+    {
+        //check if we need to send new fast-update channel-data
+        dT_tick = uTime_tick - pDebug->_uTimeDebugPrevFast_tick;
+        if ((pDebug->fChannelTracingOn || pDebug->fChannelTracingOnce) && (dT_tick >= pDebug->uDecimation))
+        {
+            SendChannelTick(pDebug, ((uint64_t)pDebug->_uTimeDebugEpoch << 32) | uTime_tick, NULL);
+        }
+    }
+
+#if DEBUG_MEMORY_TRANSFER > 0
+    //stream the fragments of a memory-read, behind the channel-data of this tick
+    SendMemoryFragments(pDebug);
+#endif
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+    //write the encoded messages by priority, within the byte budget (only with a synchronous writer)
+    DebugTx_Flush(&pDebug->_tx, DEBUG_TX_BUDGET_BYTES);
+#endif
+
+    DEBUG_STATS_STOP(&pDebug->_stats, statsDoMain, uStart_cycles);
+}
+
+
+void DebugProt_DoISR(SDebugProtocol* pDebug)
+{
+    //increase the internal debug-time
+    DebugProt_Tick(pDebug);
+
+    //fetch all bytes the application has available
+    DebugProt_PollReceive(pDebug);
+}
+
+
+void DebugProt_Tick(SDebugProtocol* pDebug)
+{
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    int32_t i;
+
+#endif
+    //increase the internal debug-time
+    ++pDebug->uTimeDebug_tick;
+
+#if DEBUG_SCHEDULE_COUNT > 0
+    //apply the scheduled writes of this tick, before the channels are sampled
+    DebugSched_Apply(&pDebug->_schedule, pDebug->uTimeDebug_tick);
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+    //write the stimulus of this tick, before the channels are sampled (so it has the timestamp of its response)
+    DebugStim_Tick(&pDebug->_stimulus, pDebug->uTimeDebug_tick);
+#endif
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    //add the value of this tick to the window of the aggregated channels, before it is sampled
+    for (i = 0; i < DEBUG_CHANNEL_COUNT; ++i)
+    {
+        if (pDebug->_rgRegisterRead[i].fAggregate && (pDebug->_rgRegisterRead[i].updateMode != updateOff))
+        {
+            DbgChan_Accumulate(&pDebug->_rgRegisterRead[i]);
+        }
+    }
+#endif
+#if DEBUG_CAPTURE_SIZE > 0
+    //record the captured channels of this tick
+    DebugCapt_Sample(&pDebug->_capture, pDebug->_rgRegisterRead, pDebug->uTimeDebug_tick);
+#endif
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+    //sample the channel-data at the tick itself
+    if (pDebug->_sampleMode == sampleInTick)
+    {
+        DebugProt_Sample(pDebug);
+    }
+#endif
+}
+
+
+void DebugProt_PollReceive(SDebugProtocol* pDebug)
+{
+    uint8_t rgData[DEBUG_POLL_CHUNK_SIZE];
+    uint32_t uSize;
+    uint32_t uTotal;
+
+    //receiving may also be done by the application itself through DebugProt_AddReceivedData
+    if (pDebug->pGetByte == NULL)
+    {
+        return;
+    }
+
+    //drain the byte-source in chunks, bounded by the size of the receive buffer
+    uTotal = 0;
+    do
+    {
+        uSize = 0;
+        while ((uSize < DEBUG_POLL_CHUNK_SIZE) && pDebug->pGetByte(&rgData[uSize]))
+        {
+            ++uSize;
+        }
+        DebugProt_AddReceivedData(pDebug, rgData, uSize);
+        uTotal += uSize;
+    } while ((uSize == DEBUG_POLL_CHUNK_SIZE) && (uTotal < DEBUG_BUF_IN_SIZE));
+}
+
+
+void DebugProt_AddReceivedData(SDebugProtocol* pDebug, uint8_t* rgData, uint32_t uSize)
+{
+    //store data in message-buffer (block-copy, may be called with a complete DMA- or idle-line chunk)
+    DebugMsgIn_AddReceivedData(&pDebug->_msgReceived, rgData, uSize);
+#if DEBUG_STATS > 0
+    pDebug->_stats.uRxBytes += uSize;
+#endif
+}
+
+
+void DebugProt_SetTickPeriod(SDebugProtocol* pDebug, uint32_t uTick_us)
+{
+    //the slow-update channels are sent every DEBUG_SLOW_UPDATE_MS (at least every tick)
+    pDebug->_uTick_us = (uTick_us > 0) ? uTick_us : 1;
+    pDebug->_uSlowUpdate_tick = ((uint32_t)DEBUG_SLOW_UPDATE_MS * 1000) / pDebug->_uTick_us;
+}
+
+
+#if DEBUG_STATS > 0
+void DebugProt_SetCycleCounter(SDebugProtocol* pDebug, funcGetCycles pGetCycles, uint32_t uCycles_Hz)
+{
+    //start with fresh statistics, cycles of another counter can't be compared
+    DebugStats_Init(&pDebug->_stats, pGetCycles, uCycles_Hz);
+    pDebug->_stats._uRxOverrunBase = DEBUG_LOAD_ACQUIRE(pDebug->_msgReceived.uOverrunCount);
+    pDebug->_stats._uFramingErrorBase = pDebug->_msgReceived.uFramingErrorCount;
+    pDebug->_stats._uCrcErrorBase = pDebug->_msgReceived.uCrcErrorCount;
+}
+#endif
+
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+void DebugProt_SetSampleMode(SDebugProtocol* pDebug, ESampleMode mode)
+{
+    //the samples of the previous mode are discarded
+    pDebug->_sampleMode = mode;
+    DebugSample_Invalidate(&pDebug->_sampleQueue);
+}
+
+
+void DebugProt_Sample(SDebugProtocol* pDebug)
+{
+    uint32_t uTime_tick;
+
+    //sample all active channels when the channel-data is due, once per tick (the rate-groups are selected when
+    //sending). A sample that doesn't fit in the queue is dropped, and reported by DebugProt_DoMain
+    uTime_tick = pDebug->uTimeDebug_tick;
+    if ((pDebug->fChannelTracingOn || pDebug->fChannelTracingOnce) &&
+        (uTime_tick - pDebug->_uTimeSamplePrev_tick >= pDebug->uDecimation))
+    {
+#if DEBUG_SNAPSHOT > 0
+        DebugSample_Push(&pDebug->_sampleQueue, pDebug->_rgRegisterRead, &pDebug->_snapshot, uTime_tick);
+#else
+        DebugSample_Push(&pDebug->_sampleQueue, pDebug->_rgRegisterRead, NULL, uTime_tick);
+#endif
+        pDebug->_uTimeSamplePrev_tick = uTime_tick;
+    }
+}
+#endif
+
+
+#if DEBUG_SNAPSHOT > 0
+void DebugProt_SetSnapshotLock(SDebugProtocol* pDebug, funcSnapshotLock pLock)
+{
+    pDebug->_snapshot.pLock = pLock;
+}
+
+
+void DebugProt_SetShadow(SDebugProtocol* pDebug, SDebugShadow* pShadow)
+{
+    pDebug->_snapshot.pShadow = pShadow;
+}
+#endif
+
+
+void DebugProt_ResolveChannels(SDebugProtocol* pDebug)
+{
+    int32_t i;
+
+    //resolve the addresses of all channels again, e.g. after the application changed pointers of a pointer-chain
+    for (i = 0; i < DEBUG_CHANNEL_COUNT; ++i)
+    {
+        DbgChan_Resolve(&pDebug->_rgRegisterRead[i]);
+    }
+}
+
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+void DebugProt_SetWriteAsync(SDebugProtocol* pDebug, funcWriteData pStartWrite)
+{
+    //only allowed when no messages are pending
+    ASSERT(DebugTx_Available(&pDebug->_tx) == DEBUG_TX_BUFFER_COUNT);
+
+    pDebug->pWriteData = pStartWrite;
+    DebugTx_Init(&pDebug->_tx, pStartWrite, true);
+}
+
+
+void DebugProt_WriteComplete(SDebugProtocol* pDebug)
+{
+    //release the written buffer and start the next one
+    DebugTx_WriteComplete(&pDebug->_tx);
+}
+#endif
+
+
+void Dispatch(SDebugProtocol* pDebug)
+{
+    SDebugMessageOut msgReply;
+
+    //check if the message is for us
+    if ((pDebug->_msgReceived.uNodeID != pDebug->uNodeID) && (pDebug->_msgReceived.uNodeID != 0xFF))
+    {
+        //discard the message
+        return;
+    }
+
+    //copy uC nodeID, msgID, command
+    DebugMsgOut_Init(&msgReply);
+    msgReply.uNodeID = pDebug->uNodeID;
+    msgReply.uMsgID = pDebug->_msgReceived.uMsgID;
+    msgReply.cmd = pDebug->_msgReceived.cmd;
+
+    //dispatch the command
+    switch (pDebug->_msgReceived.cmd)
+    {
+        case cmdVersion:            CmdVersion(pDebug, &msgReply);          break;
+        case cmdInfo:               CmdInfo(pDebug, &msgReply);             break;
+        case cmdWriteRegister:      CmdWriteRegister(pDebug, &msgReply);    break;
+        case cmdQueryRegister:      CmdQueryRegister(pDebug, &msgReply);    break;
+        case cmdQueryRegisters:     CmdQueryRegisters(pDebug, &msgReply);   break;
+        case cmdWriteRegisters:     CmdWriteRegisters(pDebug, &msgReply);   break;
+        case cmdConfigChannel:      CmdConfigChannel(pDebug, &msgReply);    break;
+        case cmdDecimation:         CmdDecimation(pDebug, &msgReply);       break;
+        case cmdResetTime:          CmdResetTime(pDebug, &msgReply);        break;
+        case cmdReadChannelData:    CmdReadChannelData(pDebug, &msgReply);  break;
+        case cmdDebugString:        CmdDebugString(pDebug, &msgReply);      break;
+        case cmdCapabilities:       CmdCapabilities(pDebug, &msgReply);     break;
+#if DEBUG_CAPTURE_SIZE > 0
+        case cmdCapture:            CmdCapture(pDebug, &msgReply);          break;
+#endif
+#if DEBUG_MEMORY_TRANSFER > 0
+        case cmdMemory:             CmdMemory(pDebug, &msgReply);           break;
+#endif
+#if DEBUG_STATS > 0
+        case cmdStats:              CmdStats(pDebug, &msgReply);            break;
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+        case cmdSchedule:           CmdSchedule(pDebug, &msgReply);         break;
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+        case cmdStimulus:           CmdStimulus(pDebug, &msgReply);         break;
+#endif
+        default:                                                            break;  //ignore, do nothing
+    }
+
+    //send the reply-message (either ACK, or reply-data)
+    if ((msgReply.uMsgID != 0) || (msgReply._uIndexMessage > 3))
+    {
+        SendMessage(pDebug, &msgReply, txPrioReply);
+    }
+}
+
+
+void CmdVersion(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    uint8_t uStrLength;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //copy version-info of debugger (proper endianess of build-UINT16
+    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[0]);
+    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[1]);
+    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[2]);
+    DebugMsgOut_AddByte(pMsgReply, g_rgVersionDebug[3]);
+
+    //copy version-info of application
+    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[0]);
+    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[1]);
+    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[2]);
+    DebugMsgOut_AddByte(pMsgReply, pDebug->_rgVersionApp[3]);
+
+    //copy name of the node
+    uStrLength = strlen(pDebug->_szNodeName);
+    DebugMsgOut_AddByte(pMsgReply, uStrLength);
+    DebugMsgOut_AddData(pMsgReply, (uint8_t*)pDebug->_szNodeName, uStrLength);
+
+    //copy serial-number string
+    uStrLength = strlen(pDebug->_szSerialNr);
+    DebugMsgOut_AddByte(pMsgReply, uStrLength);
+    DebugMsgOut_AddData(pMsgReply, (uint8_t*)pDebug->_szSerialNr, uStrLength);
+}
+
+
+void CmdInfo(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //byte alignment
+    DebugMsgOut_AddByte(pMsgReply, 0);
+    DebugMsgOut_AddByte(pMsgReply, &pDebug->nDummyForAlignment1 - &pDebug->nDummyForAlignment0);
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //pointer
+    DebugMsgOut_AddByte(pMsgReply, 1);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(void*));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //boolean
+    DebugMsgOut_AddByte(pMsgReply, 2);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(bool));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //char
+    DebugMsgOut_AddByte(pMsgReply, 3);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(char));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //short
+    DebugMsgOut_AddByte(pMsgReply, 4);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(short));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //int
+    DebugMsgOut_AddByte(pMsgReply, 5);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(int));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //long
+    DebugMsgOut_AddByte(pMsgReply, 6);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(long));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //float
+    DebugMsgOut_AddByte(pMsgReply, 7);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(float));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //double
+    DebugMsgOut_AddByte(pMsgReply, 8);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(double));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //long double
+    DebugMsgOut_AddByte(pMsgReply, 9);
+    DebugMsgOut_AddByte(pMsgReply, sizeof(double));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //time-stamp units
+    DebugMsgOut_AddByte(pMsgReply, 10);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->_uTick_us >>  0) & 0xFF);  //LSB
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->_uTick_us >>  8) & 0xFF);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->_uTick_us >> 16) & 0xFF);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->_uTick_us >> 24) & 0xFF);  //MSB
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //nbr of debug-channels
+    DebugMsgOut_AddByte(pMsgReply, 11);
+    DebugMsgOut_AddByte(pMsgReply, (DEBUG_CHANNEL_COUNT >> 0) & 0xFF);    //LSB
+    DebugMsgOut_AddByte(pMsgReply, (DEBUG_CHANNEL_COUNT >> 8) & 0xFF);    //MSB
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //supported channel-data encodings (bit 0: raw, bit 1: compact, bit 2: batched compact)
+    DebugMsgOut_AddByte(pMsgReply, 12);
+    DebugMsgOut_AddByte(pMsgReply, ((DEBUG_CHANNEL_COMPACT > 0) ? 0x03 : 0x01) | ((DEBUG_CHANNEL_BATCH > 0) ? 0x04 : 0x00));
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //nbr of rate-groups
+    DebugMsgOut_AddByte(pMsgReply, 13);
+    DebugMsgOut_AddByte(pMsgReply, DEBUG_RATE_GROUP_COUNT);
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //nbr of bytes of the channel-data timestamp
+    DebugMsgOut_AddByte(pMsgReply, 14);
+    DebugMsgOut_AddByte(pMsgReply, DEBUG_TIMESTAMP_SIZE);
+
+#if DEBUG_MEMORY_TRANSFER > 0
+    //nbr of data bytes of a memory-fragment
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+    DebugMsgOut_AddByte(pMsgReply, 15);
+    DebugMsgOut_AddByte(pMsgReply, (DEBUG_MEMORY_FRAGMENT_SIZE >> 0) & 0xFF);  //LSB
+    DebugMsgOut_AddByte(pMsgReply, (DEBUG_MEMORY_FRAGMENT_SIZE >> 8) & 0xFF);  //MSB
+#endif
+    DebugMsgOut_AddByte(pMsgReply, REC_SEPARATOR);
+
+    //max nbr of bytes of cmd-data (for the multi-register commands)
+    DebugMsgOut_AddByte(pMsgReply, 16);
+    DebugMsgOut_AddByte(pMsgReply, ((DEBUG_MSG_SIZE - 6) >> 0) & 0xFF);    //LSB
+    DebugMsgOut_AddByte(pMsgReply, ((DEBUG_MSG_SIZE - 6) >> 8) & 0xFF);    //MSB
+}
+
+
+void CmdWriteRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugChannel debugChannel;
+
+    //extract offset, control-byte and size from received message, and get actual variable address
+    InitRegister(pDebug, &debugChannel, &pDebug->_msgReceived.rgMessage[3]);
+
+    //write the new value
+    DbgChan_WriteValue(&debugChannel, &pDebug->_msgReceived.rgMessage[9]);
+}
+
+
+void CmdQueryRegister(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugChannel debugChannel;
+    uint8_t rgValue[8];
+
+    //extract offset, control-byte and size from received message, and get actual variable address
+    InitRegister(pDebug, &debugChannel, &pDebug->_msgReceived.rgMessage[3]);
+
+    //get the value of the register
+    DbgChan_ReadValue(&debugChannel, rgValue);
+
+    //construct a reply: add the parameters of the quesry-cmd to the reply
+    DebugMsgOut_AddData(pMsgReply, &pDebug->_msgReceived.rgMessage[3], 6);
+    //add the value of the register to the reply
+    DebugMsgOut_AddData(pMsgReply, rgValue, 4);
+}
+
+
+void CmdQueryRegisters(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugChannel debugChannel;
+    uint8_t* rgParam;
+    uint32_t uCountIndex;
+    uint8_t uCount;
+    int32_t nPos;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without tag
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+
+    //reply: tag, nbr of registers that fit in the reply, their packed values
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+    uCountIndex = pMsgReply->_uIndexMessage;
+    DebugMsgOut_AddByte(pMsgReply, 0);
+    uCount = 0;
+
+    //param: tag, per register offset (4 bytes), control-byte, size
+    for (nPos = 1; nPos + 6 <= pDebug->_msgReceived.nCmdParamSize; nPos += 6)
+    {
+        InitRegister(pDebug, &debugChannel, &rgParam[nPos]);
+        if ((debugChannel.uSize_bytes > 8) ||
+            (pMsgReply->_uIndexMessage + debugChannel.uSize_bytes > DEBUG_MSG_SIZE - 3))
+        {
+            break;
+        }
+
+        //copy the value straight into the reply (registers without a valid address read as 0)
+        if (!DbgChan_PeekValue(&debugChannel, &pMsgReply->rgMessage[pMsgReply->_uIndexMessage]))
+        {
+            memset(&pMsgReply->rgMessage[pMsgReply->_uIndexMessage], 0, debugChannel.uSize_bytes);
+        }
+        pMsgReply->_uIndexMessage += debugChannel.uSize_bytes;
+        ++uCount;
+    }
+    pMsgReply->rgMessage[uCountIndex] = uCount;
+}
+
+
+void CmdWriteRegisters(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugChannel debugChannel;
+    uint8_t* rgParam;
+    uint8_t uCount;
+    int32_t nPos;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without tag
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+    uCount = 0;
+
+    //param: tag, per register offset (4 bytes), control-byte, size, value (size bytes)
+    for (nPos = 1; nPos + 6 <= pDebug->_msgReceived.nCmdParamSize; nPos += 6 + debugChannel.uSize_bytes)
+    {
+        InitRegister(pDebug, &debugChannel, &rgParam[nPos]);
+        if ((debugChannel.uSize_bytes > 8) ||
+            (nPos + 6 + debugChannel.uSize_bytes > pDebug->_msgReceived.nCmdParamSize))
+        {
+            break;
+        }
+        DbgChan_WriteValue(&debugChannel, &rgParam[nPos + 6]);
+        ++uCount;
+    }
+
+    //reply: tag, nbr of registers written
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+    DebugMsgOut_AddByte(pMsgReply, uCount);
+}
+
+
+void InitRegister(SDebugProtocol* pDebug, SDebugChannel* pChan, const uint8_t* rgParam)
+{
+    //extract offset (4 bytes), control-byte and size
+    DbgChan_Init(pChan);
+    memcpy((uint8_t*)&pChan->_uOffset, &rgParam[0], 4);
+    pChan->_uCtrl = rgParam[4];
+    pChan->uPointerDepth = pChan->_uCtrl & 0x0F;
+    pChan->uSize_bytes = rgParam[5];
+
+    //get actual variable address
+    pDebug->pGetRegisterAddress(pChan);
+}
+
+
+void CmdConfigChannel(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    uint8_t uChan;
+    SDebugChannel* pChan;
+
+    //get the proper channel-nr
+    uChan = pDebug->_msgReceived.rgMessage[3];
+
+    //ignore invalid channel-nrs (with 256 channels every channel-nr is valid)
+#if DEBUG_CHANNEL_COUNT < 256
+    if (uChan >= DEBUG_CHANNEL_COUNT)
+    {
+        return;
+    }
+#endif
+
+    //get access to the proper channel (increase redability)
+    pChan = &pDebug->_rgRegisterRead[uChan];
+
+    switch (pDebug->_msgReceived.nCmdParamSize)
+    {
+        case 1:
+        {
+            //--- query current settings ---
+            //add channel to reply
+            DebugMsgOut_AddByte(pMsgReply, uChan);
+            //add mode to reply
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->updateMode);
+            //add offset to reply
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pChan->_uOffset), 4);
+            //add control-uint8_t to reply
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->_uCtrl);
+            //add data-size to reply
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->uSize_bytes);
+            break;
+        }
+
+        case 2:
+        {
+            //--- only change the update-mode ---
+            pChan->updateMode = (EUpdateMode)pDebug->_msgReceived.rgMessage[4];
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+            //the queued samples hold the values of the previous channels
+            DebugSample_Invalidate(&pDebug->_sampleQueue);
+#endif
+            //re-resolve the address (pointer-chains with the resolve-once policy may have changed)
+            DbgChan_Resolve(pChan);
+            //turn tracing once on if necessary
+            if (pChan->updateMode == updateOnce)
+            {
+                pDebug->fChannelTracingOnce = true;
+            }
+            //add channel to reply
+            DebugMsgOut_AddByte(pMsgReply, uChan);
+            //add (new) mode to reply
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pChan->updateMode);
+            break;
+        }
+
+        default:
+        {
+            //--- completely configure channel ---
+            DbgChan_Init(pChan);
+            //set new update-mode
+            pChan->updateMode = (EUpdateMode)pDebug->_msgReceived.rgMessage[4];
+            //turn tracing once on if necessary
+            if (pChan->updateMode == updateOnce)
+            {
+                pDebug->fChannelTracingOnce = true;
+            }
+            //set new offset
+            memcpy((uint8_t*)(&pChan->_uOffset), &pDebug->_msgReceived.rgMessage[5], 4);
+            //set new control-uint8_t
+            pChan->_uCtrl = pDebug->_msgReceived.rgMessage[9];
+            //set new data-size
+            pChan->uSize_bytes = pDebug->_msgReceived.rgMessage[10];
+            //set the pointer-depth
+            pChan->uPointerDepth = pChan->_uCtrl & 0x0F;
+            //set the (optional) value-format
+            if (pDebug->_msgReceived.nCmdParamSize > 8)
+            {
+                pChan->format = (EChannelFormat)pDebug->_msgReceived.rgMessage[11];
+            }
+#if DEBUG_CHANNEL_COMPACT > 0
+            //restart compact channel-data with a key-frame
+            pDebug->_fCompactKeyFrame = true;
+#endif
+            //set the (optional) rate-group, invalid groups fall back to the default group
+            if (pDebug->_msgReceived.nCmdParamSize > 9)
+            {
+                pChan->uRateGroup = pDebug->_msgReceived.rgMessage[12];
+                if (pChan->uRateGroup >= DEBUG_RATE_GROUP_COUNT)
+                {
+                    pChan->uRateGroup = 0;
+                }
+            }
+#if DEBUG_CHANNEL_AGGREGATE > 0
+            //set the (optional) aggregation, for values of at most 8 bytes (the window starts empty)
+            if (pDebug->_msgReceived.nCmdParamSize > 10)
+            {
+                pChan->fAggregate = (pDebug->_msgReceived.rgMessage[13] != 0) && (pChan->uSize_bytes <= 8);
+            }
+#endif
+            //get source-address from application
+            if (pDebug->pGetRegisterAddress != NULL)
+            {
+                pDebug->pGetRegisterAddress(pChan);
+            }
+            //resolve the address and select the sampling routine once, instead of at every sample
+            DbgChan_Resolve(pChan);
+            //make sure to send at least 1 time, by aktering 1 LSB byte
+            pChan->valuePrev.rgByte[0] ^= 0xFF;
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+            //the queued samples hold the values of the previous channels
+            DebugSample_Invalidate(&pDebug->_sampleQueue);
+#endif
+            //add channel to reply
+            DebugMsgOut_AddByte(pMsgReply, uChan);
+            break;
+        }
+    }
+}
+
+
+void CmdDecimation(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    int32_t i;
+    int32_t nGroups;
+    uint8_t* pParam;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //set the new decimation: 1, 2 or 4 bytes (LSB first), optionally followed by 2 bytes for each rate-group
+    pParam = &pDebug->_msgReceived.rgMessage[3];
+    switch (pDebug->_msgReceived.nCmdParamSize)
+    {
+        case 0:
+            break;
+        case 1:
+            pDebug->uDecimation = (uint32_t)pParam[0];
+            break;
+        case 2:
+            pDebug->uDecimation = (uint32_t)pParam[0] | ((uint32_t)pParam[1] << 8);
+            break;
+        default:
+            if ((pDebug->_msgReceived.nCmdParamSize & 1) != 0)
+            {
+                //3 bytes or a partial rate-group decimation: keep the settings, only reply with them
+                break;
+            }
+            pDebug->uDecimation = (uint32_t)pParam[0] | ((uint32_t)pParam[1] << 8) | ((uint32_t)pParam[2] << 16) | ((uint32_t)pParam[3] << 24);
+            nGroups = (pDebug->_msgReceived.nCmdParamSize - 4) / 2;
+            for (i = 0; (i < nGroups) && (i < DEBUG_RATE_GROUP_COUNT); ++i)
+            {
+                pDebug->rguRateDecimation[i] = (uint16_t)(pParam[4 + 2 * i] | (pParam[5 + 2 * i] << 8));
+                if (pDebug->rguRateDecimation[i] == 0)
+                {
+                    pDebug->rguRateDecimation[i] = 1;
+                }
+                //restart the group, so groups with the same decimation are sampled at the same tick
+                pDebug->_rguRateCount[i] = 0;
+            }
+            break;
+    }
+    if (pDebug->uDecimation == 0)
+    {
+        pDebug->uDecimation = 1;
+    }
+
+    //reply with the current decimation (4 bytes, LSB first) and the decimation of each rate-group
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->uDecimation >>  0) & 0xFF);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->uDecimation >>  8) & 0xFF);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->uDecimation >> 16) & 0xFF);
+    DebugMsgOut_AddByte(pMsgReply, (pDebug->uDecimation >> 24) & 0xFF);
+    for (i = 0; i < DEBUG_RATE_GROUP_COUNT; ++i)
+    {
+        DebugMsgOut_AddByte(pMsgReply, (pDebug->rguRateDecimation[i] >> 0) & 0xFF);
+        DebugMsgOut_AddByte(pMsgReply, (pDebug->rguRateDecimation[i] >> 8) & 0xFF);
+    }
+}
+
+
+void CmdResetTime(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    //reset the debug-time
+    pDebug->uTimeDebug_tick = pDebug->_uTimeDebugPrevFast_tick = pDebug->_uTimeDebugPrevSlow_tick = 0;
+    pDebug->_uTimeDebugLast_tick = pDebug->_uTimeDebugEpoch = 0;
+#if DEBUG_CHANNEL_COMPACT > 0
+    pDebug->_fCompactKeyFrame = true;
+#endif
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+    //the queued samples have the old time
+    pDebug->_uTimeSamplePrev_tick = 0;
+    DebugSample_Invalidate(&pDebug->_sampleQueue);
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+    //the ticks of the armed groups refer to the old time
+    DebugSched_Cancel(&pDebug->_schedule, DEBUG_SCHEDULE_ALL);
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+    //an armed stimulus waits for a tick of the old time (a running stimulus continues)
+    if (DEBUG_LOAD_ACQUIRE(pDebug->_stimulus.uState) == stimulusArmed)
+    {
+        DebugStim_Stop(&pDebug->_stimulus);
+    }
+#endif
+
+    //reply with the same message
+}
+
+
+void CmdReadChannelData(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    //set channel-data tracing-mode
+    switch (pDebug->_msgReceived.rgMessage[3])
+    {
+        default:
+            pDebug->fChannelTracingOn = false;
+            break;
+        case 1:
+            pDebug->fChannelTracingOn = true;
+            break;
+        case 2:
+            pDebug->fChannelTracingOnce = true;
+            break;
+    }
+
+#if DEBUG_CHANNEL_COMPACT > 0
+    //select the (optional) channel-data encoding: 0 = raw, 1 = compact (starting with a key-frame)
+    if (pDebug->_msgReceived.nCmdParamSize > 1)
+    {
+        pDebug->fChannelCompact = (pDebug->_msgReceived.rgMessage[4] == 1);
+        pDebug->_fCompactKeyFrame = true;
+    }
+#endif
+#if DEBUG_CHANNEL_BATCH > 0
+    //set the (optional) batching of compact channel-data: max nbr of ticks per frame and the max latency in ticks
+    //(by default the time these ticks take)
+    if (pDebug->_msgReceived.nCmdParamSize > 2)
+    {
+        FlushChannelBatch(pDebug);
+        pDebug->uBatchTicks = pDebug->_msgReceived.rgMessage[5];
+        pDebug->uBatchLatency_tick = pDebug->uBatchTicks * pDebug->uDecimation;
+        if (pDebug->_msgReceived.nCmdParamSize > 4)
+        {
+            pDebug->uBatchLatency_tick = pDebug->_msgReceived.rgMessage[6] | (pDebug->_msgReceived.rgMessage[7] << 8);
+        }
+    }
+#endif
+
+    //no reply
+}
+
+
+void CmdDebugString(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    int32_t i;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //add the new received chars to buffer
+    for (i = 0; i < pDebug->_msgReceived.nCmdParamSize; ++i)
+    {
+        pDebug->_rgDebugCharIn[pDebug->_uIndexPushChar] = pDebug->_msgReceived.rgMessage[i + 3];
+
+        //goto next write-position in buffer
+        INDEX_INC(pDebug->_uIndexPushChar);
+
+        //check if we have a buffer-overrun, ignore extra received chars
+        if (pDebug->_uIndexPushChar == pDebug->_uIndexPopChar)
+        {
+            INDEX_DEC(pDebug->_uIndexPushChar);
+            break;
+        }
+    }
+}
+
+
+void CmdCapabilities(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    const SDebugCapability* pCap;
+    uint32_t uIndex;
+    uint32_t uNameSize;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //start at the requested capability (0 without parameter), the host asks for the rest when they don't all fit
+    uIndex = (pDebug->_msgReceived.nCmdParamSize > 0) ? pDebug->_msgReceived.rgMessage[3] : 0;
+    DebugMsgOut_AddByte(pMsgReply, (uint8_t)uIndex);
+    DebugMsgOut_AddByte(pMsgReply, (uint8_t)DEBUG_CAPABILITY_COUNT);
+
+    //add name-size, name, data-size and data of each capability that fits completely
+    for (; uIndex < DEBUG_CAPABILITY_COUNT; ++uIndex)
+    {
+        pCap = &g_rgCapability[uIndex];
+        uNameSize = (uint32_t)strlen(pCap->szName);
+        if (pMsgReply->_uIndexMessage + 2 + uNameSize + pCap->uSize > DEBUG_MSG_SIZE - 3)
+        {
+            break;
+        }
+        DebugMsgOut_AddByte(pMsgReply, (uint8_t)uNameSize);
+        DebugMsgOut_AddData(pMsgReply, (const uint8_t*)pCap->szName, uNameSize);
+        DebugMsgOut_AddByte(pMsgReply, pCap->uSize);
+        DebugMsgOut_AddData(pMsgReply, pCap->rgData, pCap->uSize);
+    }
+}
+
+
+#if DEBUG_CAPTURE_SIZE > 0
+void CmdCapture(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugCapture* pCapt;
+    SDebugTrigger trigger;
+    uint8_t* rgParam;
+    uint32_t uValue;
+    uint32_t uSize;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without sub-command
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+
+    //get access to the capture and the parameters (increase readability)
+    pCapt = &pDebug->_capture;
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+
+    //add sub-command to reply
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+
+    switch ((ECaptureCmd)rgParam[0])
+    {
+        case captureCmdStatus:
+        {
+            //add state, record-size, record-count and channel-mask to reply
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pCapt->state);
+            DebugMsgOut_AddByte(pMsgReply, (pCapt->uRecordSize >> 0) & 0xFF);
+            DebugMsgOut_AddByte(pMsgReply, (pCapt->uRecordSize >> 8) & 0xFF);
+            uValue = pCapt->uRecordCount;
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uValue), 4);
+            DebugMsgOut_AddData(pMsgReply, pCapt->rgMask, DEBUG_CHANNEL_MASK_SIZE);
+            uValue = pCapt->uTriggerIndex;
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uValue), 4);
+            break;
+        }
+
+        case captureCmdStart:
+        {
+            //start capturing all active channels (optionally decimated)
+            uValue = 1;
+            if (pDebug->_msgReceived.nCmdParamSize >= 3)
+            {
+                uValue = rgParam[1] | ((uint32_t)rgParam[2] << 8);
+            }
+            DebugMsgOut_AddByte(pMsgReply, DebugCapt_Start(pCapt, pDebug->_rgRegisterRead, uValue) ? 0x00 : 0x01);
+            break;
+        }
+
+        case captureCmdArm:
+        {
+            //param: channel, mode, format, level (8 bytes), pre-count (4 bytes), post-count (4 bytes), decimation (2 bytes)
+            if (pDebug->_msgReceived.nCmdParamSize < 22)
+            {
+                return;
+            }
+            trigger.uChannel = rgParam[1];
+            trigger.mode = (ETriggerMode)rgParam[2];
+            trigger.format = (ETriggerFormat)rgParam[3];
+            memcpy(trigger.rgLevel, &rgParam[4], 8);
+            memcpy((uint8_t*)(&trigger.uPreCount), &rgParam[12], 4);
+            memcpy((uint8_t*)(&trigger.uPostCount), &rgParam[16], 4);
+            uValue = rgParam[20] | ((uint32_t)rgParam[21] << 8);
+            DebugMsgOut_AddByte(pMsgReply, DebugCapt_Arm(pCapt, pDebug->_rgRegisterRead, uValue, &trigger) ? 0x00 : 0x01);
+            break;
+        }
+
+        case captureCmdDisarm:
+        {
+            //discard the armed capture, and add the (new) state to reply
+            DebugCapt_Disarm(pCapt);
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pCapt->state);
+            break;
+        }
+
+        case captureCmdStop:
+        {
+            //stop capturing, and add the (new) state to reply
+            DebugCapt_Stop(pCapt);
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)pCapt->state);
+            break;
+        }
+
+        case captureCmdRead:
+        {
+            //read as many bytes from the given offset as fit in the reply
+            if (pDebug->_msgReceived.nCmdParamSize < 5)
+            {
+                return;
+            }
+            memcpy((uint8_t*)(&uValue), &rgParam[1], 4);
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uValue), 4);
+            uSize = DebugCapt_Read(pCapt, uValue, &pMsgReply->rgMessage[pMsgReply->_uIndexMessage], DEBUG_MSG_SIZE - 3 - pMsgReply->_uIndexMessage);
+            pMsgReply->_uIndexMessage += uSize;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+#endif
+
+
+#if DEBUG_MEMORY_TRANSFER > 0
+void CmdMemory(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugMemory* pMem;
+    SDebugChannel debugChannel;
+    uint8_t* rgParam;
+    uint32_t uPosition;
+    uint32_t uSize;
+    EMemoryResult result;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without sub-command
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+
+    //get access to the transfer and the parameters (increase readability)
+    pMem = &pDebug->_memory;
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+
+    //add sub-command to reply
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+
+    switch ((EMemoryCmd)rgParam[0])
+    {
+        case memoryCmdRead:
+        case memoryCmdWrite:
+        {
+            //param: offset (4 bytes), control-byte, position (4 bytes), size (4 bytes)
+            result = memoryInvalid;
+            if (pDebug->_msgReceived.nCmdParamSize >= 14)
+            {
+                //the block starts at a register-address, resolved once like a register (incl. its pointer-chain)
+                DbgChan_Init(&debugChannel);
+                memcpy((uint8_t*)&debugChannel._uOffset, &rgParam[1], 4);
+                debugChannel._uCtrl = rgParam[5];
+                debugChannel.uPointerDepth = debugChannel._uCtrl & 0x0F;
+                debugChannel.uSize_bytes = 1;
+                debugChannel.fResolveOnce = true;
+                pDebug->pGetRegisterAddress(&debugChannel);
+                DbgChan_Resolve(&debugChannel);
+                memcpy((uint8_t*)&uPosition, &rgParam[6], 4);
+                memcpy((uint8_t*)&uSize, &rgParam[10], 4);
+#if DEBUG_STIMULUS_SIZE > 0
+                //the waveform table of the stimulus generator, within its size and not while it is played
+                if ((debugChannel._uCtrl & 0x70) == sourceStimulusTable)
+                {
+                    debugChannel._pValue = ((uPosition <= DEBUG_STIMULUS_SIZE) && (uSize <= DEBUG_STIMULUS_SIZE - uPosition) &&
+                                            ((rgParam[0] == memoryCmdRead) || (DEBUG_LOAD_ACQUIRE(pDebug->_stimulus.uState) == stimulusIdle) ||
+                                             (DEBUG_LOAD_ACQUIRE(pDebug->_stimulus.uState) == stimulusDone))) ? pDebug->_stimulus.rgTable : NULL;
+                }
+#endif
+
+                if ((debugChannel._pValue != NULL) && (uSize > 0))
+                {
+                    if (rgParam[0] == memoryCmdRead)
+                    {
+                        DebugMem_StartRead(pMem, (uint8_t*)debugChannel._pValue + uPosition, uSize);
+                    }
+                    else
+                    {
+                        DebugMem_StartWrite(pMem, (uint8_t*)debugChannel._pValue + uPosition, uSize);
+                    }
+                    result = memoryOk;
+                }
+            }
+
+            //add result and fragment-size to reply, the fragments of a read follow from DebugProt_DoMain()
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)result);
+            DebugMsgOut_AddByte(pMsgReply, (DEBUG_MEMORY_FRAGMENT_SIZE >> 0) & 0xFF);
+            DebugMsgOut_AddByte(pMsgReply, (DEBUG_MEMORY_FRAGMENT_SIZE >> 8) & 0xFF);
+            break;
+        }
+
+        case memoryCmdWriteData:
+        {
+            //write the fragment, and add the next expected sequence-nr and the result to reply
+            result = DebugMem_WriteFragment(pMem, &rgParam[1], pDebug->_msgReceived.nCmdParamSize - 1);
+            DebugMsgOut_AddByte(pMsgReply, (pMem->_uWriteSequence >> 0) & 0xFF);
+            DebugMsgOut_AddByte(pMsgReply, (pMem->_uWriteSequence >> 8) & 0xFF);
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)result);
+            break;
+        }
+
+        case memoryCmdAbort:
+        {
+            DebugMem_Abort(pMem);
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)memoryOk);
+            break;
+        }
+
+        default:
+        {
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)memoryInvalid);
+            break;
+        }
+    }
+}
+
+
+void SendMemoryFragments(SDebugProtocol* pDebug)
+{
+    SDebugMessageOut msgOut;
+    uint32_t uSize;
+    uint32_t uCount;
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+    //queue as many fragments as there are transmit-buffers, a fragment that can't be queued is built again next time
+    uCount = DEBUG_TX_BUFFER_COUNT;
+#else
+    //written immediately, so 1 fragment per call to keep DebugProt_DoMain() short
+    uCount = 1;
+#endif
+
+    for (; uCount > 0; --uCount)
+    {
+        DebugMsgOut_Init(&msgOut);
+        msgOut.uNodeID = pDebug->uNodeID;
+        msgOut.uMsgID = 0;
+        msgOut.cmd = cmdMemory;
+        DebugMsgOut_AddByte(&msgOut, memoryCmdData);
+        uSize = DebugMem_GetReadFragment(&pDebug->_memory, &msgOut.rgMessage[msgOut._uIndexMessage]);
+        if (uSize == 0)
+        {
+            return;
+        }
+        msgOut._uIndexMessage += uSize;
+        if (!SendMessage(pDebug, &msgOut, txPrioChannel))
+        {
+            return;
+        }
+        DebugMem_NextReadFragment(&pDebug->_memory);
+    }
+}
+#endif
+
+
+#if DEBUG_STATS > 0
+void CmdStats(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugStats* pStats;
+    SDebugStatsPhase* pPhase;
+    uint32_t rgValue[4];
+    uint32_t uOverrunCount;
+    int32_t i;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without sub-command
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+
+    pStats = &pDebug->_stats;
+    uOverrunCount = DEBUG_LOAD_ACQUIRE(pDebug->_msgReceived.uOverrunCount);
+
+    //add sub-command to reply
+    DebugMsgOut_AddByte(pMsgReply, pDebug->_msgReceived.rgMessage[3]);
+
+    switch ((EStatsCmd)pDebug->_msgReceived.rgMessage[3])
+    {
+        case statsCmdRead:
+        {
+            //add the cycle-frequency and the nbr of phases, then count, min, max and avg cycles per phase
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pStats->uCycles_Hz), 4);
+            DebugMsgOut_AddByte(pMsgReply, statsPhaseCount);
+            for (i = 0; i < statsPhaseCount; ++i)
+            {
+                pPhase = &pStats->rgPhase[i];
+                rgValue[0] = pPhase->uCount;
+                rgValue[1] = (pPhase->uCount > 0) ? pPhase->uMin_cycles : 0;
+                rgValue[2] = pPhase->uMax_cycles;
+                rgValue[3] = (pPhase->uCount > 0) ? (uint32_t)(pPhase->uSum_cycles / pPhase->uCount) : 0;
+                DebugMsgOut_AddData(pMsgReply, (uint8_t*)rgValue, sizeof(rgValue));
+            }
+
+            //add the byte- and drop-counters (the receive-overruns are counted by the receive buffer)
+            rgValue[0] = pStats->uRxBytes;
+            rgValue[1] = uOverrunCount - pStats->_uRxOverrunBase;
+            rgValue[2] = pStats->uTxBytes;
+            rgValue[3] = pStats->uTxDropped;
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)rgValue, sizeof(rgValue));
+
+            //add the messages that the decoder discarded
+            rgValue[0] = pDebug->_msgReceived.uFramingErrorCount - pStats->_uFramingErrorBase;
+            rgValue[1] = pDebug->_msgReceived.uCrcErrorCount - pStats->_uCrcErrorBase;
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)rgValue, 2 * sizeof(rgValue[0]));
+            break;
+        }
+
+        case statsCmdReset:
+        {
+            DebugStats_Reset(pStats);
+            pStats->_uRxOverrunBase = uOverrunCount;
+            pStats->_uFramingErrorBase = pDebug->_msgReceived.uFramingErrorCount;
+            pStats->_uCrcErrorBase = pDebug->_msgReceived.uCrcErrorCount;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+#endif
+
+
+#if DEBUG_SCHEDULE_COUNT > 0
+void CmdSchedule(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugScheduleGroup* pGroup;
+    SDebugChannel debugChannel;
+    EScheduleResult result;
+    uint8_t* rgParam;
+    uint32_t uTime_tick;
+    uint32_t uNow_tick;
+    uint8_t uCount;
+    int32_t nPos;
+    int32_t i;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without sub-command
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+    uNow_tick = pDebug->uTimeDebug_tick;
+
+    //add sub-command to reply, the other sub-commands have a group-nr
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+    if (((EScheduleCmd)rgParam[0] != scheduleCmdStatus) && (pDebug->_msgReceived.nCmdParamSize < 2))
+    {
+        DebugMsgOut_AddByte(pMsgReply, 0);
+        DebugMsgOut_AddByte(pMsgReply, scheduleInvalid);
+        return;
+    }
+
+    switch ((EScheduleCmd)rgParam[0])
+    {
+        case scheduleCmdStatus:
+        {
+            //add the current tick, free writes and the state, tick and nbr of writes of each group
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uNow_tick), 4);
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)DebugSched_FreeCount(&pDebug->_schedule));
+            DebugMsgOut_AddByte(pMsgReply, DEBUG_SCHEDULE_GROUPS);
+            for (i = 0; i < DEBUG_SCHEDULE_GROUPS; ++i)
+            {
+                pGroup = &pDebug->_schedule._rgGroup[i];
+                DebugMsgOut_AddByte(pMsgReply, (uint8_t)DEBUG_LOAD_ACQUIRE(pGroup->uState));
+                DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pGroup->uTime_tick), 4);
+                DebugMsgOut_AddByte(pMsgReply, pGroup->uCount);
+            }
+            break;
+        }
+
+        case scheduleCmdAdd:
+        {
+            //param: group, per write offset (4 bytes), control-byte, size, value (size bytes)
+            result = scheduleOk;
+            uCount = 0;
+            for (nPos = 2; nPos + 6 <= pDebug->_msgReceived.nCmdParamSize; nPos += 6 + debugChannel.uSize_bytes)
+            {
+                InitRegister(pDebug, &debugChannel, &rgParam[nPos]);
+                if (nPos + 6 + debugChannel.uSize_bytes > pDebug->_msgReceived.nCmdParamSize)
+                {
+                    result = scheduleInvalid;
+                    break;
+                }
+                result = DebugSched_Add(&pDebug->_schedule, rgParam[1], &debugChannel, &rgParam[nPos + 6]);
+                if (result != scheduleOk)
+                {
+                    break;
+                }
+                ++uCount;
+            }
+
+            //a failed add discards the group until it is cancelled, so a commit never arms half a step
+            if (result != scheduleOk)
+            {
+                DebugSched_Fail(&pDebug->_schedule, rgParam[1]);
+            }
+            DebugMsgOut_AddByte(pMsgReply, rgParam[1]);
+            DebugMsgOut_AddByte(pMsgReply, result);
+            DebugMsgOut_AddByte(pMsgReply, uCount);
+            break;
+        }
+
+        case scheduleCmdCommit:
+        {
+            //param: group, tick (4 bytes)
+            result = scheduleInvalid;
+            if (pDebug->_msgReceived.nCmdParamSize >= 6)
+            {
+                memcpy((uint8_t*)&uTime_tick, &rgParam[2], 4);
+                result = DebugSched_Commit(&pDebug->_schedule, rgParam[1], uTime_tick, uNow_tick);
+            }
+            DebugMsgOut_AddByte(pMsgReply, rgParam[1]);
+            DebugMsgOut_AddByte(pMsgReply, result);
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uNow_tick), 4);
+            break;
+        }
+
+        case scheduleCmdCancel:
+        {
+            DebugMsgOut_AddByte(pMsgReply, rgParam[1]);
+            DebugMsgOut_AddByte(pMsgReply, DebugSched_Cancel(&pDebug->_schedule, rgParam[1]));
+            break;
+        }
+
+        default:
+        {
+            DebugMsgOut_AddByte(pMsgReply, rgParam[1]);
+            DebugMsgOut_AddByte(pMsgReply, scheduleInvalid);
+            break;
+        }
+    }
+}
+#endif
+
+
+#if DEBUG_STIMULUS_SIZE > 0
+void CmdStimulus(SDebugProtocol* pDebug, SDebugMessageOut* pMsgReply)
+{
+    SDebugStimulus* pStim;
+    SDebugChannel debugChannel;
+    EStimulusResult result;
+    uint8_t* rgParam;
+    uint32_t uTime_tick;
+    uint32_t uNow_tick;
+    uint32_t uTableSize;
+
+    //check for valid pointers
+    ASSERT(pMsgReply != NULL);
+
+    //ignore messages without sub-command
+    if (pDebug->_msgReceived.nCmdParamSize < 1)
+    {
+        return;
+    }
+    rgParam = &pDebug->_msgReceived.rgMessage[3];
+    uNow_tick = pDebug->uTimeDebug_tick;
+    pStim = &pDebug->_stimulus;
+
+    //add sub-command to reply
+    DebugMsgOut_AddByte(pMsgReply, rgParam[0]);
+
+    switch ((EStimulusCmd)rgParam[0])
+    {
+        case stimulusCmdStatus:
+        {
+            //add the state, the tick of the first sample, the played samples and the size of the table
+            uTableSize = DEBUG_STIMULUS_SIZE;
+            DebugMsgOut_AddByte(pMsgReply, (uint8_t)DEBUG_LOAD_ACQUIRE(pStim->uState));
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pStim->uStart_tick), 4);
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&pStim->uPlayed), 4);
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uTableSize), 4);
+            break;
+        }
+
+        case stimulusCmdConfig:
+        {
+            //param: waveform, offset (4 bytes), control-byte, size, format, waveform-parameters (26 bytes)
+            result = stimulusInvalid;
+            if (pDebug->_msgReceived.nCmdParamSize >= 35)
+            {
+                InitRegister(pDebug, &debugChannel, &rgParam[2]);
+                result = DebugStim_Config(pStim, (EStimulusWave)rgParam[1], &debugChannel, (EChannelFormat)rgParam[8], &rgParam[9]);
+            }
+            DebugMsgOut_AddByte(pMsgReply, result);
+            break;
+        }
+
+        case stimulusCmdStart:
+        {
+            //param: tick of the first sample (4 bytes), the next tick when omitted
+            uTime_tick = uNow_tick + 1;
+            if (pDebug->_msgReceived.nCmdParamSize >= 5)
+            {
+                memcpy((uint8_t*)&uTime_tick, &rgParam[1], 4);
+            }
+            DebugMsgOut_AddByte(pMsgReply, DebugStim_Start(pStim, uTime_tick));
+            DebugMsgOut_AddData(pMsgReply, (uint8_t*)(&uNow_tick), 4);
+            break;
+        }
+
+        case stimulusCmdStop:
+        {
+            DebugStim_Stop(pStim);
+            DebugMsgOut_AddByte(pMsgReply, stimulusOk);
+            break;
+        }
+
+        default:
+        {
+            DebugMsgOut_AddByte(pMsgReply, stimulusInvalid);
+            break;
+        }
+    }
+}
+#endif
+
+
+void SendChannelTick(SDebugProtocol* pDebug, uint64_t uTime_tick, const uint8_t* pSample)
+{
+    uint32_t uStart_cycles;
+    bool fSlowUpdate;
+
+    uStart_cycles = DEBUG_STATS_START(&pDebug->_stats);
+
+    //all messages of this tick carry the same timestamp
+    pDebug->_uTimeChannel_tick = uTime_tick;
+
+#if DEBUG_SNAPSHOT > 0
+    //sample all channels as one set before they are encoded (a queued sample was taken as a set already)
+    if ((pSample == NULL) && ((pDebug->_snapshot.pLock != NULL) || (pDebug->_snapshot.pShadow != NULL)))
+    {
+        DebugSample_Take(pDebug->_rgRegisterRead, &pDebug->_snapshot, pDebug->_rgSnapshot);
+        pSample = pDebug->_rgSnapshot;
+    }
+#endif
+
+    //check if we also need to send slow-update channel-data
+    fSlowUpdate = ((uint32_t)uTime_tick - pDebug->_uTimeDebugPrevSlow_tick >= pDebug->_uSlowUpdate_tick);
+    SendChannelData(pDebug, fSlowUpdate, pSample);
+    pDebug->_uTimeDebugPrevFast_tick = (uint32_t)uTime_tick;
+    if (fSlowUpdate)
+    {
+        pDebug->_uTimeDebugPrevSlow_tick = (uint32_t)uTime_tick;
+    }
+
+    //reset the tracing-once mode
+    pDebug->fChannelTracingOnce = false;
+    DEBUG_STATS_STOP(&pDebug->_stats, statsChannelData, uStart_cycles);
+}
+
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+void SendSampledChannelData(SDebugProtocol* pDebug, uint32_t uTime_tick)
+{
+    const uint8_t* pSample;
+    uint32_t uSample_tick;
+    uint32_t uDroppedCount;
+
+    //report samples that didn't fit in the queue (once per occurrence, like a receive-buffer overrun)
+    uDroppedCount = DEBUG_LOAD_ACQUIRE(pDebug->_sampleQueue.uDroppedCount);
+    if (uDroppedCount != pDebug->_uSampleDropReported)
+    {
+        pDebug->_uSampleDropReported = uDroppedCount;
+        SendString(pDebug, "Debug: sample queue overrun\r\n");
+    }
+
+    //send every sampled tick with the timestamp of its sample (extended to 64 bits relative to the current debug-time),
+    //while there is room to send it. Samples that were taken just before tracing was switched off are discarded
+    while (CanSendChannelData(pDebug) && ((pSample = DebugSample_Front(&pDebug->_sampleQueue, &uSample_tick)) != NULL))
+    {
+        if (pDebug->fChannelTracingOn || pDebug->fChannelTracingOnce)
+        {
+            SendChannelTick(pDebug, ((((uint64_t)pDebug->_uTimeDebugEpoch << 32) | uTime_tick) - (uint32_t)(uTime_tick - uSample_tick)),
+                            pSample);
+        }
+        DebugSample_Pop(&pDebug->_sampleQueue);
+    }
+}
+#endif
+
+
+void SendChannelData(SDebugProtocol* pDebug, bool fSlowUpdate, const uint8_t* pSample)
+{
+    int32_t i;
+    SDebugChannel* pDbgChan;
+    SDebugMessageOut msgOut;
+    SDebugMessageOut* pMsg;
+    uint8_t rgValue[8 * DEBUG_AGGREGATE_VALUES];
+    uint8_t rgNewDataMask[DEBUG_CHANNEL_MASK_SIZE];
+    uint32_t uMaskIndex;
+    uint32_t uRecordIndex;
+    uint32_t uRecords;
+    uint32_t uFrameTicks;
+    bool fNewData;
+    bool fAdded;
+    bool fNeedUpdate;
+    bool fForceUpdate;
+    bool fChanged;
+    bool fKeyFrame;
+    bool fFrameKeyFrame;
+    bool fTickData;
+    bool fAllGroups;
+    bool fSent;
+    uint32_t uGroupsDue;
+    uint8_t rgEncoded[DEBUG_VARINT_SIZE_MAX * DEBUG_AGGREGATE_VALUES];
+    uint8_t uEncodedSize;
+    const uint8_t* pSampleValue;
+    const uint8_t* pChannelSample;
+
+    //check for valid pointers
+    ASSERT(pDebug->pWriteData != NULL);
+
+    //the values of a sampled tick follow its channel-mask, with room for every active channel
+    pSampleValue = (pSample != NULL) ? &pSample[DEBUG_CHANNEL_MASK_SIZE] : NULL;
+    pChannelSample = NULL;
+
+    //compact channel-data sends a key-frame when requested, and with every slow update to recover from lost frames.
+    //Channels that are only sent now and then (slow, once) are always part of a key-frame
+#if DEBUG_CHANNEL_COMPACT > 0
+    fKeyFrame = pDebug->_fCompactKeyFrame || fSlowUpdate || pDebug->fChannelTracingOnce;
+#else
+    fKeyFrame = true;
+#endif
+    fSent = true;
+
+    //advance the rate-groups and collect the groups that are due this tick. A compact key-frame holds every group,
+    //otherwise the host would keep a stale reference for the groups that are not due
+    uGroupsDue = 0;
+    for (i = 0; i < DEBUG_RATE_GROUP_COUNT; ++i)
+    {
+        if (pDebug->_rguRateCount[i] == 0)
+        {
+            uGroupsDue |= (uint32_t)0x01 << i;
+            pDebug->_rguRateCount[i] = pDebug->rguRateDecimation[i];
+        }
+        --pDebug->_rguRateCount[i];
+    }
+#if DEBUG_CHANNEL_COMPACT > 0
+    fAllGroups = fKeyFrame && pDebug->fChannelCompact;
+#else
+    fAllGroups = false;
+#endif
+
+    //every tick is a record (timestamp, mask and values) in a frame, which is sent at the end of the tick, or when
+    //batching, when it holds uBatchTicks records
+    pMsg = &msgOut;
+    uRecords = 0;
+    uFrameTicks = 1;
+    fFrameKeyFrame = fKeyFrame;
+#if DEBUG_CHANNEL_BATCH > 0
+    //only the first record of a frame can be a key-frame, so a key-frame (or leaving the batch mode) sends the batch
+    if ((fKeyFrame || !pDebug->fChannelCompact || (pDebug->uBatchTicks <= 1)) && (pDebug->_uBatchCount > 0))
+    {
+        fSent &= FlushChannelBatch(pDebug);
+    }
+    if (pDebug->fChannelCompact && (pDebug->uBatchTicks > 1))
+    {
+        pMsg = &pDebug->_msgBatch;
+        uRecords = pDebug->_uBatchCount;
+        uFrameTicks = pDebug->uBatchTicks;
+        fFrameKeyFrame = pDebug->_fBatchKeyFrame;
+    }
+#endif
+
+    //append the record of this tick to the batch, or start a new frame with it
+    uMaskIndex = 0;
+    if (uRecords > 0)
+    {
+        uRecordIndex = pMsg->_uIndexMessage;
+        uMaskIndex = AddChannelRecord(pDebug, pMsg, rgNewDataMask, false);
+        if (uMaskIndex == 0)
+        {
+            fSent &= SendChannelFrame(pDebug, pMsg, fFrameKeyFrame, false);
+            uRecords = 0;
+        }
+    }
+    if (uRecords == 0)
+    {
+        InitChannelFrame(pDebug, pMsg);
+        uRecordIndex = pMsg->_uIndexMessage;
+        uMaskIndex = AddChannelRecord(pDebug, pMsg, rgNewDataMask, fKeyFrame);
+        fFrameKeyFrame = fKeyFrame;
+    }
+    fNewData = false;
+    fTickData = false;
+
+    //add values
+    for (i = DEBUG_CHANNEL_COUNT - 1; i >= 0; --i)
+    {
+        //get access to the debug-channel (increase readability), skip channels that are off without sampling them
+        pDbgChan = &pDebug->_rgRegisterRead[i];
+        if ((pSampleValue != NULL) && (pDbgChan->updateMode != updateOff) && (pDbgChan->uSize_bytes <= 8))
+        {
+            pChannelSample = ((pSample[i >> 3] & (0x01 << (i & 0x07))) != 0) ? pSampleValue : NULL;
+            pSampleValue += DbgChan_SampleSize(pDbgChan);
+        }
+        if (pDbgChan->updateMode == updateOff)
+        {
+            continue;
+        }
+        //fast channels (changed or all) are only sampled when their rate-group is due
+        if (((pDbgChan->updateMode == updateFast) || (pDbgChan->updateMode == updateAll)) &&
+            ((uGroupsDue & ((uint32_t)0x01 << pDbgChan->uRateGroup)) == 0) && !fAllGroups)
+        {
+            continue;
+        }
+        //check if we need to send data for this channel
+        fNeedUpdate   = (pDbgChan->updateMode == updateFast);
+
+
+        // the force update flag will always send an update
+        fForceUpdate  = (pDbgChan->updateMode == updateAll );
+        fForceUpdate |= (pDbgChan->updateMode == updateSlow) && (fSlowUpdate == true);
+        fForceUpdate |= (pDbgChan->updateMode == updateOnce) && (pDebug->fChannelTracingOnce == true);
+#if DEBUG_CHANNEL_COMPACT > 0
+        //a key-frame holds every fast channel, so the host has a reference for all of them again
+        fForceUpdate |= (pDbgChan->updateMode == updateFast) && fKeyFrame && pDebug->fChannelCompact;
+#endif
+//         //reset updateOnce flag if necessary
+//         if (pDbgChan->updateMode == updateOnce)
+//         {
+//             pDbgChan->updateMode = updateOff;
+//         }
+#if DEBUG_CHANNEL_AGGREGATE > 0
+        //an aggregated channel sends its window (min, max and mean) every time it is due, unless it is empty. The window
+        //is only taken then, so it holds every tick since the channel was sent last
+        if (pDbgChan->fAggregate)
+        {
+            fNeedUpdate |= fForceUpdate;
+            fForceUpdate = false;
+            if (pSample != NULL)
+            {
+                fChanged = (pChannelSample != NULL);
+                if (fChanged)
+                {
+                    memcpy(rgValue, pChannelSample, DbgChan_SampleSize(pDbgChan));
+                }
+            }
+            else
+            {
+                fChanged = fNeedUpdate && DbgChan_TakeWindow(pDbgChan, rgValue);
+            }
+        }
+        else
+#endif
+        //if we need to update, check if the value-data has changed. In case of a force update always send a new value
+        if (pSample != NULL)
+        {
+            fChanged = (pChannelSample != NULL) && DbgChan_ReadSample(pDbgChan, pChannelSample, rgValue);
+        }
+        else
+        {
+            fChanged = DbgChan_ReadValue(pDbgChan, rgValue);
+        }
+        if ( (fNeedUpdate && fChanged) ||
+              fForceUpdate
+            )
+        {
+#if DEBUG_CHANNEL_COMPACT > 0
+            //encode the value relative to the last sent value (this also makes it the new reference)
+            if (pDebug->fChannelCompact)
+            {
+                uEncodedSize = DbgChan_EncodeCompact(pDbgChan, rgValue, fKeyFrame, rgEncoded);
+#if DEBUG_CHANNEL_AGGREGATE > 0
+                //the max is relative to the min, and the mean to the max (the reference for the next min)
+                if (pDbgChan->fAggregate)
+                {
+                    uEncodedSize += DbgChan_EncodeCompact(pDbgChan, &rgValue[pDbgChan->uSize_bytes], fKeyFrame, &rgEncoded[uEncodedSize]);
+                    uEncodedSize += DbgChan_EncodeCompact(pDbgChan, &rgValue[2 * pDbgChan->uSize_bytes], fKeyFrame, &rgEncoded[uEncodedSize]);
+                }
+#endif
+            }
+            else
+#endif
+            {
+                uEncodedSize = DbgChan_SampleSize(pDbgChan);
+                memcpy(rgEncoded, rgValue, uEncodedSize);
+            }
+            //add the value to the message, when the message is full send it and continue in a new one
+            fAdded = DebugMsgOut_AddData(pMsg, rgEncoded, uEncodedSize);
+            if (!fAdded && (fNewData || (uRecords > 0)))
+            {
+                //close the record of this tick (continued in the new frame with the same timestamp), or drop it
+                //while it is still empty
+                if (fNewData)
+                {
+                    CloseChannelRecord(pDebug, pMsg, uMaskIndex, rgNewDataMask);
+                }
+                else
+                {
+                    pMsg->_uIndexMessage = uRecordIndex;
+                }
+                fSent &= SendChannelFrame(pDebug, pMsg, fFrameKeyFrame, fNewData);
+                InitChannelFrame(pDebug, pMsg);
+                uRecordIndex = pMsg->_uIndexMessage;
+                uMaskIndex = AddChannelRecord(pDebug, pMsg, rgNewDataMask, fKeyFrame);
+                fFrameKeyFrame = fKeyFrame;
+                uRecords = 0;
+                fNewData = false;
+                fAdded = DebugMsgOut_AddData(pMsg, rgEncoded, uEncodedSize);
+            }
+
+            //set the bit in the mask (only when the value is in the message)
+            if (fAdded)
+            {
+                rgNewDataMask[i >> 3] |= (uint8_t)(0x01 << (i & 0x07));
+                fNewData = true;
+                fTickData = true;
+            }
+        }
+    }
+
+    //close the record if it is not empty (an empty record is removed from the frame again)
+    if (fNewData)
+    {
+        CloseChannelRecord(pDebug, pMsg, uMaskIndex, rgNewDataMask);
+        ++uRecords;
+    }
+    else
+    {
+        pMsg->_uIndexMessage = uRecordIndex;
+    }
+
+    //send the frame, unless it collects more ticks
+    if ((uRecords > 0) && (uRecords >= uFrameTicks))
+    {
+        fSent &= SendChannelFrame(pDebug, pMsg, fFrameKeyFrame, false);
+        uRecords = 0;
+    }
+#if DEBUG_CHANNEL_BATCH > 0
+    if (pMsg == &pDebug->_msgBatch)
+    {
+        //the latency of a batch counts from its first record
+        if ((uRecords == 1) && fNewData)
+        {
+            pDebug->_uBatchStart_tick = (uint32_t)pDebug->_uTimeChannel_tick;
+        }
+        pDebug->_uBatchCount = (uint8_t)uRecords;
+        pDebug->_fBatchKeyFrame = fFrameKeyFrame;
+    }
+#endif
+
+#if DEBUG_CHANNEL_COMPACT > 0
+    //a dropped frame breaks the chain of relative values, so start over with a key-frame
+    if (pDebug->fChannelCompact && (fTickData || !fSent))
+    {
+        pDebug->_fCompactKeyFrame = !fSent;
+    }
+#else
+    (void)fSent;
+    (void)fTickData;
+#endif
+}
+
+
+void InitChannelFrame(SDebugProtocol* pDebug, SDebugMessageOut* pMsg)
+{
+    //create new message
+    DebugMsgOut_Init(pMsg);
+    pMsg->uNodeID = pDebug->uNodeID;
+    pMsg->uMsgID = 0;
+    pMsg->cmd = cmdReadChannelData;
+
+#if DEBUG_CHANNEL_COMPACT > 0
+    if (pDebug->fChannelCompact)
+    {
+        //flags (set when sending)
+        pMsg->cmd = cmdCompactData;
+        DebugMsgOut_AddByte(pMsg, 0);
+    }
+#endif
+}
+
+
+uint32_t AddChannelRecord(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, uint8_t* rgNewDataMask, bool fKeyFrame)
+{
+    uint8_t rgTime[DEBUG_TIMESTAMP_SIZE];
+    uint8_t uTimeSize;
+    int32_t i;
+#if DEBUG_CHANNEL_COMPACT > 0
+    uint8_t rgVarint[DEBUG_VARINT_SIZE_MAX];
+#endif
+
+#if DEBUG_CHANNEL_COMPACT > 0
+    if (pMsg->cmd == cmdCompactData)
+    {
+        //the absolute 64 bits time (key-frame) or the time since the previous record
+        if (fKeyFrame)
+        {
+            uTimeSize = DbgChan_EncodeVarint(pDebug->_uTimeChannel_tick, rgVarint);
+        }
+        else
+        {
+            uTimeSize = DbgChan_EncodeVarint((uint32_t)pDebug->_uTimeChannel_tick - pDebug->_uTimeCompact_tick, rgVarint);
+        }
+        if (pMsg->_uIndexMessage + uTimeSize + DEBUG_CHANNEL_MASK_SIZE > DEBUG_MSG_SIZE - 3)
+        {
+            return 0;
+        }
+        DebugMsgOut_AddData(pMsg, rgVarint, uTimeSize);
+    }
+    else
+#endif
+    {
+        //create timestamp
+        (void)fKeyFrame;
+        (void)uTimeSize;
+        for (i = 0; i < DEBUG_TIMESTAMP_SIZE; ++i)
+        {
+            rgTime[i] = (pDebug->_uTimeChannel_tick >> (8 * i)) & 0xFF;
+        }
+        DebugMsgOut_AddData(pMsg, rgTime, DEBUG_TIMESTAMP_SIZE);
+    }
+
+    //reserve room for the mask, return its index in the message
+    memset(rgNewDataMask, 0, DEBUG_CHANNEL_MASK_SIZE);
+    DebugMsgOut_AddData(pMsg, rgNewDataMask, DEBUG_CHANNEL_MASK_SIZE);
+    return pMsg->_uIndexMessage - DEBUG_CHANNEL_MASK_SIZE;
+}
+
+
+void CloseChannelRecord(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, uint32_t uMaskIndex, uint8_t* rgNewDataMask)
+{
+    //insert the channel-mask at the proper location in the message
+    memcpy(&pMsg->rgMessage[uMaskIndex], rgNewDataMask, DEBUG_CHANNEL_MASK_SIZE);
+
+#if DEBUG_CHANNEL_COMPACT > 0
+    //the time of the next record is relative to this one
+    pDebug->_uTimeCompact_tick = (uint32_t)pDebug->_uTimeChannel_tick;
+#else
+    (void)pDebug;
+#endif
+}
+
+
+bool SendChannelFrame(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, bool fKeyFrame, bool fContinued)
+{
+#if DEBUG_CHANNEL_COMPACT > 0
+    if (pMsg->cmd == cmdCompactData)
+    {
+        //the flags-byte carries key-frame, continuation and the sequence-nr (a dropped frame still uses its nr)
+        pMsg->rgMessage[3] = (uint8_t)((fKeyFrame ? DEBUG_COMPACT_KEYFRAME : 0) |
+                                       (fContinued ? DEBUG_COMPACT_CONTINUED : 0) |
+                                       (pDebug->_uCompactSequence & DEBUG_COMPACT_SEQUENCE_MASK));
+        pDebug->_uCompactSequence++;
+    }
+    else
+#endif
+    {
+        //mark frames that are followed by more frames of the same tick
+        (void)fKeyFrame;
+        pMsg->uMsgID = (fContinued && DEBUG_CHANNEL_CONTINUATION) ? 1 : 0;
+    }
+
+    //send the new message over the debug-protocol
+    return SendMessage(pDebug, pMsg, txPrioChannel);
+}
+
+
+#if DEBUG_CHANNEL_BATCH > 0
+bool FlushChannelBatch(SDebugProtocol* pDebug)
+{
+    bool fSent = true;
+
+    //send the ticks that are collected so far, a dropped batch is followed by a key-frame
+    if (pDebug->_uBatchCount > 0)
+    {
+        fSent = SendChannelFrame(pDebug, &pDebug->_msgBatch, pDebug->_fBatchKeyFrame, false);
+        pDebug->_uBatchCount = 0;
+        if (!fSent)
+        {
+            pDebug->_fCompactKeyFrame = true;
+        }
+    }
+
+    return fSent;
+}
+#endif
+
+
+bool CanReply(SDebugProtocol* pDebug)
+{
+#if DEBUG_TX_BUFFER_COUNT > 0
+    //received messages stay buffered while no reply fits
+    return DebugTx_Available(&pDebug->_tx) > 0;
+#else
+    (void)pDebug;
+    return true;
+#endif
+}
+
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+bool CanSendChannelData(SDebugProtocol* pDebug)
+{
+#if DEBUG_TX_BUFFER_COUNT > 1
+    //sampled ticks stay queued while no channel-data fits (it leaves one buffer for replies and traces)
+    return DebugTx_Available(&pDebug->_tx) > 1;
+#else
+    return CanReply(pDebug);
+#endif
+}
+#endif
+
+
+bool DecodeMessage(SDebugProtocol* pDebug)
+{
+    uint32_t uStart_cycles;
+    bool fComplete;
+
+    uStart_cycles = DEBUG_STATS_START(&pDebug->_stats);
+    fComplete = DebugMsgIn_DecodeAndCheck(&pDebug->_msgReceived);
+    DEBUG_STATS_STOP(&pDebug->_stats, statsDecode, uStart_cycles);
+
+    return fComplete;
+}
+
+
+bool SendMessage(SDebugProtocol* pDebug, SDebugMessageOut* pMsg, EDebugTxPriority ePriority)
+{
+    uint32_t uStart_cycles;
+    uint32_t uSize;
+#if DEBUG_TX_BUFFER_COUNT > 0
+    uint8_t* pRawMsgData;
+
+    //encode the message directly into a transmit buffer of its priority (dropped when no buffer is available)
+    pRawMsgData = DebugTx_Reserve(&pDebug->_tx, ePriority);
+    if (pRawMsgData == NULL)
+    {
+#if DEBUG_STATS > 0
+        ++pDebug->_stats.uTxDropped;
+#endif
+        return false;
+    }
+    uStart_cycles = DEBUG_STATS_START(&pDebug->_stats);
+    uSize = DebugMsgOut_Encode(pMsg, pRawMsgData);
+    DEBUG_STATS_STOP(&pDebug->_stats, statsEncode, uStart_cycles);
+    DebugTx_Commit(&pDebug->_tx, pRawMsgData, uSize);
+#else
+    uint8_t rgRawMsgData[DEBUG_MSG_RAW_SIZE];
+
+    //without TX engine, messages are written immediately (in order of sending)
+    (void)ePriority;
+
+    //check for valid pointers
+    ASSERT(pDebug->pWriteData != NULL);
+
+    //encode the message, and send it over the debug-protocol
+    uStart_cycles = DEBUG_STATS_START(&pDebug->_stats);
+    uSize = DebugMsgOut_Encode(pMsg, rgRawMsgData);
+    DEBUG_STATS_STOP(&pDebug->_stats, statsEncode, uStart_cycles);
+    pDebug->pWriteData(rgRawMsgData, uSize);
+#endif
+#if DEBUG_STATS > 0
+    pDebug->_stats.uTxBytes += uSize;
+#endif
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+//    Debug tools
+//----------------------------------------------------------------------------
+void DebugProt_AssertFail(const char* szAssertion, const char* szFile, const int32_t nLineNr)
+{
+    char szLineNr[5];
+    int32_t nStringPos = 0;
+    const char* rgszString[7];
+    SDebugProtocol* pDebug;
+    int32_t nLine;
+    int32_t i;
+
+    //convert line-nr to string
+    nLine = nLineNr;
+    i = nLine / 1000;
+    nLine -= i * 1000;
+    if (i > 0)
+    {
+        szLineNr[nStringPos++] = i + '0';
+    }
+    i = nLine / 100;
+    nLine -= i * 100;
+    if ((i > 0) || (nStringPos > 0))
+    {
+        szLineNr[nStringPos++] = i + '0';
+    }
+    i = nLine / 10;
+    nLine -= i * 10;
+    if ((i > 0) || (nStringPos > 0))
+    {
+        szLineNr[nStringPos++] = i + '0';
+    }
+    szLineNr[nStringPos++] = nLine + '0';
+    szLineNr[nStringPos++] = '\0';
+
+    //output an assertion debug-string (as a single message)
+    rgszString[0] = "Assert fail: '";
+    rgszString[1] = szAssertion;
+    rgszString[2] = "' (file: ";
+    rgszString[3] = szFile;
+    rgszString[4] = ", line: ";
+    rgszString[5] = szLineNr;
+    rgszString[6] = ")\r\n";
+    for (pDebug = g_pProtDebugFirst; pDebug != NULL; pDebug = pDebug->_pNextInstance)
+    {
+        if (pDebug->fTraceAll)
+        {
+            SendStrings(pDebug, rgszString, 7);
+        }
+    }
+}
+
+
+void DebugProt_Trace(const char* szString)
+{
+    SDebugProtocol* pDebug;
+
+    //send the trace over every instance that wants all traces
+    for (pDebug = g_pProtDebugFirst; pDebug != NULL; pDebug = pDebug->_pNextInstance)
+    {
+        if (pDebug->fTraceAll)
+        {
+            SendString(pDebug, szString);
+        }
+    }
+}
+
+
+void DebugProt_TraceTo(SDebugProtocol* pDebug, const char* szString)
+{
+    //check for valid pointers
+    ASSERT(pDebug != NULL);
+
+    SendString(pDebug, szString);
+}
+
+
+void SendString(SDebugProtocol* pDebug, const char* szString)
+{
+    SendStrings(pDebug, &szString, 1);
+}
+
+
+void SendStrings(SDebugProtocol* pDebug, const char* const* rgszString, uint32_t uCount)
+{
+    SDebugMessageOut msg;
+    uint32_t uSize;
+    uint32_t uFree;
+    uint32_t i;
+
+    //create new message
+    DebugMsgOut_Init(&msg);
+    msg.uNodeID = pDebug->uNodeID;
+    msg.cmd = cmdDebugString;
+
+    //concatenate the strings, truncated when the message is full
+    for (i = 0; i < uCount; ++i)
+    {
+        uSize = strlen(rgszString[i]);
+        uFree = DEBUG_MSG_SIZE - 3 - msg._uIndexMessage;
+        DebugMsgOut_AddData(&msg, (const uint8_t*)rgszString[i], (uSize < uFree) ? uSize : uFree);
+    }
+
+    //send message
+    SendMessage(pDebug, &msg, txPrioTrace);
+}
+
+
+bool DebugProt_GetChar(char* pChar)
+{
+    SDebugProtocol* pDebug;
+
+    //read from the first instance with a char, of the instances that want all traces
+    for (pDebug = g_pProtDebugFirst; pDebug != NULL; pDebug = pDebug->_pNextInstance)
+    {
+        if (pDebug->fTraceAll && DebugProt_GetCharFrom(pDebug, pChar))
+        {
+            return true;
+        }
+    }
+
+    //indicate no char to read
+    return false;
+}
+
+
+bool DebugProt_GetCharFrom(SDebugProtocol* pDebug, char* pChar)
+{
+    //check for valid pointers
+    ASSERT(pDebug != NULL);
+    ASSERT(pChar != NULL);
+
+    //check if we have a char in the buffer that was not read yet
+    if (pDebug->_uIndexPopChar != pDebug->_uIndexPushChar)
+    {
+        //read the char
+        *pChar = pDebug->_rgDebugCharIn[pDebug->_uIndexPopChar];
+
+        //increase read-position of ring-buffer
+        INDEX_INC(pDebug->_uIndexPopChar);
+
+        //indicate we have read a char
+        return true;
+    }
+
+    //indicate no char to read
+    return false;
+}
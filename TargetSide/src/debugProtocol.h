@@ -1,112 +1,265 @@
-/*
-Embedded Debugger system side which can be used to debug embedded systems at a high level.
-Copyright (C) 2019 DEMCON advanced mechatronics B.V.
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <http://www.gnu.org/licenses/>.
-*/
-
-#ifndef DEBUGPROTOCOL_H
-#define DEBUGPROTOCOL_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*******************************************************************
-* Includes
-*******************************************************************/
-#include "debugMessage.h"
-#include "debugChannel.h"
-/*******************************************************************
-* Defines
-*******************************************************************/
-
-#define DEBUG
-#ifdef DEBUG
-    #define GETCHAR(x)          DebugProt_GetChar(x)
-    #define TRACE(x)            DebugProt_Trace(x)
-    #define ASSERT(x)           if (!(x))                                           \
-                                {                                                   \
-                                    DebugProt_AssertFail(#x, __FILE__, __LINE__);   \
-                                }
-    #define NOT_IMPLEMENTED     FALSE
-#else
-    #define GETCHAR(x)          FALSE
-    #define TRACE(x)            ;
-    #define ASSERT(x)           ;
-#endif
-
-
-#define DEBUG_STRING_IN_SIZE_BITS   (8)
-#define DEBUG_STRING_IN_SIZE        (256)   //2^DEBUG_STRING_IN_SIZE_BITS
-
-
-//necessary forward declarations
-typedef struct SAppProtocol SAppProtocol;
-
-extern uint32_t time;
-
-/*******************************************************************
-* Types
-*******************************************************************/
-
-
-typedef bool (*funcGetByte)(uint8_t* data);
-typedef void (*funcWriteData)(uint8_t* data, uint16_t dataSize);
-typedef void (*funcGetRegisterAddress)(SDebugChannel* pChan);
-
-
-typedef struct SDebugProtocol
-{
-    uint8_t                 nDummyForAlignment0;
-    uint8_t                 nDummyForAlignment1;
-    uint16_t                uNodeID;
-    bool                    fChannelTracingOn;
-    bool                    fChannelTracingOnce;
-    uint32_t                uTimeDebug_tick;
-    uint32_t                _uTimeDebugPrevFast_tick;
-    uint32_t                _uTimeDebugPrevSlow_tick;
-    uint32_t                uDecimation;
-    SDebugChannel           _rgRegisterRead[16];
-    SDebugChannel           _rgRegisterWrite[16];
-    SDebugMessageIn         _msgReceived;
-    uint8_t                 _rgVersionApp[4];
-    const char*             _szNodeName;
-    const char*             _szSerialNr;
-    uint8_t                 _rgDebugCharIn[DEBUG_STRING_IN_SIZE];
-    uint32_t                _uIndexPushChar;
-    uint32_t                _uIndexPopChar;
-    uint8_t                 _uData;
-    funcGetByte             pGetByte;
-    funcWriteData           pWriteData;
-    funcGetRegisterAddress  pGetRegisterAddress;
-} SDebugProtocol;
-
-/*******************************************************************
-* Public Function Prototypes
-*******************************************************************/
-void DebugProt_Init(SDebugProtocol* pDebug, const uint8_t* rgVersionApp, const char* szNodeName, const char* szSerialNr, uint32_t uNodeID, funcGetByte pGetByte, funcWriteData pWriteData, funcGetRegisterAddress pGetRegisterAddress);
-void DebugProt_DoMain(SDebugProtocol* pDebug);
-void DebugProt_DoISR(SDebugProtocol* pDebug);
-void DebugProt_AddReceivedData(SDebugProtocol* pDebug, uint8_t* rgData, uint32_t uSize);
-
-void DebugProt_AssertFail(const char* szAssertion, const char* szFile, const int32_t nLineNr);
-void DebugProt_Trace(const char* szString);
-bool DebugProt_GetChar(char* pChar);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif //DEBUGPROTOCOL_H
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGPROTOCOL_H
+#define DEBUGPROTOCOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************
+* Includes
+*******************************************************************/
+#include "debugMessage.h"
+#include "debugChannel.h"
+#include "debugTransmit.h"
+#include "debugCapture.h"
+#include "debugMemory.h"
+#include "debugStats.h"
+#include "debugSample.h"
+#include "debugSchedule.h"
+#include "debugStimulus.h"
+/*******************************************************************
+* Defines
+*******************************************************************/
+
+#define DEBUG
+#ifdef DEBUG
+    #define GETCHAR(x)          DebugProt_GetChar(x)
+    #define TRACE(x)            DebugProt_Trace(x)
+    #define ASSERT(x)           if (!(x))                                           \
+                                {                                                   \
+                                    DebugProt_AssertFail(#x, __FILE__, __LINE__);   \
+                                }
+    #define NOT_IMPLEMENTED     FALSE
+#else
+    #define GETCHAR(x)          FALSE
+    #define TRACE(x)            ;
+    #define ASSERT(x)           ;
+#endif
+
+
+#define DEBUG_STRING_IN_SIZE_BITS   (8)
+#define DEBUG_STRING_IN_SIZE        (256)   //2^DEBUG_STRING_IN_SIZE_BITS
+#define DEBUG_POLL_CHUNK_SIZE       (16)    //nbr of bytes fetched from pGetByte before they are block-copied
+
+//channel-data of a single tick that doesn't fit in one message is split over several messages, each with the same
+//timestamp and its own mask. With the continuation flag, all but the last message of a tick have msg-ID 1
+#ifndef DEBUG_CHANNEL_CONTINUATION
+    #define DEBUG_CHANNEL_CONTINUATION  (1)
+#endif
+
+//nbr of bytes of the timestamp in ReadChannelData (3...8, LSB first). The debug-time is extended to 64 bits in
+//DebugProt_DoMain(), so wider timestamps don't wrap (3 bytes wrap every 4.6 hours at a 1 ms tick)
+#ifndef DEBUG_TIMESTAMP_SIZE
+    #define DEBUG_TIMESTAMP_SIZE        (3)
+#endif
+
+//channels are sampled in rate-groups (max 32): a group is due every rguRateDecimation[group] channel-data ticks (which
+//are uDecimation debug-ticks), so fast and slow signals don't share the same rate. Group 0 is the default group
+#ifndef DEBUG_RATE_GROUP_COUNT
+    #define DEBUG_RATE_GROUP_COUNT      (4)
+#endif
+
+//flags-byte of compact channel-data: a key-frame has an absolute timestamp and raw values, the other frames are
+//relative to the previous frame. The sequence-nr lets the host detect lost frames (it then waits for a key-frame)
+#define DEBUG_COMPACT_KEYFRAME      (0x80)
+#define DEBUG_COMPACT_CONTINUED     (0x40)
+#define DEBUG_COMPACT_SEQUENCE_MASK (0x3F)
+
+//batching collects the compact channel-data of several ticks in one frame, a record (time, mask, values) per tick,
+//which saves the framing of each tick. The host sets the nbr of ticks and the latency. Needs DEBUG_CHANNEL_COMPACT
+#ifndef DEBUG_CHANNEL_BATCH
+    #define DEBUG_CHANNEL_BATCH         (DEBUG_CHANNEL_COMPACT)
+#endif
+#if (DEBUG_CHANNEL_BATCH > 0) && (DEBUG_CHANNEL_COMPACT == 0)
+    #error "DEBUG_CHANNEL_BATCH > 0 requires DEBUG_CHANNEL_COMPACT"
+#endif
+
+//period of the debug-tick (the rate of DebugProt_DoISR or DebugProt_Tick) in us, reported to the host as the unit of
+//the timestamps. DebugProt_SetTickPeriod() changes it at run-time
+#ifndef DEBUG_TICK_US
+    #define DEBUG_TICK_US               (1000)
+#endif
+
+
+//necessary forward declarations
+typedef struct SAppProtocol SAppProtocol;
+
+/*******************************************************************
+* Types
+*******************************************************************/
+
+
+typedef bool (*funcGetByte)(uint8_t* data);
+typedef void (*funcGetRegisterAddress)(SDebugChannel* pChan);
+
+
+//a capability of the debugger (cmdCapabilities), its unique name and the limits that belong to it (LSB first)
+typedef struct SDebugCapability
+{
+    const char*             szName;
+    uint8_t                 uSize;
+    uint8_t                 rgData[4];
+} SDebugCapability;
+
+
+typedef struct SDebugProtocol
+{
+    uint8_t                 nDummyForAlignment0;
+    uint8_t                 nDummyForAlignment1;
+    uint16_t                uNodeID;
+    bool                    fTraceAll;                          //receives DebugProt_Trace(), asserts and DebugProt_GetChar()
+    struct SDebugProtocol*  _pNextInstance;
+    bool                    fChannelTracingOn;
+    bool                    fChannelTracingOnce;
+    uint32_t                uTimeDebug_tick;
+    uint32_t                _uTimeDebugPrevFast_tick;
+    uint32_t                _uTimeDebugPrevSlow_tick;
+    uint32_t                _uTimeDebugLast_tick;
+    uint32_t                _uTimeDebugEpoch;
+    uint64_t                _uTimeChannel_tick;
+    uint32_t                _uTick_us;
+    uint32_t                _uSlowUpdate_tick;
+    uint32_t                uDecimation;
+    uint16_t                rguRateDecimation[DEBUG_RATE_GROUP_COUNT];
+    uint16_t                _rguRateCount[DEBUG_RATE_GROUP_COUNT];
+#if DEBUG_CHANNEL_COMPACT > 0
+    bool                    fChannelCompact;
+    bool                    _fCompactKeyFrame;
+    uint8_t                 _uCompactSequence;
+    uint32_t                _uTimeCompact_tick;
+#endif
+#if DEBUG_CHANNEL_BATCH > 0
+    uint8_t                 uBatchTicks;
+    uint8_t                 _uBatchCount;
+    bool                    _fBatchKeyFrame;
+    uint32_t                uBatchLatency_tick;
+    uint32_t                _uBatchStart_tick;
+    SDebugMessageOut        _msgBatch;
+#endif
+    SDebugChannel           _rgRegisterRead[DEBUG_CHANNEL_COUNT];
+    SDebugChannel           _rgRegisterWrite[16];
+    SDebugMessageIn         _msgReceived;
+    uint32_t                _uOverrunReported;
+    uint8_t                 _rgVersionApp[4];
+    const char*             _szNodeName;
+    const char*             _szSerialNr;
+    uint8_t                 _rgDebugCharIn[DEBUG_STRING_IN_SIZE];
+    uint32_t                _uIndexPushChar;
+    uint32_t                _uIndexPopChar;
+    uint8_t                 _uData;
+    funcGetByte             pGetByte;
+    funcWriteData           pWriteData;
+    funcGetRegisterAddress  pGetRegisterAddress;
+#if DEBUG_TX_BUFFER_COUNT > 0
+    SDebugTransmit          _tx;
+#endif
+#if DEBUG_CAPTURE_SIZE > 0
+    SDebugCapture           _capture;
+#endif
+#if DEBUG_MEMORY_TRANSFER > 0
+    SDebugMemory            _memory;
+#endif
+#if DEBUG_STATS > 0
+    SDebugStats             _stats;
+#endif
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+    ESampleMode             _sampleMode;
+    uint32_t                _uTimeSamplePrev_tick;
+    uint32_t                _uSampleDropReported;
+    SDebugSampleQueue       _sampleQueue;
+#endif
+#if DEBUG_SNAPSHOT > 0
+    SDebugSnapshot          _snapshot;
+    uint8_t                 _rgSnapshot[DEBUG_SAMPLE_SIZE_MAX];
+#endif
+#if DEBUG_SCHEDULE_COUNT > 0
+    SDebugSchedule          _schedule;
+#endif
+#if DEBUG_STIMULUS_SIZE > 0
+    SDebugStimulus          _stimulus;
+#endif
+} SDebugProtocol;
+
+/*******************************************************************
+* Public Function Prototypes
+*******************************************************************/
+void DebugProt_Init(SDebugProtocol* pDebug, const uint8_t* rgVersionApp, const char* szNodeName, const char* szSerialNr, uint32_t uNodeID, funcGetByte pGetByte, funcWriteData pWriteData, funcGetRegisterAddress pGetRegisterAddress);
+void DebugProt_DoMain(SDebugProtocol* pDebug);
+void DebugProt_DoISR(SDebugProtocol* pDebug);
+
+//receive-path, decoupled from the debug-tick: DebugProt_DoISR() equals DebugProt_Tick() + DebugProt_PollReceive().
+//Applications with a DMA or idle-line UART driver call DebugProt_Tick() from the timer and pass complete
+//chunks to DebugProt_AddReceivedData() (pGetByte may then be NULL)
+void DebugProt_Tick(SDebugProtocol* pDebug);
+void DebugProt_PollReceive(SDebugProtocol* pDebug);
+void DebugProt_AddReceivedData(SDebugProtocol* pDebug, uint8_t* rgData, uint32_t uSize);
+
+//set the period of the debug-tick when it differs from DEBUG_TICK_US (call it before the host connects)
+void DebugProt_SetTickPeriod(SDebugProtocol* pDebug, uint32_t uTick_us);
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+//transmit-path with the TX engine: by default, pWriteData is called from DebugProt_DoMain. An asynchronous
+//writer (e.g. a DMA transfer) returns immediately, and the application calls DebugProt_WriteComplete()
+//from its transfer-complete interrupt, after which the next buffer is started
+void DebugProt_SetWriteAsync(SDebugProtocol* pDebug, funcWriteData pStartWrite);
+void DebugProt_WriteComplete(SDebugProtocol* pDebug);
+#endif
+
+#if DEBUG_STATS > 0
+//measure the CPU-cost of the debugger with a free-running cycle-counter of uCycles_Hz (e.g. DWT->CYCCNT), the
+//statistics are read by the host with cmdStats. Without a cycle-counter, only the byte-counters are kept
+void DebugProt_SetCycleCounter(SDebugProtocol* pDebug, funcGetCycles pGetCycles, uint32_t uCycles_Hz);
+#endif
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+//sample the channels at the exact tick instead of in DebugProt_DoMain, so the sample instant doesn't jitter with the
+//load of the main loop: in DebugProt_Tick (sampleInTick), or by calling DebugProt_Sample() where the application
+//chooses (sampleByApplication). DebugProt_DoMain sends the samples from the sample queue with the tick they were taken
+void DebugProt_SetSampleMode(SDebugProtocol* pDebug, ESampleMode mode);
+void DebugProt_Sample(SDebugProtocol* pDebug);
+#endif
+
+#if DEBUG_SNAPSHOT > 0
+//sample all channels of a tick as one set, so a value isn't torn by an interrupt that updates it and the channels of a
+//frame belong to the same instant: with a lock-hook around the sampling (it is locked for a copy of each active
+//channel), and/or from a double-buffered shadow that the application publishes (NULL = no hook or shadow)
+void DebugProt_SetSnapshotLock(SDebugProtocol* pDebug, funcSnapshotLock pLock);
+void DebugProt_SetShadow(SDebugProtocol* pDebug, SDebugShadow* pShadow);
+#endif
+
+//re-resolve the addresses of the debug-channels, for channels with the resolve-once policy (DEBUG_CHANNEL_RESOLVE_ONCE)
+//after the application changed a pointer of their pointer-chain
+void DebugProt_ResolveChannels(SDebugProtocol* pDebug);
+
+//an application may run several instances, e.g. a fast USB-link and a service UART, each with its own channels and
+//decimation. DebugProt_Trace(), asserts and DebugProt_GetChar() use every instance with fTraceAll set (the default),
+//DebugProt_TraceTo() and DebugProt_GetCharFrom() a single instance
+void DebugProt_AssertFail(const char* szAssertion, const char* szFile, const int32_t nLineNr);
+void DebugProt_Trace(const char* szString);
+bool DebugProt_GetChar(char* pChar);
+void DebugProt_TraceTo(SDebugProtocol* pDebug, const char* szString);
+bool DebugProt_GetCharFrom(SDebugProtocol* pDebug, char* pChar);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGPROTOCOL_H
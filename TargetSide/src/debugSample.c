@@ -0,0 +1,342 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "debugSample.h"
+#include <string.h>             //for using memset and memcpy
+
+//a record in the sample queue: size (2 bytes), generation, tick (4 bytes), then the sample of DebugSample_Take
+#define RECORD_HEADER_SIZE      (7 + DEBUG_CHANNEL_MASK_SIZE)
+
+//local function prototypes
+static uint32_t TakeValues(SDebugChannel* rgChannel, const SDebugShadow* pShadow, uint32_t uSequence, uint8_t* rgSample);
+#if DEBUG_CHANNEL_AGGREGATE > 0
+static void TakeWindows(SDebugChannel* rgChannel, uint8_t* rgSample);
+#endif
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+static uint32_t SkipWrap(SDebugSampleQueue* pQueue, uint32_t uIndexPop, uint32_t uIndexPush);
+#endif
+
+
+void DebugShadow_Init(SDebugShadow* pShadow, const void* pRegion, uint32_t uSize, void* pCopy0, void* pCopy1)
+{
+    //both copies start as the current data
+    memset(pShadow, 0, sizeof(SDebugShadow));
+    pShadow->pRegion = (const uint8_t*)pRegion;
+    pShadow->uSize = uSize;
+    pShadow->rgCopy[0] = (uint8_t*)pCopy0;
+    pShadow->rgCopy[1] = (uint8_t*)pCopy1;
+    memcpy(pCopy0, pRegion, uSize);
+    memcpy(pCopy1, pRegion, uSize);
+}
+
+
+void* DebugShadow_Begin(SDebugShadow* pShadow)
+{
+    uint32_t uSequence;
+
+    //mark the write (odd), the copy that is not published is written (single writer)
+    uSequence = DEBUG_LOAD_RELAXED(pShadow->uSequence) + 1;
+    DEBUG_STORE_RELEASE(pShadow->uSequence, uSequence);
+    DEBUG_FENCE();
+    return pShadow->rgCopy[((uSequence + 1) >> 1) & 1];
+}
+
+
+void DebugShadow_Publish(SDebugShadow* pShadow)
+{
+    //the written copy becomes the published one
+    DEBUG_STORE_RELEASE(pShadow->uSequence, DEBUG_LOAD_RELAXED(pShadow->uSequence) + 1);
+}
+
+
+void DebugShadow_Update(SDebugShadow* pShadow)
+{
+    //publish a copy of the whole region (e.g. at the end of a control step)
+    memcpy(DebugShadow_Begin(pShadow), pShadow->pRegion, pShadow->uSize);
+    DebugShadow_Publish(pShadow);
+}
+
+
+uint32_t DebugSample_Take(SDebugChannel* rgChannel, const SDebugSnapshot* pSnapshot, uint8_t* rgSample)
+{
+    SDebugShadow* pShadow;
+    uint32_t uSequence;
+    uint32_t uSize;
+    uint32_t uAttempt;
+
+    if (pSnapshot == NULL)
+    {
+        uSize = TakeValues(rgChannel, NULL, 0, rgSample);
+#if DEBUG_CHANNEL_AGGREGATE > 0
+        TakeWindows(rgChannel, rgSample);
+#endif
+        return uSize;
+    }
+
+    //sample the set from the published copy (under the lock of the application). It is consistent when the
+    //application didn't start writing that copy again, which takes a second Begin: sample it again when it did
+    pShadow = pSnapshot->pShadow;
+    for (uAttempt = 0; ; ++uAttempt)
+    {
+        uSequence = (pShadow != NULL) ? DEBUG_LOAD_ACQUIRE(pShadow->uSequence) : 0;
+        if (pSnapshot->pLock != NULL)
+        {
+            pSnapshot->pLock(true);
+        }
+        uSize = TakeValues(rgChannel, pShadow, uSequence, rgSample);
+        if (pSnapshot->pLock != NULL)
+        {
+            pSnapshot->pLock(false);
+        }
+        if (pShadow == NULL)
+        {
+            break;
+        }
+        DEBUG_FENCE();
+        if (DEBUG_LOAD_ACQUIRE(pShadow->uSequence) - (uSequence & ~(uint32_t)1) < 3)
+        {
+            break;
+        }
+        if (uAttempt >= DEBUG_SNAPSHOT_RETRIES)
+        {
+            ++pShadow->uTornCount;
+            break;
+        }
+    }
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    TakeWindows(rgChannel, rgSample);
+#endif
+
+    return uSize;
+}
+
+
+uint32_t TakeValues(SDebugChannel* rgChannel, const SDebugShadow* pShadow, uint32_t uSequence, uint8_t* rgSample)
+{
+    const uint8_t* pCopy;
+    uint8_t* pValue;
+    uint8_t* pAddress;
+    int32_t i;
+
+    //the channel-mask, followed by room for the value of every active channel (highest channel first)
+    pCopy = (pShadow != NULL) ? pShadow->rgCopy[(uSequence >> 1) & 1] : NULL;
+    memset(rgSample, 0, DEBUG_CHANNEL_MASK_SIZE);
+    pValue = &rgSample[DEBUG_CHANNEL_MASK_SIZE];
+    for (i = DEBUG_CHANNEL_COUNT - 1; i >= 0; --i)
+    {
+        if ((rgChannel[i].updateMode == updateOff) || (rgChannel[i].uSize_bytes > 8))
+        {
+            continue;
+        }
+#if DEBUG_CHANNEL_AGGREGATE > 0
+        //the window of an aggregated channel is taken once after the set (which may be sampled again)
+        if (rgChannel[i].fAggregate)
+        {
+            pValue += DbgChan_SampleSize(&rgChannel[i]);
+            continue;
+        }
+#endif
+
+        //a value inside the shadowed region is read from its published copy, a channel without an address is not
+        //in the mask
+        pAddress = (uint8_t*)DbgChan_GetAddress(&rgChannel[i]);
+        if ((pCopy != NULL) && (pAddress >= pShadow->pRegion) &&
+            (pAddress + rgChannel[i].uSize_bytes <= pShadow->pRegion + pShadow->uSize))
+        {
+            pAddress = (uint8_t*)pCopy + (pAddress - pShadow->pRegion);
+        }
+        if (pAddress != NULL)
+        {
+            memcpy(pValue, pAddress, rgChannel[i].uSize_bytes);
+            rgSample[i >> 3] |= (uint8_t)(0x01 << (i & 0x07));
+        }
+        pValue += rgChannel[i].uSize_bytes;
+    }
+
+    return (uint32_t)(pValue - rgSample);
+}
+
+
+#if DEBUG_CHANNEL_AGGREGATE > 0
+void TakeWindows(SDebugChannel* rgChannel, uint8_t* rgSample)
+{
+    uint8_t* pValue;
+    int32_t i;
+
+    //min, max and mean of the window in the room that TakeValues left, an empty window is not in the mask
+    pValue = &rgSample[DEBUG_CHANNEL_MASK_SIZE];
+    for (i = DEBUG_CHANNEL_COUNT - 1; i >= 0; --i)
+    {
+        if ((rgChannel[i].updateMode == updateOff) || (rgChannel[i].uSize_bytes > 8))
+        {
+            continue;
+        }
+        if (rgChannel[i].fAggregate && DbgChan_TakeWindow(&rgChannel[i], pValue))
+        {
+            rgSample[i >> 3] |= (uint8_t)(0x01 << (i & 0x07));
+        }
+        pValue += DbgChan_SampleSize(&rgChannel[i]);
+    }
+}
+#endif
+
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+
+void DebugSample_Init(SDebugSampleQueue* pQueue)
+{
+    memset(pQueue, 0, sizeof(SDebugSampleQueue));
+}
+
+
+bool DebugSample_Push(SDebugSampleQueue* pQueue, SDebugChannel* rgChannel, const SDebugSnapshot* pSnapshot, uint32_t uTime_tick)
+{
+    uint8_t* pRecord;
+    uint32_t uIndexPush;
+    uint32_t uIndexPop;
+    uint32_t uSize;
+    uint32_t uGeneration;
+    int32_t i;
+
+    //the generation is read before the channels, so a record that is sampled while they change is discarded
+    uGeneration = DEBUG_LOAD_ACQUIRE(pQueue->_uGeneration);
+
+    //size of the record with all active channels
+    uSize = RECORD_HEADER_SIZE;
+    for (i = DEBUG_CHANNEL_COUNT - 1; i >= 0; --i)
+    {
+        if ((rgChannel[i].updateMode != updateOff) && (rgChannel[i].uSize_bytes <= 8))
+        {
+            uSize += DbgChan_SampleSize(&rgChannel[i]);
+        }
+    }
+
+    //find contiguous room behind the push-index, or at the start of the buffer (the push-index never reaches the
+    //pop-index, that would be an empty queue)
+    uIndexPush = DEBUG_LOAD_RELAXED(pQueue->_uIndexPush);
+    uIndexPop = DEBUG_LOAD_ACQUIRE(pQueue->_uIndexPop);
+    if (uIndexPush >= uIndexPop)
+    {
+        if ((uIndexPush + uSize > DEBUG_SAMPLE_QUEUE_SIZE) || ((uIndexPush + uSize == DEBUG_SAMPLE_QUEUE_SIZE) && (uIndexPop == 0)))
+        {
+            if (uSize >= uIndexPop)
+            {
+                DEBUG_STORE_RELEASE(pQueue->uDroppedCount, DEBUG_LOAD_RELAXED(pQueue->uDroppedCount) + 1);
+                return false;
+            }
+            if (DEBUG_SAMPLE_QUEUE_SIZE - uIndexPush >= 2)
+            {
+                pQueue->_rgData[uIndexPush] = 0;
+                pQueue->_rgData[uIndexPush + 1] = 0;
+            }
+            uIndexPush = 0;
+        }
+    }
+    else if (uIndexPush + uSize >= uIndexPop)
+    {
+        DEBUG_STORE_RELEASE(pQueue->uDroppedCount, DEBUG_LOAD_RELAXED(pQueue->uDroppedCount) + 1);
+        return false;
+    }
+
+    //header, then sample the values without touching the change-detection (that is done by the consumer)
+    pRecord = &pQueue->_rgData[uIndexPush];
+    pRecord[0] = (uint8_t)(uSize & 0xFF);
+    pRecord[1] = (uint8_t)(uSize >> 8);
+    pRecord[2] = (uint8_t)uGeneration;
+    memcpy(&pRecord[3], &uTime_tick, 4);
+    DebugSample_Take(rgChannel, pSnapshot, &pRecord[7]);
+
+    //publish the record
+    uIndexPush += uSize;
+    if (uIndexPush == DEBUG_SAMPLE_QUEUE_SIZE)
+    {
+        uIndexPush = 0;
+    }
+    DEBUG_STORE_RELEASE(pQueue->_uIndexPush, uIndexPush);
+
+    return true;
+}
+
+
+const uint8_t* DebugSample_Front(SDebugSampleQueue* pQueue, uint32_t* puTime_tick)
+{
+    uint32_t uIndexPush;
+    uint32_t uIndexPop;
+    const uint8_t* pRecord;
+
+    //skip the records of an old channel configuration
+    uIndexPush = DEBUG_LOAD_ACQUIRE(pQueue->_uIndexPush);
+    uIndexPop = SkipWrap(pQueue, DEBUG_LOAD_RELAXED(pQueue->_uIndexPop), uIndexPush);
+    while (uIndexPop != uIndexPush)
+    {
+        pRecord = &pQueue->_rgData[uIndexPop];
+        if (pRecord[2] == (uint8_t)DEBUG_LOAD_RELAXED(pQueue->_uGeneration))
+        {
+            //return the channel-mask, followed by the values
+            memcpy(puTime_tick, &pRecord[3], 4);
+            return &pRecord[7];
+        }
+        DebugSample_Pop(pQueue);
+        uIndexPop = SkipWrap(pQueue, DEBUG_LOAD_RELAXED(pQueue->_uIndexPop), uIndexPush);
+    }
+
+    return NULL;
+}
+
+
+void DebugSample_Pop(SDebugSampleQueue* pQueue)
+{
+    uint32_t uIndexPush;
+    uint32_t uIndexPop;
+
+    //release the record in front (after DebugSample_Front)
+    uIndexPush = DEBUG_LOAD_ACQUIRE(pQueue->_uIndexPush);
+    uIndexPop = SkipWrap(pQueue, DEBUG_LOAD_RELAXED(pQueue->_uIndexPop), uIndexPush);
+    if (uIndexPop == uIndexPush)
+    {
+        return;
+    }
+    uIndexPop += pQueue->_rgData[uIndexPop] | ((uint32_t)pQueue->_rgData[uIndexPop + 1] << 8);
+    if (uIndexPop == DEBUG_SAMPLE_QUEUE_SIZE)
+    {
+        uIndexPop = 0;
+    }
+    DEBUG_STORE_RELEASE(pQueue->_uIndexPop, uIndexPop);
+}
+
+
+void DebugSample_Invalidate(SDebugSampleQueue* pQueue)
+{
+    //the records in the queue (and the one that may be sampled right now) are discarded by DebugSample_Front
+    DEBUG_STORE_RELEASE(pQueue->_uGeneration, DEBUG_LOAD_RELAXED(pQueue->_uGeneration) + 1);
+}
+
+
+uint32_t SkipWrap(SDebugSampleQueue* pQueue, uint32_t uIndexPop, uint32_t uIndexPush)
+{
+    //the producer continued at the start of the buffer when the rest didn't fit (marked by size 0 or no room for it)
+    if ((uIndexPop != uIndexPush) &&
+        ((DEBUG_SAMPLE_QUEUE_SIZE - uIndexPop < 2) || ((pQueue->_rgData[uIndexPop] | pQueue->_rgData[uIndexPop + 1]) == 0)))
+    {
+        uIndexPop = 0;
+        DEBUG_STORE_RELEASE(pQueue->_uIndexPop, uIndexPop);
+    }
+    return uIndexPop;
+}
+
+#endif //DEBUG_SAMPLE_QUEUE_SIZE > 0
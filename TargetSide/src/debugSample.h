@@ -0,0 +1,127 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGSAMPLE_H
+#define DEBUGSAMPLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugChannel.h"
+#include "debugMessage.h"
+
+//size in bytes of the sample queue, 0 = channels are only sampled in DebugProt_DoMain. With a queue, the channels can be
+//sampled at the exact tick (DebugProt_Tick or DebugProt_Sample), and DebugProt_DoMain only encodes and sends them.
+//A record holds the size, tick, channel-mask and the values of all active channels
+#ifndef DEBUG_SAMPLE_QUEUE_SIZE
+    #define DEBUG_SAMPLE_QUEUE_SIZE     (0)
+#endif
+
+//support for tear-free snapshots, 0 = the channels are copied one by one from the live data. With snapshots, all
+//channels of a tick are sampled as one set, protected by a lock-hook of the application or from a double-buffered
+//shadow of its data (SDebugShadow). Costs DEBUG_SAMPLE_SIZE_MAX bytes of RAM for the set
+#ifndef DEBUG_SNAPSHOT
+    #define DEBUG_SNAPSHOT              (0)
+#endif
+
+//nbr of times a set is sampled again when the application published its shadow twice while it was being read
+#ifndef DEBUG_SNAPSHOT_RETRIES
+    #define DEBUG_SNAPSHOT_RETRIES      (3)
+#endif
+
+//size of the channel-mask and the values of all channels of a tick (3 values for an aggregated channel)
+#if DEBUG_CHANNEL_AGGREGATE > 0
+    #define DEBUG_SAMPLE_SIZE_MAX       (DEBUG_CHANNEL_MASK_SIZE + 8 * DEBUG_AGGREGATE_VALUES * DEBUG_CHANNEL_COUNT)
+#else
+    #define DEBUG_SAMPLE_SIZE_MAX       (DEBUG_CHANNEL_MASK_SIZE + 8 * DEBUG_CHANNEL_COUNT)
+#endif
+
+
+typedef enum ESampleMode
+{
+    sampleInMain        = 0x00,     //DebugProt_DoMain samples the channels when it sends them (default)
+    sampleInTick        = 0x01,     //DebugProt_Tick (or DebugProt_DoISR) samples the channels that are due
+    sampleByApplication = 0x02      //the application calls DebugProt_Sample, e.g. right after its control step
+} ESampleMode;
+
+
+//locks (true) and unlocks (false) the application data while the channels of a tick are sampled, e.g. by disabling
+//interrupts or with a mutex of an RTOS
+typedef void (*funcSnapshotLock)(bool fLock);
+
+
+//double-buffered shadow of an application region: the application writes a consistent copy with
+//DebugShadow_Begin() / DebugShadow_Publish() (or copies the region with DebugShadow_Update()), without waiting for
+//the debugger. Channels with an address in the region are sampled from the copy that was published last.
+//uSequence is incremented by Begin and by Publish, so the last published copy is rgCopy[(uSequence >> 1) & 1]
+typedef struct SDebugShadow
+{
+    const uint8_t*          pRegion;
+    uint32_t                uSize;
+    uint8_t*                rgCopy[2];
+    DebugAtomic32           uSequence;
+    uint32_t                uTornCount;                         //nbr of sets that were still torn after the retries
+} SDebugShadow;
+
+
+typedef struct SDebugSnapshot
+{
+    funcSnapshotLock        pLock;
+    SDebugShadow*           pShadow;
+} SDebugSnapshot;
+
+
+void DebugShadow_Init(SDebugShadow* pShadow, const void* pRegion, uint32_t uSize, void* pCopy0, void* pCopy1);
+void* DebugShadow_Begin(SDebugShadow* pShadow);
+void DebugShadow_Publish(SDebugShadow* pShadow);
+void DebugShadow_Update(SDebugShadow* pShadow);
+
+//sample the channel-mask and the values of all active channels (room for each, the mask tells which have a value),
+//as one set when a snapshot is given. Returns the size
+uint32_t DebugSample_Take(SDebugChannel* rgChannel, const SDebugSnapshot* pSnapshot, uint8_t* rgSample);
+
+
+#if DEBUG_SAMPLE_QUEUE_SIZE > 0
+
+//the queue has a single producer (the tick or the application, typically in ISR context) and a single consumer
+//(DebugProt_DoMain), like the receive buffer. Records are contiguous, a record that doesn't fit at the end of the
+//buffer starts at the beginning (behind a size of 0 when there is room for it)
+typedef struct SDebugSampleQueue
+{
+    uint8_t                 _rgData[DEBUG_SAMPLE_QUEUE_SIZE];
+    DebugAtomic32           _uIndexPush;
+    DebugAtomic32           _uIndexPop;
+    DebugAtomic32           _uGeneration;                       //changed by the consumer when the channels change
+    DebugAtomic32           uDroppedCount;                      //nbr of records that didn't fit (written by the producer)
+} SDebugSampleQueue;
+
+
+void DebugSample_Init(SDebugSampleQueue* pQueue);
+bool DebugSample_Push(SDebugSampleQueue* pQueue, SDebugChannel* rgChannel, const SDebugSnapshot* pSnapshot, uint32_t uTime_tick);
+const uint8_t* DebugSample_Front(SDebugSampleQueue* pQueue, uint32_t* puTime_tick);
+void DebugSample_Pop(SDebugSampleQueue* pQueue);
+void DebugSample_Invalidate(SDebugSampleQueue* pQueue);
+
+#endif //DEBUG_SAMPLE_QUEUE_SIZE > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGSAMPLE_H
@@ -0,0 +1,200 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "debugSchedule.h"
+#include <string.h>             //for using memset and memcpy
+
+#if DEBUG_SCHEDULE_COUNT > 0
+
+
+void DebugSched_Init(SDebugSchedule* pSched)
+{
+    uint32_t i;
+
+    memset(pSched, 0, sizeof(SDebugSchedule));
+    for (i = 0; i < DEBUG_SCHEDULE_COUNT; ++i)
+    {
+        DEBUG_STORE_RELEASE(pSched->_rgWrite[i].uGroup, DEBUG_SCHEDULE_ALL);
+    }
+}
+
+
+EScheduleResult DebugSched_Add(SDebugSchedule* pSched, uint8_t uGroup, const SDebugChannel* pChan, const uint8_t* pValue)
+{
+    SDebugScheduledWrite* pWrite;
+    SDebugScheduleGroup* pGroup;
+    uint32_t i;
+
+    if ((uGroup >= DEBUG_SCHEDULE_GROUPS) || (pChan->uSize_bytes == 0) || (pChan->uSize_bytes > 8))
+    {
+        return scheduleInvalid;
+    }
+    pGroup = &pSched->_rgGroup[uGroup];
+    switch (DEBUG_LOAD_ACQUIRE(pGroup->uState))
+    {
+        case scheduleArmed:     return scheduleBusy;
+        case scheduleDiscarded: return scheduleFailed;
+        default:                break;
+    }
+
+    //fill a free write, it only belongs to the group once it is complete
+    for (i = 0; i < DEBUG_SCHEDULE_COUNT; ++i)
+    {
+        pWrite = &pSched->_rgWrite[i];
+        if (DEBUG_LOAD_ACQUIRE(pWrite->uGroup) == DEBUG_SCHEDULE_ALL)
+        {
+            pWrite->chan = *pChan;
+            memcpy(pWrite->rgValue, pValue, pChan->uSize_bytes);
+            DEBUG_STORE_RELEASE(pWrite->uGroup, uGroup);
+            ++pGroup->uCount;
+            DEBUG_STORE_RELEASE(pGroup->uState, scheduleOpen);
+            return scheduleOk;
+        }
+    }
+    return scheduleFull;
+}
+
+
+EScheduleResult DebugSched_Commit(SDebugSchedule* pSched, uint8_t uGroup, uint32_t uTime_tick, uint32_t uNow_tick)
+{
+    SDebugScheduleGroup* pGroup;
+
+    if (uGroup >= DEBUG_SCHEDULE_GROUPS)
+    {
+        return scheduleInvalid;
+    }
+    pGroup = &pSched->_rgGroup[uGroup];
+    switch (DEBUG_LOAD_ACQUIRE(pGroup->uState))
+    {
+        case scheduleArmed:     return scheduleBusy;
+        case scheduleDiscarded: return scheduleFailed;
+        default:                break;
+    }
+    if (pGroup->uCount == 0)
+    {
+        return scheduleInvalid;
+    }
+
+    //the tick of uNow_tick is done, so the group is applied at a later tick (the difference handles the wrap)
+    if ((int32_t)(uTime_tick - uNow_tick) <= 0)
+    {
+        return scheduleLate;
+    }
+
+    //hand the group to the tick, the writes are complete before it sees the state
+    pGroup->uTime_tick = uTime_tick;
+    DEBUG_STORE_RELEASE(pGroup->uState, scheduleArmed);
+    return scheduleOk;
+}
+
+
+EScheduleResult DebugSched_Cancel(SDebugSchedule* pSched, uint8_t uGroup)
+{
+    SDebugScheduleGroup* pGroup;
+    uint32_t uGroupWrite;
+    uint32_t i;
+
+    if ((uGroup >= DEBUG_SCHEDULE_GROUPS) && (uGroup != DEBUG_SCHEDULE_ALL))
+    {
+        return scheduleInvalid;
+    }
+
+    //disarm the group(s) first, so the tick no longer applies them, then free their writes
+    for (i = 0; i < DEBUG_SCHEDULE_GROUPS; ++i)
+    {
+        if ((uGroup == DEBUG_SCHEDULE_ALL) || (uGroup == i))
+        {
+            pGroup = &pSched->_rgGroup[i];
+            DEBUG_STORE_RELEASE(pGroup->uState, scheduleOpen);
+            pGroup->uTime_tick = 0;
+            pGroup->uCount = 0;
+        }
+    }
+    for (i = 0; i < DEBUG_SCHEDULE_COUNT; ++i)
+    {
+        uGroupWrite = DEBUG_LOAD_ACQUIRE(pSched->_rgWrite[i].uGroup);
+        if ((uGroupWrite != DEBUG_SCHEDULE_ALL) && ((uGroup == DEBUG_SCHEDULE_ALL) || (uGroup == uGroupWrite)))
+        {
+            DEBUG_STORE_RELEASE(pSched->_rgWrite[i].uGroup, DEBUG_SCHEDULE_ALL);
+        }
+    }
+    return scheduleOk;
+}
+
+
+void DebugSched_Fail(SDebugSchedule* pSched, uint8_t uGroup)
+{
+    //an armed group is left alone (its add failed with scheduleBusy), the others lose their writes
+    if ((uGroup >= DEBUG_SCHEDULE_GROUPS) || (DEBUG_LOAD_ACQUIRE(pSched->_rgGroup[uGroup].uState) == scheduleArmed))
+    {
+        return;
+    }
+    DebugSched_Cancel(pSched, uGroup);
+    DEBUG_STORE_RELEASE(pSched->_rgGroup[uGroup].uState, scheduleDiscarded);
+}
+
+
+uint32_t DebugSched_FreeCount(SDebugSchedule* pSched)
+{
+    uint32_t uCount;
+    uint32_t i;
+
+    uCount = 0;
+    for (i = 0; i < DEBUG_SCHEDULE_COUNT; ++i)
+    {
+        if (DEBUG_LOAD_ACQUIRE(pSched->_rgWrite[i].uGroup) == DEBUG_SCHEDULE_ALL)
+        {
+            ++uCount;
+        }
+    }
+    return uCount;
+}
+
+
+void DebugSched_Apply(SDebugSchedule* pSched, uint32_t uNow_tick)
+{
+    SDebugScheduledWrite* pWrite;
+    SDebugScheduleGroup* pGroup;
+    uint32_t uGroup;
+    uint32_t i;
+
+    for (uGroup = 0; uGroup < DEBUG_SCHEDULE_GROUPS; ++uGroup)
+    {
+        pGroup = &pSched->_rgGroup[uGroup];
+        if ((DEBUG_LOAD_ACQUIRE(pGroup->uState) != scheduleArmed) || ((int32_t)(uNow_tick - pGroup->uTime_tick) < 0))
+        {
+            continue;
+        }
+
+        //write all values of the group in this tick, then free the writes and hand the group back with the tick
+        for (i = 0; i < DEBUG_SCHEDULE_COUNT; ++i)
+        {
+            pWrite = &pSched->_rgWrite[i];
+            if (DEBUG_LOAD_RELAXED(pWrite->uGroup) == uGroup)
+            {
+                DbgChan_WriteValue(&pWrite->chan, pWrite->rgValue);
+                DEBUG_STORE_RELEASE(pWrite->uGroup, DEBUG_SCHEDULE_ALL);
+            }
+        }
+        pGroup->uTime_tick = uNow_tick;
+        pGroup->uCount = 0;
+        DEBUG_STORE_RELEASE(pGroup->uState, scheduleApplied);
+    }
+}
+
+#endif //DEBUG_SCHEDULE_COUNT > 0
@@ -0,0 +1,124 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGSCHEDULE_H
+#define DEBUGSCHEDULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugChannel.h"
+#include "debugMessage.h"
+
+//nbr of register-writes that can be scheduled (cmdSchedule), 0 = no support. The host queues writes in a group and
+//commits the group with a tick, DebugProt_Tick applies all writes of the group at that tick (before the channels of the
+//tick are sampled), so setpoint-steps land on an exact tick and never half. Costs about 60 bytes of RAM per write
+#ifndef DEBUG_SCHEDULE_COUNT
+    #define DEBUG_SCHEDULE_COUNT        (0)
+#endif
+
+//nbr of groups (max 16, the status of all groups fits in one reply): each group waits for its own tick, so the host
+//can have a sequence of steps committed ahead of time
+#ifndef DEBUG_SCHEDULE_GROUPS
+    #define DEBUG_SCHEDULE_GROUPS       (4)
+#endif
+
+#define DEBUG_SCHEDULE_ALL              (0xFF)                  //group-nr of cmdScheduleCancel for all groups
+
+
+typedef enum EScheduleCmd
+{
+    scheduleCmdStatus   = 0x00,     //reply: current tick (4 bytes), free writes, group-count, per group: state, tick (4
+                                    //bytes, the requested tick when armed, the tick it was applied at when applied), writes
+    scheduleCmdAdd      = 0x01,     //param: group, per write offset (4 bytes), ctrl, size, value, reply: group, result, count
+    scheduleCmdCommit   = 0x02,     //param: group, tick (4 bytes), reply: group, result, current tick (4 bytes)
+    scheduleCmdCancel   = 0x03      //param: group (0xFF: all groups), reply: group, result
+} EScheduleCmd;
+
+
+typedef enum EScheduleResult
+{
+    scheduleOk          = 0x00,
+    scheduleInvalid     = 0x01,     //unknown sub-command or group, invalid write (the group fails) or an empty group
+    scheduleFull        = 0x02,     //no free write left (the group fails)
+    scheduleBusy        = 0x03,     //the group is armed, it can't be changed until it is applied or cancelled
+    scheduleLate        = 0x04,     //the tick is not in the future, the group stays open
+    scheduleFailed      = 0x05      //an earlier add of the group failed, it can't be changed until it is cancelled
+} EScheduleResult;
+
+
+typedef enum EScheduleState
+{
+    scheduleOpen        = 0x00,     //writes may be added (also when it is empty)
+    scheduleArmed       = 0x01,     //waiting for its tick, owned by DebugProt_Tick
+    scheduleApplied     = 0x02,     //applied and empty, writes may be added
+    scheduleDiscarded   = 0x03      //an add failed and the writes are discarded, adds and commit fail until a cancel
+} EScheduleState;
+
+
+#if DEBUG_SCHEDULE_COUNT > 0
+
+//the main loop (the commands) adds the writes and arms a group, the tick applies it and hands it back. A write belongs
+//to the group in uGroup, the main loop only fills free writes and groups that are not armed. DebugProt_Tick interrupts
+//the main loop (or runs in the same thread), so a group that is due when it is cancelled may still be applied
+typedef struct SDebugScheduledWrite
+{
+    SDebugChannel           chan;
+    uint8_t                 rgValue[8];
+    DebugAtomic32           uGroup;                             //DEBUG_SCHEDULE_ALL when the write is free
+} SDebugScheduledWrite;
+
+
+typedef struct SDebugScheduleGroup
+{
+    DebugAtomic32           uState;                             //EScheduleState
+    uint32_t                uTime_tick;
+    uint8_t                 uCount;
+} SDebugScheduleGroup;
+
+
+typedef struct SDebugSchedule
+{
+    SDebugScheduledWrite    _rgWrite[DEBUG_SCHEDULE_COUNT];
+    SDebugScheduleGroup     _rgGroup[DEBUG_SCHEDULE_GROUPS];
+} SDebugSchedule;
+
+
+void DebugSched_Init(SDebugSchedule* pSched);
+EScheduleResult DebugSched_Add(SDebugSchedule* pSched, uint8_t uGroup, const SDebugChannel* pChan, const uint8_t* pValue);
+EScheduleResult DebugSched_Commit(SDebugSchedule* pSched, uint8_t uGroup, uint32_t uTime_tick, uint32_t uNow_tick);
+EScheduleResult DebugSched_Cancel(SDebugSchedule* pSched, uint8_t uGroup);
+
+//discard the writes of a group of which an add failed. The host sends the adds and the commit of a group without
+//waiting for the replies, so the group refuses the later adds and the commit until it is cancelled, and a commit
+//never arms the part of a step that was added after the failure
+void DebugSched_Fail(SDebugSchedule* pSched, uint8_t uGroup);
+
+uint32_t DebugSched_FreeCount(SDebugSchedule* pSched);
+
+//apply the groups that are due at uNow_tick (called by DebugProt_Tick)
+void DebugSched_Apply(SDebugSchedule* pSched, uint32_t uNow_tick);
+
+#endif //DEBUG_SCHEDULE_COUNT > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGSCHEDULE_H
@@ -0,0 +1,82 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "debugStats.h"
+#include <string.h>             //for using memset
+
+#if DEBUG_STATS > 0
+
+
+void DebugStats_Init(SDebugStats* pStats, funcGetCycles pGetCycles, uint32_t uCycles_Hz)
+{
+    memset(pStats, 0, sizeof(SDebugStats));
+    pStats->pGetCycles = pGetCycles;
+    pStats->uCycles_Hz = uCycles_Hz;
+    DebugStats_Reset(pStats);
+}
+
+
+void DebugStats_Reset(SDebugStats* pStats)
+{
+    int32_t i;
+
+    //the counter of the receiving side is reset as well, a byte counted during the reset is lost at worst
+    memset(pStats->rgPhase, 0, sizeof(pStats->rgPhase));
+    for (i = 0; i < statsPhaseCount; ++i)
+    {
+        pStats->rgPhase[i].uMin_cycles = UINT32_MAX;
+    }
+    pStats->uRxBytes = 0;
+    pStats->uTxBytes = 0;
+    pStats->uTxDropped = 0;
+}
+
+
+uint32_t DebugStats_Start(SDebugStats* pStats)
+{
+    return (pStats->pGetCycles != NULL) ? pStats->pGetCycles() : 0;
+}
+
+
+void DebugStats_Stop(SDebugStats* pStats, EDebugStatsPhase ePhase, uint32_t uStart_cycles)
+{
+    SDebugStatsPhase* pPhase;
+    uint32_t uCycles;
+
+    if (pStats->pGetCycles == NULL)
+    {
+        return;
+    }
+
+    //unsigned difference, so a wrapping counter is no problem
+    uCycles = pStats->pGetCycles() - uStart_cycles;
+    pPhase = &pStats->rgPhase[ePhase];
+    ++pPhase->uCount;
+    pPhase->uSum_cycles += uCycles;
+    if (uCycles < pPhase->uMin_cycles)
+    {
+        pPhase->uMin_cycles = uCycles;
+    }
+    if (uCycles > pPhase->uMax_cycles)
+    {
+        pPhase->uMax_cycles = uCycles;
+    }
+}
+
+
+#endif //DEBUG_STATS > 0
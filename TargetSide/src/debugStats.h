@@ -0,0 +1,104 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGSTATS_H
+#define DEBUGSTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//CPU-cost instrumentation of the debugger itself (cmdStats), 0 = no instrumentation. The cycles of each phase are
+//measured with a cycle-counter of the application (e.g. DWT->CYCCNT on a Cortex-M, or a POSIX clock on a host)
+#ifndef DEBUG_STATS
+    #define DEBUG_STATS                 (0)
+#endif
+
+
+typedef enum EStatsCmd
+{
+    statsCmdRead        = 0x00,     //reply: cycles/s (4 bytes), phase-count, per phase: count, min, max, avg cycles (4 bytes
+                                    //each), then rx-bytes, rx-dropped bytes, tx-bytes, tx-dropped messages, framing-errors
+                                    //and CRC-errors (4 bytes each)
+    statsCmdReset       = 0x01      //clear all statistics
+} EStatsCmd;
+
+
+typedef enum EDebugStatsPhase
+{
+    statsDoMain         = 0,        //DebugProt_DoMain, includes the other phases
+    statsChannelData    = 1,        //sampling and sending the channel-data of a tick
+    statsDecode         = 2,        //DebugMsgIn_DecodeAndCheck
+    statsEncode         = 3,        //DebugMsgOut_Encode
+    statsPhaseCount
+} EDebugStatsPhase;
+
+
+//returns a free-running counter, only differences are used (so it may wrap)
+typedef uint32_t (*funcGetCycles)(void);
+
+
+#if DEBUG_STATS > 0
+
+    #define DEBUG_STATS_START(pStats)                   DebugStats_Start(pStats)
+    #define DEBUG_STATS_STOP(pStats, ePhase, uStart)    DebugStats_Stop(pStats, ePhase, uStart)
+
+
+typedef struct SDebugStatsPhase
+{
+    uint32_t                uCount;
+    uint32_t                uMin_cycles;
+    uint32_t                uMax_cycles;
+    uint64_t                uSum_cycles;
+} SDebugStatsPhase;
+
+
+typedef struct SDebugStats
+{
+    funcGetCycles           pGetCycles;                         //NULL: only the byte-counters are kept
+    uint32_t                uCycles_Hz;
+    SDebugStatsPhase        rgPhase[statsPhaseCount];
+    uint32_t                uRxBytes;                           //written by the receiving side (may be an ISR)
+    uint32_t                uTxBytes;
+    uint32_t                uTxDropped;                         //nbr of messages that found no free TX buffer
+    uint32_t                _uRxOverrunBase;                    //overrun-count of the receive buffer at the last reset
+    uint32_t                _uFramingErrorBase;                 //error-counts of the decoder at the last reset
+    uint32_t                _uCrcErrorBase;
+} SDebugStats;
+
+
+void DebugStats_Init(SDebugStats* pStats, funcGetCycles pGetCycles, uint32_t uCycles_Hz);
+void DebugStats_Reset(SDebugStats* pStats);
+uint32_t DebugStats_Start(SDebugStats* pStats);
+void DebugStats_Stop(SDebugStats* pStats, EDebugStatsPhase ePhase, uint32_t uStart_cycles);
+
+#else
+
+    #define DEBUG_STATS_START(pStats)                   (0)
+    #define DEBUG_STATS_STOP(pStats, ePhase, uStart)    ((void)(uStart))
+
+#endif //DEBUG_STATS > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGSTATS_H
@@ -0,0 +1,298 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "debugStimulus.h"
+#include <string.h>             //for using memset and memcpy
+
+#if DEBUG_STIMULUS_SIZE > 0
+
+//local function prototypes
+static void Restart(SDebugStimulus* pStim);
+static float NextWave(SDebugStimulus* pStim);
+static float Sine(uint32_t uPhase);
+static int64_t ToInteger(float fValue, int64_t nMin, int64_t nMax);
+static void ToValue(const SDebugStimulus* pStim, float fValue, uint8_t* rgValue);
+
+
+void DebugStim_Init(SDebugStimulus* pStim)
+{
+    memset(pStim, 0, sizeof(SDebugStimulus));
+    DEBUG_STORE_RELEASE(pStim->uState, stimulusIdle);
+}
+
+
+EStimulusResult DebugStim_Config(SDebugStimulus* pStim, EStimulusWave wave, const SDebugChannel* pChan, EChannelFormat format, const uint8_t* rgParam)
+{
+    uint32_t uState;
+    uint16_t uDecimation;
+    uint32_t uPeriod;
+
+    uState = DEBUG_LOAD_ACQUIRE(pStim->uState);
+    if ((uState == stimulusArmed) || (uState == stimulusRunning))
+    {
+        return stimulusBusy;
+    }
+
+    //param: decimation (2 bytes), period, samples, offset, amplitude, p1, p2 (4 bytes each)
+    memcpy((uint8_t*)&uDecimation, &rgParam[0], 2);
+    memcpy((uint8_t*)&uPeriod, &rgParam[2], 4);
+    if ((wave > stimulusSquare) || (pChan->pSource == NULL) || (uDecimation == 0) || (pChan->uSize_bytes == 0) || (pChan->uSize_bytes > 8) ||
+        ((format == formatFloat) && (pChan->uSize_bytes != 4) && (pChan->uSize_bytes != 8)) ||
+        ((wave == stimulusTable) && ((uPeriod == 0) || (uPeriod > DEBUG_STIMULUS_SIZE / pChan->uSize_bytes))) ||
+        ((wave == stimulusPrbs) && (rgParam[22] == 0) && (rgParam[23] == 0) && (rgParam[24] == 0) && (rgParam[25] == 0)))
+    {
+        pStim->fConfigured = false;
+        return stimulusInvalid;
+    }
+
+    pStim->chan = *pChan;
+    pStim->format = format;
+    pStim->wave = wave;
+    pStim->uDecimation = uDecimation;
+    pStim->uPeriod = uPeriod;
+    memcpy((uint8_t*)&pStim->uSamples, &rgParam[6], 4);
+    memcpy((uint8_t*)&pStim->fOffset, &rgParam[10], 4);
+    memcpy((uint8_t*)&pStim->fAmplitude, &rgParam[14], 4);
+    memcpy((uint8_t*)&pStim->uParam1, &rgParam[18], 4);
+    memcpy((uint8_t*)&pStim->uParam2, &rgParam[22], 4);
+    pStim->fConfigured = true;
+    return stimulusOk;
+}
+
+
+EStimulusResult DebugStim_Start(SDebugStimulus* pStim, uint32_t uStart_tick)
+{
+    uint32_t uState;
+
+    uState = DEBUG_LOAD_ACQUIRE(pStim->uState);
+    if ((uState == stimulusArmed) || (uState == stimulusRunning))
+    {
+        return stimulusBusy;
+    }
+    if (!pStim->fConfigured)
+    {
+        return stimulusInvalid;
+    }
+
+    //the wave starts from its beginning, the tick takes over once it sees the state
+    Restart(pStim);
+    pStim->uPlayed = 0;
+    pStim->_uTickCount = 0;
+    pStim->uStart_tick = uStart_tick;
+    DEBUG_STORE_RELEASE(pStim->uState, stimulusArmed);
+    return stimulusOk;
+}
+
+
+void DebugStim_Stop(SDebugStimulus* pStim)
+{
+    //the tick no longer plays it from the next tick on, the register keeps its last value
+    DEBUG_STORE_RELEASE(pStim->uState, stimulusIdle);
+}
+
+
+void DebugStim_Tick(SDebugStimulus* pStim, uint32_t uNow_tick)
+{
+    uint8_t rgValue[8];
+    uint32_t uState;
+
+    uState = DEBUG_LOAD_ACQUIRE(pStim->uState);
+    if (uState == stimulusArmed)
+    {
+        //the difference handles the wrap of the tick
+        if ((int32_t)(uNow_tick - pStim->uStart_tick) < 0)
+        {
+            return;
+        }
+        pStim->uStart_tick = uNow_tick;
+        DEBUG_STORE_RELEASE(pStim->uState, stimulusRunning);
+    }
+    else if (uState != stimulusRunning)
+    {
+        return;
+    }
+
+    //a sample every uDecimation ticks, starting at the first tick
+    if (pStim->_uTickCount > 0)
+    {
+        --pStim->_uTickCount;
+        return;
+    }
+    pStim->_uTickCount = pStim->uDecimation - 1u;
+
+    if (pStim->wave == stimulusTable)
+    {
+        DbgChan_WriteValue(&pStim->chan, &pStim->rgTable[pStim->_uIndex * pStim->chan.uSize_bytes]);
+    }
+    else
+    {
+        ToValue(pStim, pStim->fOffset + pStim->fAmplitude * NextWave(pStim), rgValue);
+        DbgChan_WriteValue(&pStim->chan, rgValue);
+    }
+
+    //next sample of the period
+    ++pStim->_uIndex;
+    if ((pStim->uPeriod > 0) && (pStim->_uIndex >= pStim->uPeriod))
+    {
+        Restart(pStim);
+    }
+    ++pStim->uPlayed;
+    if ((pStim->uSamples > 0) && (pStim->uPlayed >= pStim->uSamples))
+    {
+        DEBUG_STORE_RELEASE(pStim->uState, stimulusDone);
+    }
+}
+
+
+void Restart(SDebugStimulus* pStim)
+{
+    pStim->_uIndex = 0;
+    pStim->_uPhase = 0;
+    pStim->_uPhaseStep = (uint64_t)pStim->uParam1 << 16;
+    pStim->_uLfsr = pStim->uParam2;
+}
+
+
+float NextWave(SDebugStimulus* pStim)
+{
+    float fWave;
+    uint32_t uPhase;
+
+    uPhase = pStim->_uPhase;
+    switch (pStim->wave)
+    {
+        case stimulusSine:
+        {
+            fWave = Sine(uPhase);
+            pStim->_uPhase += pStim->uParam1;
+            break;
+        }
+
+        case stimulusChirp:
+        {
+            //the phase-step changes linearly, with 16 extra bits so slow sweeps don't round to 0
+            fWave = Sine(uPhase);
+            pStim->_uPhase += (uint32_t)(pStim->_uPhaseStep >> 16);
+            pStim->_uPhaseStep += (uint64_t)(int64_t)(int32_t)pStim->uParam2;
+            break;
+        }
+
+        case stimulusPrbs:
+        {
+            //Galois LFSR, a sample per bit
+            fWave = (pStim->_uLfsr & 1) ? 1.0f : -1.0f;
+            pStim->_uLfsr = (pStim->_uLfsr >> 1) ^ ((pStim->_uLfsr & 1) ? pStim->uParam1 : 0);
+            break;
+        }
+
+        case stimulusSquare:
+        {
+            fWave = (uPhase < pStim->uParam2) ? 1.0f : -1.0f;
+            pStim->_uPhase += pStim->uParam1;
+            break;
+        }
+
+        default:
+        {
+            fWave = 0.0f;
+            break;
+        }
+    }
+    return fWave;
+}
+
+
+float Sine(uint32_t uPhase)
+{
+    float x;
+    float x2;
+    float fSine;
+
+    //fold to the first quarter (x from 0 to 1 is 0 to pi/2), then a Taylor polynomial up to x^9 (error < 4e-6)
+    x = (float)(uPhase & 0x3FFFFFFF) * (1.0f / 1073741824.0f);
+    if (uPhase & 0x40000000)
+    {
+        x = 1.0f - x;
+    }
+    x2 = x * x;
+    fSine = x * (1.5707963f - x2 * (0.64596409f - x2 * (0.079692626f - x2 * (0.0046817541f - x2 * 0.00016044118f))));
+    return (uPhase & 0x80000000) ? -fSine : fSine;
+}
+
+
+int64_t ToInteger(float fValue, int64_t nMin, int64_t nMax)
+{
+    //round to the nearest integer within the range of the register
+    fValue += (fValue >= 0.0f) ? 0.5f : -0.5f;
+    if (fValue <= (float)nMin)
+    {
+        return nMin;
+    }
+    if (fValue >= (float)nMax)
+    {
+        return nMax;
+    }
+    return (int64_t)fValue;
+}
+
+
+void ToValue(const SDebugStimulus* pStim, float fValue, uint8_t* rgValue)
+{
+    double dValue;
+    int64_t nValue;
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint32_t uBits;
+
+    //convert to the format and size of the register
+    uBits = 8u * pStim->chan.uSize_bytes;
+    if (pStim->format == formatFloat)
+    {
+        if (pStim->chan.uSize_bytes == 8)
+        {
+            dValue = fValue;
+            memcpy(rgValue, &dValue, 8);
+        }
+        else
+        {
+            memcpy(rgValue, &fValue, 4);
+        }
+        return;
+    }
+    if (pStim->format == formatSigned)
+    {
+        nValue = ToInteger(fValue, (uBits < 64) ? -((int64_t)1 << (uBits - 1)) : INT64_MIN,
+                           (uBits < 64) ? ((int64_t)1 << (uBits - 1)) - 1 : INT64_MAX);
+    }
+    else
+    {
+        nValue = ToInteger(fValue, 0, (uBits < 64) ? ((int64_t)1 << uBits) - 1 : INT64_MAX);
+    }
+
+    //the low bytes of the value, in the byte-order of the target
+    switch (pStim->chan.uSize_bytes)
+    {
+        case 1:     u8 = (uint8_t)nValue;   memcpy(rgValue, &u8, 1);        break;
+        case 2:     u16 = (uint16_t)nValue; memcpy(rgValue, &u16, 2);       break;
+        case 4:     u32 = (uint32_t)nValue; memcpy(rgValue, &u32, 4);       break;
+        default:    memcpy(rgValue, &nValue, pStim->chan.uSize_bytes);      break;
+    }
+}
+
+#endif //DEBUG_STIMULUS_SIZE > 0
@@ -0,0 +1,119 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGSTIMULUS_H
+#define DEBUGSTIMULUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugChannel.h"
+#include "debugMessage.h"
+
+//size in bytes of the waveform table of the stimulus generator (cmdStimulus), 0 = no stimulus generator. The generator
+//writes a waveform into a register every N ticks from DebugProt_Tick, before the channels of the tick are sampled, so
+//the stimulus and the response are streamed with the same timestamps. The host uploads the table with a memory-write
+//to sourceStimulusTable, or picks a sine, chirp, PRBS or square wave that the target computes (integer phase, no libm)
+#ifndef DEBUG_STIMULUS_SIZE
+    #define DEBUG_STIMULUS_SIZE         (0)
+#endif
+
+
+typedef enum EStimulusCmd
+{
+    stimulusCmdStatus   = 0x00,     //reply: state, start-tick (4 bytes), played samples (4 bytes), table-size (4 bytes)
+    stimulusCmdConfig   = 0x01,     //param: waveform, offset (4 bytes), ctrl, size, format, decimation (2 bytes), period
+                                    //(4 bytes), samples (4 bytes), offset and amplitude (float), p1 and p2 (4 bytes), reply: result
+    stimulusCmdStart    = 0x02,     //param: start-tick (4 bytes, next tick when omitted), reply: result, current tick (4 bytes)
+    stimulusCmdStop     = 0x03      //reply: result
+} EStimulusCmd;
+
+
+typedef enum EStimulusResult
+{
+    stimulusOk          = 0x00,
+    stimulusInvalid     = 0x01,     //unknown sub-command or waveform, invalid register or parameters, or not configured
+    stimulusBusy        = 0x02      //the generator is armed or running, stop it first
+} EStimulusResult;
+
+
+typedef enum EStimulusWave
+{
+    stimulusTable       = 0x00,     //the entries of the table (raw values of the register), p1 and p2 are not used
+    stimulusSine        = 0x01,     //p1: phase-step per sample (2^32 = 1 cycle)
+    stimulusChirp       = 0x02,     //p1: phase-step of the first sample, p2: change of the phase-step per sample (signed,
+                                    //in 2^-16 units), the sweep restarts every period
+    stimulusPrbs        = 0x03,     //p1: feedback taps of the Galois LFSR (e.g. 0x48000000 for PRBS-31), p2: seed (not 0)
+    stimulusSquare      = 0x04      //p1: phase-step per sample, p2: duty-cycle (2^32 = 100%)
+} EStimulusWave;
+
+
+typedef enum EStimulusState
+{
+    stimulusIdle        = 0x00,     //not configured, or stopped
+    stimulusArmed       = 0x01,     //waiting for the start-tick, owned by DebugProt_Tick
+    stimulusRunning     = 0x02,     //owned by DebugProt_Tick
+    stimulusDone        = 0x03      //all samples are played
+} EStimulusState;
+
+
+#if DEBUG_STIMULUS_SIZE > 0
+
+//the main loop (the commands) configures the generator while it is idle or done, the tick plays it while it is armed
+//or running. A sample is offset + amplitude * wave (-1...1) in the format of the register, a table entry is copied as is
+typedef struct SDebugStimulus
+{
+    SDebugChannel           chan;
+    EChannelFormat          format;
+    EStimulusWave           wave;
+    uint16_t                uDecimation;                        //a sample every uDecimation ticks
+    uint32_t                uPeriod;                            //nbr of samples after which the wave restarts, 0 = never
+    uint32_t                uSamples;                           //nbr of samples to play, 0 = until stopped
+    float                   fOffset;
+    float                   fAmplitude;
+    uint32_t                uParam1;
+    uint32_t                uParam2;
+    bool                    fConfigured;
+    DebugAtomic32           uState;                             //EStimulusState
+    uint32_t                uStart_tick;                        //start-tick when armed, tick of the first sample when running
+    uint32_t                uPlayed;
+    uint32_t                _uTickCount;
+    uint32_t                _uIndex;                            //sample within the period
+    uint32_t                _uPhase;
+    uint64_t                _uPhaseStep;                        //in 2^-16 units of the phase
+    uint32_t                _uLfsr;
+    uint8_t                 rgTable[DEBUG_STIMULUS_SIZE];
+} SDebugStimulus;
+
+
+void DebugStim_Init(SDebugStimulus* pStim);
+EStimulusResult DebugStim_Config(SDebugStimulus* pStim, EStimulusWave wave, const SDebugChannel* pChan, EChannelFormat format, const uint8_t* rgParam);
+EStimulusResult DebugStim_Start(SDebugStimulus* pStim, uint32_t uStart_tick);
+void DebugStim_Stop(SDebugStimulus* pStim);
+
+//play the sample of uNow_tick (called by DebugProt_Tick)
+void DebugStim_Tick(SDebugStimulus* pStim, uint32_t uNow_tick);
+
+#endif //DEBUG_STIMULUS_SIZE > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGSTIMULUS_H
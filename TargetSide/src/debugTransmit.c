@@ -0,0 +1,210 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "debugTransmit.h"
+#include <string.h>             //for using memset
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+
+//local function prototypes
+static uint32_t NextQueue(SDebugTransmit* pTx);
+static void Release(SDebugTransmit* pTx, uint32_t ePriority);
+static void StartWrite(SDebugTransmit* pTx);
+
+
+void DebugTx_Init(SDebugTransmit* pTx, funcWriteData pWriteData, bool fAsync)
+{
+    uint32_t i;
+
+    memset(pTx, 0, sizeof(SDebugTransmit));
+    pTx->pWriteData = pWriteData;
+    pTx->fAsync = fAsync;
+    pTx->_ePrioWriting = txPrioCount;
+
+    //all buffers are free
+    for (i = 0; i < DEBUG_TX_BUFFER_COUNT; ++i)
+    {
+        pTx->_rgFree[i] = (uint8_t)i;
+    }
+    pTx->_uFreeCount = DEBUG_TX_BUFFER_COUNT;
+}
+
+
+uint8_t* DebugTx_Reserve(SDebugTransmit* pTx, EDebugTxPriority ePriority)
+{
+    SDebugTxQueue* pQueue;
+    uint32_t uMinFree;
+    uint32_t uIndex;
+
+    //channel-data always leaves one buffer for replies and traces
+    uMinFree = ((ePriority == txPrioChannel) && (DEBUG_TX_BUFFER_COUNT > 1)) ? 2 : 1;
+
+    DEBUG_ENTER_CRITICAL();
+
+    //check if a buffer is free, otherwise drop the message
+    if (pTx->_uFreeCount < uMinFree)
+    {
+        ++pTx->rguDropCount[ePriority];
+        DEBUG_EXIT_CRITICAL();
+        return NULL;
+    }
+
+    //claim a free buffer and append it to the queue of its priority, it is not written before it is committed
+    uIndex = pTx->_rgFree[--pTx->_uFreeCount];
+    pTx->_rgSize[uIndex] = 0;
+    pQueue = &pTx->_rgQueue[ePriority];
+    pQueue->_rgIndex[(pQueue->_uIndexPop + pQueue->_uCount) % DEBUG_TX_BUFFER_COUNT] = (uint8_t)uIndex;
+    ++pQueue->_uCount;
+
+    DEBUG_EXIT_CRITICAL();
+
+    return pTx->_rgBuffer[uIndex];
+}
+
+
+void DebugTx_Commit(SDebugTransmit* pTx, uint8_t* pBuffer, uint32_t uSize)
+{
+    uint32_t uIndex;
+
+    //mark the buffer as ready to be written
+    uIndex = (uint32_t)(pBuffer - pTx->_rgBuffer[0]) / DEBUG_MSG_RAW_SIZE;
+    pTx->_rgSize[uIndex] = (uint16_t)uSize;
+
+    //an asynchronous writer is started right away, when it is idle
+    if (pTx->fAsync)
+    {
+        DEBUG_ENTER_CRITICAL();
+        if (pTx->_ePrioWriting == txPrioCount)
+        {
+            StartWrite(pTx);
+        }
+        DEBUG_EXIT_CRITICAL();
+    }
+}
+
+
+void DebugTx_Flush(SDebugTransmit* pTx, uint32_t uBudget)
+{
+    SDebugTxQueue* pQueue;
+    uint32_t ePriority;
+    uint32_t uIndex;
+    uint32_t uWritten;
+
+    //an asynchronous writer flushes itself from the write-complete callback
+    if (pTx->fAsync)
+    {
+        return;
+    }
+
+    //write the committed buffers, highest priority first, until the budget is used
+    uWritten = 0;
+    do
+    {
+        DEBUG_ENTER_CRITICAL();
+        ePriority = NextQueue(pTx);
+        DEBUG_EXIT_CRITICAL();
+        if (ePriority == txPrioCount)
+        {
+            break;
+        }
+
+        pQueue = &pTx->_rgQueue[ePriority];
+        uIndex = pQueue->_rgIndex[pQueue->_uIndexPop];
+        pTx->pWriteData(pTx->_rgBuffer[uIndex], pTx->_rgSize[uIndex]);
+        uWritten += pTx->_rgSize[uIndex];
+
+        DEBUG_ENTER_CRITICAL();
+        Release(pTx, ePriority);
+        DEBUG_EXIT_CRITICAL();
+    } while ((uBudget == 0) || (uWritten < uBudget));
+}
+
+
+uint32_t DebugTx_Available(SDebugTransmit* pTx)
+{
+    //nbr of free transmit buffers
+    return pTx->_uFreeCount;
+}
+
+
+void DebugTx_WriteComplete(SDebugTransmit* pTx)
+{
+    DEBUG_ENTER_CRITICAL();
+
+    //release the buffer that has been written
+    if (pTx->_ePrioWriting != txPrioCount)
+    {
+        Release(pTx, pTx->_ePrioWriting);
+        pTx->_ePrioWriting = txPrioCount;
+    }
+
+    //continue with the next buffer
+    StartWrite(pTx);
+
+    DEBUG_EXIT_CRITICAL();
+}
+
+
+uint32_t NextQueue(SDebugTransmit* pTx)
+{
+    SDebugTxQueue* pQueue;
+    uint32_t ePriority;
+
+    //find the highest priority queue of which the oldest buffer is completely encoded (called with interrupts locked)
+    for (ePriority = 0; ePriority < txPrioCount; ++ePriority)
+    {
+        pQueue = &pTx->_rgQueue[ePriority];
+        if ((pQueue->_uCount > 0) && (pTx->_rgSize[pQueue->_rgIndex[pQueue->_uIndexPop]] != 0))
+        {
+            return ePriority;
+        }
+    }
+
+    return txPrioCount;
+}
+
+
+void Release(SDebugTransmit* pTx, uint32_t ePriority)
+{
+    SDebugTxQueue* pQueue;
+
+    //remove the oldest buffer from the queue and return it to the free buffers (called with interrupts locked)
+    pQueue = &pTx->_rgQueue[ePriority];
+    pTx->_rgFree[pTx->_uFreeCount++] = pQueue->_rgIndex[pQueue->_uIndexPop];
+    pQueue->_uIndexPop = (pQueue->_uIndexPop + 1) % DEBUG_TX_BUFFER_COUNT;
+    --pQueue->_uCount;
+}
+
+
+void StartWrite(SDebugTransmit* pTx)
+{
+    SDebugTxQueue* pQueue;
+    uint32_t ePriority;
+    uint32_t uIndex;
+
+    //start the highest priority buffer that is completely encoded (called with interrupts locked)
+    ePriority = NextQueue(pTx);
+    if (ePriority != txPrioCount)
+    {
+        pQueue = &pTx->_rgQueue[ePriority];
+        uIndex = pQueue->_rgIndex[pQueue->_uIndexPop];
+        pTx->_ePrioWriting = (uint8_t)ePriority;
+        pTx->pWriteData(pTx->_rgBuffer[uIndex], pTx->_rgSize[uIndex]);
+    }
+}
+
+#endif //DEBUG_TX_BUFFER_COUNT > 0
@@ -0,0 +1,105 @@
+/*
+Embedded Debugger system side which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBUGTRANSMIT_H
+#define DEBUGTRANSMIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "debugMessage.h"
+
+//nbr of static transmit buffers of the TX engine (max 255):
+// 0:   no TX engine, every message is encoded on the stack and written synchronously with pWriteData
+// >=2: messages (also traces) are encoded directly into a static transmit buffer, and written from
+//      DebugProt_DoMain or, with an asynchronous writer, back-to-back from the write-complete callback.
+//      Costs DEBUG_TX_BUFFER_COUNT * DEBUG_MSG_RAW_SIZE bytes of RAM per SDebugProtocol instance
+#ifndef DEBUG_TX_BUFFER_COUNT
+    #define DEBUG_TX_BUFFER_COUNT   (0)
+#endif
+
+//max nbr of bytes written by a single DebugProt_DoMain call with a synchronous writer (0 = no limit, which
+//drains all pending messages in one call). At least one message is written per call, also when it is larger
+//than the budget
+#ifndef DEBUG_TX_BUDGET_BYTES
+    #define DEBUG_TX_BUDGET_BYTES   (DEBUG_MSG_RAW_SIZE)
+#endif
+
+//protection of the transmit buffer administration against the write-complete interrupt and against messages
+//sent from interrupt context (DebugProt_Trace or ASSERT in an ISR, sampling in the tick), for example with a
+//PRIMASK save / __disable_irq() / restore sequence on a Cortex-M. The TX engine requires them: define them empty
+//only when all messages are sent from the main loop and the writer is synchronous
+#if DEBUG_TX_BUFFER_COUNT > 0
+    #if !defined(DEBUG_ENTER_CRITICAL) || !defined(DEBUG_EXIT_CRITICAL)
+        #error "DEBUG_TX_BUFFER_COUNT > 0 requires DEBUG_ENTER_CRITICAL() and DEBUG_EXIT_CRITICAL()"
+    #endif
+#endif
+
+
+typedef void (*funcWriteData)(uint8_t* data, uint16_t dataSize);
+
+
+//transmit priorities, the lowest value is written first
+typedef enum EDebugTxPriority
+{
+    txPrioTrace = 0,        //DebugProt_Trace, asserts and status strings
+    txPrioReply,            //replies on received commands
+    txPrioChannel,          //streaming channel-data
+    txPrioCount
+} EDebugTxPriority;
+
+
+#if DEBUG_TX_BUFFER_COUNT > 0
+
+//FIFO of reserved buffers (indices) of a single priority
+typedef struct SDebugTxQueue
+{
+    volatile uint8_t        _rgIndex[DEBUG_TX_BUFFER_COUNT];
+    volatile uint32_t       _uIndexPop;
+    volatile uint32_t       _uCount;
+} SDebugTxQueue;
+
+typedef struct SDebugTransmit
+{
+    uint8_t                 _rgBuffer[DEBUG_TX_BUFFER_COUNT][DEBUG_MSG_RAW_SIZE];
+    volatile uint16_t       _rgSize[DEBUG_TX_BUFFER_COUNT];     //0 = reserved but not yet encoded
+    volatile uint8_t        _rgFree[DEBUG_TX_BUFFER_COUNT];     //stack of free buffers
+    volatile uint32_t       _uFreeCount;
+    SDebugTxQueue           _rgQueue[txPrioCount];
+    volatile uint8_t        _ePrioWriting;                      //queue of the asynchronous write in progress (txPrioCount = idle)
+    uint32_t                rguDropCount[txPrioCount];          //nbr of messages dropped because no buffer was available
+    funcWriteData           pWriteData;
+    bool                    fAsync;
+} SDebugTransmit;
+
+
+void DebugTx_Init(SDebugTransmit* pTx, funcWriteData pWriteData, bool fAsync);
+uint8_t* DebugTx_Reserve(SDebugTransmit* pTx, EDebugTxPriority ePriority);
+void DebugTx_Commit(SDebugTransmit* pTx, uint8_t* pBuffer, uint32_t uSize);
+void DebugTx_Flush(SDebugTransmit* pTx, uint32_t uBudget);
+uint32_t DebugTx_Available(SDebugTransmit* pTx);
+void DebugTx_WriteComplete(SDebugTransmit* pTx);
+
+#endif //DEBUG_TX_BUFFER_COUNT > 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DEBUGTRANSMIT_H
@@ -0,0 +1,86 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ApplicationLayerBase.h"
+#include "Medium/Register/Register.h"
+#include <QTimer>
+
+namespace
+{
+// The Registers that still exist, in the order of the requests
+QVector<const Register*> existingRegisters(const QVector<QPointer<const Register>>& registers)
+{
+    QVector<const Register*> existing;
+    for (const QPointer<const Register>& reg : registers)
+    {
+        if (!reg.isNull())
+        {
+            existing.append(reg.data());
+        }
+    }
+    return existing;
+}
+}
+
+void ApplicationLayerBase::queryRegister(const Register& registerToRead)
+{
+    if (!m_pendingQueries.contains(&registerToRead))
+    {
+        m_pendingQueries.append(&registerToRead);
+    }
+    scheduleRegisterRequests();
+}
+
+void ApplicationLayerBase::writeRegister(const Register& registerToWrite)
+{
+    // The value is taken when the write is sent, so only the newest value of a Register is written
+    if (!m_pendingWrites.contains(&registerToWrite))
+    {
+        m_pendingWrites.append(&registerToWrite);
+    }
+    scheduleRegisterRequests();
+}
+
+void ApplicationLayerBase::scheduleRegisterRequests()
+{
+    if (!m_registerRequestsScheduled)
+    {
+        m_registerRequestsScheduled = true;
+        QTimer::singleShot(0, this, &ApplicationLayerBase::sendRegisterRequests);
+    }
+}
+
+void ApplicationLayerBase::sendRegisterRequests()
+{
+    m_registerRequestsScheduled = false;
+    QVector<const Register*> writes = existingRegisters(m_pendingWrites);
+    QVector<const Register*> queries = existingRegisters(m_pendingQueries);
+    m_pendingWrites.clear();
+    m_pendingQueries.clear();
+
+    // Writes first, so a query of the same iteration returns the new value
+    if (!writes.isEmpty())
+    {
+        writeRegisters(writes);
+    }
+    if (!queries.isEmpty())
+    {
+        queryRegisters(queries);
+    }
+}
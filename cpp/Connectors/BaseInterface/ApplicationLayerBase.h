@@ -20,6 +20,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define APPLICATIONLAYERBASE_H
 
 #include <QObject>
+#include <QPointer>
+#include <QVector>
 class Register;
 class Cpu;
 
@@ -42,16 +44,18 @@ public slots:
     virtual void scanForCpu() = 0;
 
     /**
-     * @brief Query the current value of a Register
+     * @brief Query the current value of a Register.
+     * Queries within one event-loop iteration are sent together by queryRegisters().
      * @param Register you want to query
      */
-    virtual void queryRegister(const Register& registerToRead) = 0;
+    void queryRegister(const Register& registerToRead);
 
     /**
-     * @brief Write the Register with a new value
+     * @brief Write the Register with a new value.
+     * Writes within one event-loop iteration are sent together by writeRegisters(), before the queries.
      * @param Register you want to write
      */
-    virtual void writeRegister(const Register& registerToWrite) = 0;
+    void writeRegister(const Register& registerToWrite);
 
     /**
      * @brief Reset the time of the CPU
@@ -76,6 +80,127 @@ public slots:
      * @param Cpu of which you want to set the decimation.
      */
     virtual void setDecimation(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Start an on-target capture of the active debug channels
+     * @param Cpu that needs to capture, with its capture decimation.
+     */
+    virtual void startCapture(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Stop the on-target capture
+     * @param Cpu that is capturing.
+     */
+    virtual void stopCapture(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Upload the records of a stopped capture into Cpu::capture()
+     * @param Cpu of which you want the capture.
+     */
+    virtual void uploadCapture(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Arm an on-target capture with the trigger of Cpu::capture()
+     * @param Cpu that needs to capture, with its capture decimation.
+     */
+    virtual void armCapture(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Disarm the on-target capture, discarding it
+     * @param Cpu that is armed.
+     */
+    virtual void disarmCapture(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Read (the remainder of) the memory block of Cpu::memoryTransfer() from the target
+     * @param Cpu of which you want to read memory.
+     */
+    virtual void readMemory(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Write (the remainder of) the memory block of Cpu::memoryTransfer() to the target
+     * @param Cpu of which you want to write memory.
+     */
+    virtual void writeMemory(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Read the CPU-cost statistics of the debugger into Cpu::stats()
+     * @param Cpu of which you want the statistics.
+     */
+    virtual void readStats(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Clear the CPU-cost statistics of the debugger on the target
+     * @param Cpu of which you want to clear the statistics.
+     */
+    virtual void resetStats(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Send the pending steps of Cpu::schedule() to the target, each step is applied at its tick
+     * @param Cpu of which you want to commit the schedule.
+     */
+    virtual void commitSchedule(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Cancel all steps that the target has not applied yet
+     * @param Cpu of which you want to cancel the schedule.
+     */
+    virtual void cancelSchedule(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Read the status of the scheduled steps into Cpu::schedule(), and send the steps that are waiting
+     * @param Cpu of which you want the status.
+     */
+    virtual void readSchedule(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Configure and start the stimulus of Cpu::stimulus() on the target
+     * @param Cpu of which you want to start the stimulus.
+     */
+    virtual void startStimulus(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Stop the stimulus generator of the target, the register keeps its last value
+     * @param Cpu of which you want to stop the stimulus.
+     */
+    virtual void stopStimulus(const Cpu& cpu) = 0;
+
+    /**
+     * @brief Read the status of the stimulus generator into Cpu::stimulus()
+     * @param Cpu of which you want the status.
+     */
+    virtual void readStimulus(const Cpu& cpu) = 0;
+
+signals:
+    /**
+     * @brief Progress of the memory transfer of a Cpu
+     * @param cpu Cpu of the transfer
+     * @param bytesDone Number of bytes that are read or acknowledged
+     * @param bytesTotal Size of the memory block
+     */
+    void memoryTransferProgress(const Cpu& cpu, int bytesDone, int bytesTotal);
+
+protected:
+    /**
+     * @brief Query the current values of several Registers, of one or more Cpu`s
+     * @param Registers you want to query, each Register once
+     */
+    virtual void queryRegisters(const QVector<const Register*>& registersToRead) = 0;
+
+    /**
+     * @brief Write several Registers with their new values, of one or more Cpu`s
+     * @param Registers you want to write, each Register once
+     */
+    virtual void writeRegisters(const QVector<const Register*>& registersToWrite) = 0;
+
+private:
+    void scheduleRegisterRequests();
+    void sendRegisterRequests();
+
+    // Registers can be deleted (Cpu reset, register list reload) while a request waits, they are then skipped
+    QVector<QPointer<const Register>> m_pendingQueries;
+    QVector<QPointer<const Register>> m_pendingWrites;
+    bool m_registerRequestsScheduled = false;
 };
 
 #endif // APPLICATIONLAYERBASE_H
@@ -22,6 +22,8 @@ ApplicationLayerV0::ApplicationLayerV0(PresentationLayerV0& presentationLayerV0,
     ApplicationLayerBase(parent),
     m_presentationLayer(presentationLayerV0)
 {
+    QObject::connect(&m_presentationLayer,&PresentationLayerV0::memoryTransferProgress,
+                     this,&ApplicationLayerBase::memoryTransferProgress);
 }
 
 void ApplicationLayerV0::scanForCpu()
@@ -29,14 +31,14 @@ void ApplicationLayerV0::scanForCpu()
     m_presentationLayer.scanForCpu();
 }
 
-void ApplicationLayerV0::queryRegister(const Register &registerToRead)
+void ApplicationLayerV0::queryRegisters(const QVector<const Register*>& registersToRead)
 {
-    m_presentationLayer.queryRegister(registerToRead);
+    m_presentationLayer.queryRegisters(registersToRead);
 }
 
-void ApplicationLayerV0::writeRegister(const Register &registerToWrite)
+void ApplicationLayerV0::writeRegisters(const QVector<const Register*>& registersToWrite)
 {
-    m_presentationLayer.writeRegister(registerToWrite);
+    m_presentationLayer.writeRegisters(registersToWrite);
 }
 
 void ApplicationLayerV0::resetTime(const Cpu& cpu)
@@ -56,5 +58,80 @@ void ApplicationLayerV0::getDecimation(const Cpu& cpu)
 
 void ApplicationLayerV0::setDecimation(const Cpu& cpu)
 {
-    m_presentationLayer.setDecimation(cpu.id(),cpu.decimation());
+    m_presentationLayer.setDecimation(cpu.id(),cpu.decimation(),cpu.rateGroupDecimations());
+}
+
+void ApplicationLayerV0::startCapture(const Cpu& cpu)
+{
+    m_presentationLayer.startCapture(cpu.id(),cpu.captureDecimation());
+}
+
+void ApplicationLayerV0::stopCapture(const Cpu& cpu)
+{
+    m_presentationLayer.stopCapture(cpu.id());
+}
+
+void ApplicationLayerV0::uploadCapture(const Cpu& cpu)
+{
+    m_presentationLayer.uploadCapture(cpu.id());
+}
+
+void ApplicationLayerV0::armCapture(const Cpu& cpu)
+{
+    m_presentationLayer.armCapture(cpu.id(),cpu.captureDecimation());
+}
+
+void ApplicationLayerV0::disarmCapture(const Cpu& cpu)
+{
+    m_presentationLayer.disarmCapture(cpu.id());
+}
+
+void ApplicationLayerV0::readMemory(const Cpu& cpu)
+{
+    m_presentationLayer.readMemory(cpu.id());
+}
+
+void ApplicationLayerV0::writeMemory(const Cpu& cpu)
+{
+    m_presentationLayer.writeMemory(cpu.id());
+}
+
+void ApplicationLayerV0::readStats(const Cpu& cpu)
+{
+    m_presentationLayer.readStats(cpu.id());
+}
+
+void ApplicationLayerV0::resetStats(const Cpu& cpu)
+{
+    m_presentationLayer.resetStats(cpu.id());
+}
+
+void ApplicationLayerV0::commitSchedule(const Cpu& cpu)
+{
+    m_presentationLayer.commitSchedule(cpu.id());
+}
+
+void ApplicationLayerV0::cancelSchedule(const Cpu& cpu)
+{
+    m_presentationLayer.cancelSchedule(cpu.id());
+}
+
+void ApplicationLayerV0::readSchedule(const Cpu& cpu)
+{
+    m_presentationLayer.readSchedule(cpu.id());
+}
+
+void ApplicationLayerV0::startStimulus(const Cpu& cpu)
+{
+    m_presentationLayer.startStimulus(cpu.id());
+}
+
+void ApplicationLayerV0::stopStimulus(const Cpu& cpu)
+{
+    m_presentationLayer.stopStimulus(cpu.id());
+}
+
+void ApplicationLayerV0::readStimulus(const Cpu& cpu)
+{
+    m_presentationLayer.readStimulus(cpu.id());
 }
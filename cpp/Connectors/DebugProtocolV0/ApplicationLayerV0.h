@@ -34,16 +34,6 @@ public slots:
     */
     void scanForCpu() override;
 
-    /**
-    * @copydoc ApplicationLayerBase::queryRegister()
-    */
-    void queryRegister(const Register& registerToRead) override;
-
-    /**
-    * @copydoc ApplicationLayerBase::writeRegister()
-    */
-    void writeRegister(const Register& registerToWrite) override;
-
     /**
     * @copydoc ApplicationLayerBase::resetTime()
     */
@@ -64,6 +54,92 @@ public slots:
     */
     void setDecimation(const Cpu& cpu) override;
 
+    /**
+    * @copydoc ApplicationLayerBase::startCapture()
+    */
+    void startCapture(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::stopCapture()
+    */
+    void stopCapture(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::uploadCapture()
+    */
+    void uploadCapture(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::armCapture()
+    */
+    void armCapture(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::disarmCapture()
+    */
+    void disarmCapture(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::readMemory()
+    */
+    void readMemory(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::writeMemory()
+    */
+    void writeMemory(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::readStats()
+    */
+    void readStats(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::resetStats()
+    */
+    void resetStats(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::commitSchedule()
+    */
+    void commitSchedule(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::cancelSchedule()
+    */
+    void cancelSchedule(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::readSchedule()
+    */
+    void readSchedule(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::startStimulus()
+    */
+    void startStimulus(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::stopStimulus()
+    */
+    void stopStimulus(const Cpu& cpu) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::readStimulus()
+    */
+    void readStimulus(const Cpu& cpu) override;
+
+protected:
+    /**
+    * @copydoc ApplicationLayerBase::queryRegisters()
+    */
+    void queryRegisters(const QVector<const Register*>& registersToRead) override;
+
+    /**
+    * @copydoc ApplicationLayerBase::writeRegisters()
+    */
+    void writeRegisters(const QVector<const Register*>& registersToWrite) override;
+
 private:
     PresentationLayerV0& m_presentationLayer; /**< Reference to PresentationLayerV0 for easy access this class*/
 };
@@ -58,6 +58,79 @@ public:
         ResetTime = 0x54,
         ReadChannelData = 0x52,
         DebugString = 0x53,
+        Capture = 0x4F,
+        CompactData = 0x50,
+        Memory = 0x4D,
+        QueryRegisters = 0x71,
+        WriteRegisters = 0x77,
+        Stats = 0x5A,
+        Capabilities = 0x4B,
+        Schedule = 0x41,
+        Stimulus = 0x47,
+    };
+
+    enum CaptureCommand{
+        CaptureStatus = 0x00,
+        CaptureStart = 0x01,
+        CaptureStop = 0x02,
+        CaptureRead = 0x03,
+        CaptureArm = 0x04,
+        CaptureDisarm = 0x05
+    };
+
+    enum MemoryCommand{
+        MemoryRead = 0x01,
+        MemoryData = 0x02,
+        MemoryWrite = 0x03,
+        MemoryWriteData = 0x04,
+        MemoryAbort = 0x05
+    };
+
+    enum StatsCommand{
+        StatsRead = 0x00,
+        StatsReset = 0x01
+    };
+
+    enum ScheduleCommand{
+        ScheduleStatus = 0x00,
+        ScheduleAdd = 0x01,
+        ScheduleCommit = 0x02,
+        ScheduleCancel = 0x03,
+        ScheduleAllGroups = 0xFF   // group of ScheduleCancel for all groups
+    };
+
+    enum StimulusCommand{
+        StimulusStatus = 0x00,
+        StimulusConfig = 0x01,
+        StimulusStart = 0x02,
+        StimulusStop = 0x03
+    };
+
+    enum ValueFormat{           // format of a debug channel or capture trigger value
+        FormatUnsigned = 0x00,
+        FormatSigned = 0x01,
+        FormatFloat = 0x02
+    };
+
+    enum InfoRecord{
+        ChannelCount = 0x0B,       // nbr of debug channels (2 bytes), record types below are variable type sizes
+        ChannelEncodings = 0x0C,   // supported channel data encodings (bit 0: raw, bit 1: compact, bit 2: batched compact)
+        RateGroupCount = 0x0D,     // nbr of rate groups of the debug channels
+        TimeStampSize = 0x0E,      // nbr of bytes of the timestamp in the channel data (3 when omitted)
+        MemoryFragmentSize = 0x0F, // nbr of data bytes of a memory fragment (2 bytes), no memory transfers when omitted
+        MaxCommandDataSize = 0x10  // max nbr of cmd-data bytes of a message (2 bytes), no multi-register commands when omitted
+    };
+
+    enum ChannelEncoding{
+        EncodingRaw = 0x00,
+        EncodingCompact = 0x01,
+        EncodingBatched = 0x02     // only a capability bit, batching is set with the compact encoding
+    };
+
+    enum CompactFlags{
+        CompactKeyFrame = 0x80,
+        CompactContinued = 0x40,
+        CompactSequenceMask = 0x3F
     };
 
     enum class Source{
@@ -19,9 +19,50 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "PresentationLayerV0.h"
 #include "../DebugProtocolV0/DebugProtocolV0Enums.h"
 #include <QDebug>
+#include <QTimer>
 #include <QVector>
+#include <cstring>
 #include "Medium/CPU/CpuListModel.h"
 
+namespace
+{
+// Capabilities of the target, see Capabilities ('K') in the protocol specification
+const QString capabilityQuery = QStringLiteral("capability.query");
+const QString capabilityTrace = QStringLiteral("debug.signal.trace");
+const QString capabilityCompact = QStringLiteral("debug.signal.compact");
+const QString capabilityBatch = QStringLiteral("debug.signal.batch");
+const QString capabilityAggregate = QStringLiteral("debug.signal.aggregate");
+const QString capabilityRegisterBatch = QStringLiteral("debug.register.batch");
+const QString capabilityMemoryTransfer = QStringLiteral("debug.memory.transfer");
+const QString capabilityRegisterSchedule = QStringLiteral("debug.register.schedule");
+const QString capabilityStimulus = QStringLiteral("debug.stimulus");
+
+// Channel data is accepted again when the echo of ResetTime doesn't arrive in time (lost, or not sent by the target)
+const int timeResetTimeout_ms = 1000;
+
+// Varint: 7 bits per byte, LSB first, the MSB of a byte is set when more bytes follow
+quint64 readVarint(const QVector<uint8_t>& data, int& pos, bool& ok)
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= data.size())
+        {
+            ok = false;
+            return 0;
+        }
+        uint8_t byte = data[pos++];
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    ok = false;
+    return 0;
+}
+}
+
 PresentationLayerV0::PresentationLayerV0(CpuListModel& cpuListModel, RegisterListModel& registerListModel, QObject *parent) :
     PresentationLayerBase(cpuListModel,registerListModel, parent)
 {
@@ -57,11 +98,66 @@ void PresentationLayerV0::receivedDebugProtocolCommand(uint8_t uCID, QVector<uin
         receivedQueryRegister(uCID,protocolCommand);
         break;
     }
+    case DebugProtocolV0Enums::ProtocolCommand::QueryRegisters:
+    {
+        receivedQueryRegisters(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Decimation:
+    {
+        receivedDecimation(uCID,protocolCommand);
+        break;
+    }
     case DebugProtocolV0Enums::ProtocolCommand::ReadChannelData:
     {
         receivedReadChannelData(uCID,protocolCommand);
         break;
     }
+    case DebugProtocolV0Enums::ProtocolCommand::Capture:
+    {
+        receivedCapture(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Memory:
+    {
+        receivedMemory(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::CompactData:
+    {
+        receivedCompactData(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::ResetTime:
+    {
+        receivedResetTime(uCID);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::DebugString:
+    {
+        receivedDebugString(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Stats:
+    {
+        receivedStats(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Capabilities:
+    {
+        receivedCapabilities(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Schedule:
+    {
+        receivedSchedule(uCID,protocolCommand);
+        break;
+    }
+    case DebugProtocolV0Enums::ProtocolCommand::Stimulus:
+    {
+        receivedStimulus(uCID,protocolCommand);
+        break;
+    }
 
     default:
     {
@@ -102,12 +198,133 @@ void PresentationLayerV0::writeRegister(const Register &registerToWrite)
     emit newDebugProtocolCommand(registerToWrite.cpu().id(),newDebugProtocolMessage);
 }
 
+void PresentationLayerV0::queryRegisters(const QVector<const Register*>& registersToRead)
+{
+    // Group the Registers by Cpu, keeping their order
+    QMap<uint8_t, QVector<const Register*>> registersOfCpu;
+    for (const Register* reg : registersToRead)
+    {
+        registersOfCpu[reg->cpu().id()].append(reg);
+    }
+    for (auto it = registersOfCpu.constBegin(); it != registersOfCpu.constEnd(); ++it)
+    {
+        Cpu* cpu = m_cpuListModel.getCpuNodeById(it.key());
+        if (cpu != nullptr && cpu->maxCommandDataSize() > 0)
+        {
+            sendQueryRegisters(it.key(), it.value(), cpu->maxCommandDataSize());
+        }
+        else
+        {
+            for (const Register* reg : it.value())
+            {
+                queryRegister(*reg);
+            }
+        }
+    }
+}
+
+void PresentationLayerV0::writeRegisters(const QVector<const Register*>& registersToWrite)
+{
+    // Group the Registers by Cpu, keeping their order
+    QMap<uint8_t, QVector<const Register*>> registersOfCpu;
+    for (const Register* reg : registersToWrite)
+    {
+        registersOfCpu[reg->cpu().id()].append(reg);
+    }
+    for (auto it = registersOfCpu.constBegin(); it != registersOfCpu.constEnd(); ++it)
+    {
+        Cpu* cpu = m_cpuListModel.getCpuNodeById(it.key());
+        if (cpu != nullptr && cpu->maxCommandDataSize() > 0)
+        {
+            sendWriteRegisters(it.key(), it.value(), cpu->maxCommandDataSize());
+        }
+        else
+        {
+            for (const Register* reg : it.value())
+            {
+                writeRegister(*reg);
+            }
+        }
+    }
+}
+
+void PresentationLayerV0::sendQueryRegisters(uint8_t uCId, const QVector<const Register*>& registersToRead, int maxSize)
+{
+    // Query: tag and offset, control byte and size per Register, reply: tag, count and the packed values
+    int index = 0;
+    while (index < registersToRead.size())
+    {
+        QVector<uint8_t> debugProtocolMessage;
+        RegisterQuery query;
+        int replySize = 2;
+        uint8_t tag = m_registerQueryTag++;
+        debugProtocolMessage.append(DebugProtocolV0Enums::QueryRegisters);
+        debugProtocolMessage.append(tag);
+        while (index < registersToRead.size())
+        {
+            const Register* reg = registersToRead[index];
+            int size = reg->getVariableTypeSize();
+            if (!query.isEmpty() && (debugProtocolMessage.size() - 1 + 6 > maxSize || replySize + size > maxSize))
+            {
+                break;
+            }
+            append32BitValue(debugProtocolMessage, reg->offset());
+            debugProtocolMessage.append(controlByte(*reg));
+            debugProtocolMessage.append(static_cast<uint8_t>(size));
+            query.append(qMakePair(reg->offset(), size));
+            replySize += size;
+            index++;
+        }
+        m_registerQueries.insert(static_cast<quint16>(uCId << 8 | tag), query);
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    }
+}
+
+void PresentationLayerV0::sendWriteRegisters(uint8_t uCId, const QVector<const Register*>& registersToWrite, int maxSize)
+{
+    // Write: tag and offset, control byte, size and value per Register
+    int index = 0;
+    while (index < registersToWrite.size())
+    {
+        QVector<uint8_t> debugProtocolMessage;
+        int count = 0;
+        debugProtocolMessage.append(DebugProtocolV0Enums::WriteRegisters);
+        debugProtocolMessage.append(m_registerQueryTag++);
+        while (index < registersToWrite.size())
+        {
+            const Register* reg = registersToWrite[index];
+            QVector<uint8_t> value = reg->bytesFromValue(reg->value());
+            if (count > 0 && debugProtocolMessage.size() - 1 + 6 + value.size() > maxSize)
+            {
+                break;
+            }
+            append32BitValue(debugProtocolMessage, reg->offset());
+            debugProtocolMessage.append(controlByte(*reg));
+            debugProtocolMessage.append(static_cast<uint8_t>(value.size()));
+            debugProtocolMessage.append(value);
+            count++;
+            index++;
+        }
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    }
+}
+
 void PresentationLayerV0::resetTime(uint8_t uCId)
 {
     QVector<uint8_t> newDebugProtocolMessage;
     newDebugProtocolMessage.append(DebugProtocolV0Enums::ResetTime);
     emit newDebugProtocolCommand(uCId,newDebugProtocolMessage);
-
+    // The time line restarts when the echo arrives, channel data received before it still has the old time
+    quint32 tag = ++m_timeResetTag;
+    m_pendingTimeReset.insert(uCId, tag);
+    QTimer::singleShot(timeResetTimeout_ms, this, [this, uCId, tag]()
+    {
+        if (m_pendingTimeReset.value(uCId) == tag)
+        {
+            qWarning() << "No reply to reset time from uC: " << uCId;
+            receivedResetTime(uCId);
+        }
+    });
 }
 
 void PresentationLayerV0::configDebugChannel(Register &registerToConfigDebugChannel)
@@ -115,32 +332,38 @@ void PresentationLayerV0::configDebugChannel(Register &registerToConfigDebugChan
     QVector<uint8_t> newDebugProtocolMessage;
     newDebugProtocolMessage.append(DebugProtocolV0Enums::ConfigChannel);
     int debugChannel = registerToConfigDebugChannel.cpu().debugChannels().indexOf(&registerToConfigDebugChannel);
-    if (debugChannel >= 0)
+    if (debugChannel >= 0 && registerToConfigDebugChannel.channelMode() == Register::ChannelMode::Off)
     {
         //Debugchannel already exists. only need to change channelmode
         newDebugProtocolMessage.append(static_cast<uint8_t>(debugChannel));
         newDebugProtocolMessage.append(static_cast<uint8_t>(registerToConfigDebugChannel.channelMode()));
         emit newDebugProtocolCommand(registerToConfigDebugChannel.cpu().id(),newDebugProtocolMessage);
-
-        if (registerToConfigDebugChannel.channelMode() == Register::ChannelMode::Off)
-        {
-            registerToConfigDebugChannel.cpu().debugChannels().removeOne(&registerToConfigDebugChannel);
-        }
+        registerToConfigDebugChannel.cpu().debugChannels().removeOne(&registerToConfigDebugChannel);
     }
     else
     {
-        //Debugchannel does not exists.
-        debugChannel = registerToConfigDebugChannel.cpu().nextDebugChannel();
-        if(debugChannel >= 0)
+        //Debugchannel does not exists, or its mode or rate group changes: (re)configure it completely
+        if (debugChannel < 0)
         {
+            debugChannel = registerToConfigDebugChannel.cpu().nextDebugChannel();
+            if (debugChannel < 0)
+            {
+                return;
+            }
             registerToConfigDebugChannel.cpu().debugChannels().append(&registerToConfigDebugChannel);
-            newDebugProtocolMessage.append(static_cast<uint8_t>(debugChannel));
-            newDebugProtocolMessage.append(static_cast<uint8_t>(registerToConfigDebugChannel.channelMode()));
-            append32BitValue(newDebugProtocolMessage, registerToConfigDebugChannel.offset());
-            newDebugProtocolMessage.append(controlByte(registerToConfigDebugChannel));
-            newDebugProtocolMessage.append(registerToConfigDebugChannel.getVariableTypeSize());
-            emit newDebugProtocolCommand(registerToConfigDebugChannel.cpu().id(),newDebugProtocolMessage);
         }
+        newDebugProtocolMessage.append(static_cast<uint8_t>(debugChannel));
+        newDebugProtocolMessage.append(static_cast<uint8_t>(registerToConfigDebugChannel.channelMode()));
+        append32BitValue(newDebugProtocolMessage, registerToConfigDebugChannel.offset());
+        newDebugProtocolMessage.append(controlByte(registerToConfigDebugChannel));
+        newDebugProtocolMessage.append(registerToConfigDebugChannel.getVariableTypeSize());
+        newDebugProtocolMessage.append(valueFormat(registerToConfigDebugChannel));
+        newDebugProtocolMessage.append(static_cast<uint8_t>(registerToConfigDebugChannel.rateGroup()));
+        if (registerToConfigDebugChannel.cpu().hasCapability(capabilityAggregate))
+        {
+            newDebugProtocolMessage.append(aggregated(registerToConfigDebugChannel) ? 1 : 0);
+        }
+        emit newDebugProtocolCommand(registerToConfigDebugChannel.cpu().id(),newDebugProtocolMessage);
     }
 }
 
@@ -151,11 +374,24 @@ void PresentationLayerV0::getDecimation(uint8_t uCId)
     emit newDebugProtocolCommand(uCId, debugProtocolMessage);
 }
 
-void PresentationLayerV0::setDecimation(uint8_t uCId,int newDecimation)
+void PresentationLayerV0::setDecimation(uint8_t uCId, int newDecimation, const QVector<int>& rateGroupDecimations)
 {
     QVector<uint8_t> debugProtocolMessage;
     debugProtocolMessage.append(DebugProtocolV0Enums::Decimation);
-    debugProtocolMessage.append(toQVector(newDecimation));
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if (cpu == nullptr || !cpu->extendedDecimation())
+    {
+        // Targets without rate groups only accept the 1 byte decimation
+        debugProtocolMessage.append(static_cast<uint8_t>(qBound(1, newDecimation, 255)));
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+        return;
+    }
+    append32BitValue(debugProtocolMessage, static_cast<uint32_t>(newDecimation));
+    for (int rateGroupDecimation : rateGroupDecimations)
+    {
+        debugProtocolMessage.append(static_cast<uint8_t>(rateGroupDecimation));
+        debugProtocolMessage.append(static_cast<uint8_t>(rateGroupDecimation >> 8));
+    }
     emit newDebugProtocolCommand(uCId, debugProtocolMessage);
 }
 
@@ -200,8 +436,7 @@ void PresentationLayerV0::receivedGetVersion(uint8_t &uCId, const QVector<uint8_
         cpu->increaseMessageCounter();
         cpu->loadConfiguration();
         emit newCpuFound(cpu);
-        //Disable All Cpu debugChannels
-        disableAllConfigChannels(id,cpu->maxDebugChannels());
+        //The debugChannels are disabled when the GetInfo reply tells how many there are
         sendGetInfo(cpu->id());
     }
 }
@@ -260,135 +495,1182 @@ void PresentationLayerV0::receivedQueryRegister(uint8_t &uCId, const QVector<uin
     }
 }
 
-void PresentationLayerV0::receivedDecimation(uint8_t uCId, const QVector<uint8_t> &commandData)
+void PresentationLayerV0::receivedQueryRegisters(uint8_t uCId, const QVector<uint8_t> &commandData)
 {
+    if(commandData.size() < 2)
+    {
+        qWarning() << "Received query registers command from uC: " << uCId << " is invalid";
+        return;
+    }
+    quint16 key = static_cast<quint16>(uCId << 8 | commandData[0]);
+    if (!m_registerQueries.contains(key))
+    {
+        qWarning() << "Received query registers reply without query from uC: " << uCId;
+        return;
+    }
+    RegisterQuery query = m_registerQueries.take(key);
 
+    // Values are packed in the order of the query, the Registers that didn't fit are queried again
+    int count = qMin(static_cast<int>(commandData[1]), query.size());
+    int pos = 2;
+    QVector<const Register*> remaining;
+    for (int i = 0; i < query.size(); i++)
+    {
+        Register* reg = m_registerListModel.getRegisterByCpuIdAndOffset(uCId, query[i].first);
+        if (i >= count)
+        {
+            if (reg != nullptr)
+            {
+                remaining.append(reg);
+            }
+            continue;
+        }
+        if (pos + query[i].second > commandData.size())
+        {
+            qWarning() << "Received query registers reply from uC: " << uCId << " is too short";
+            break;
+        }
+        if (reg != nullptr)
+        {
+            reg->receivedNewRegisterValue(reg->valueFromBytes(commandData.mid(pos, query[i].second)));
+        }
+        pos += query[i].second;
+    }
+    if (count > 0 && !remaining.isEmpty())
+    {
+        queryRegisters(remaining);
+    }
 }
 
-void PresentationLayerV0::receivedReadChannelData(uint8_t uCId, QVector<uint8_t> &commandData)
+void PresentationLayerV0::receivedDecimation(uint8_t uCId, const QVector<uint8_t> &commandData)
 {
-    if(commandData.size() < 5)
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.isEmpty())
+    {
+        return;
+    }
+    // Older targets reply with a 1 byte decimation, newer with 4 bytes and the decimation of each rate group
+    if (commandData.size() < 4)
     {
-        qWarning() << "Received read channel datacommmand from uC: " << uCId << " is invalid";
+        cpu->receivedDecimation(commandData[0]);
     }
+    else
+    {
+        cpu->receivedDecimation(static_cast<int>(toValue<quint32>(commandData.mid(0,4))));
+        for (int i = 4; i + 1 < commandData.size(); i += 2)
+        {
+            cpu->receivedRateGroupDecimation((i - 4) / 2, commandData[i] | commandData[i + 1] << 8);
+        }
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::receivedReadChannelData(uint8_t uCId, QVector<uint8_t> &commandData)
+{
     Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
-    if(cpu != nullptr)
+    if(cpu != nullptr && !m_pendingTimeReset.contains(uCId))
     {
-        auto time = static_cast<int>(((commandData[2] << 16) | (commandData[1] << 8) | commandData[0]));
-        auto mask = toValue<uint8_t>(commandData.mid(3,2));
-        commandData.remove(0,5);
+        int maskSize = cpu->debugChannelMaskSize();
+        int timeSize = cpu->timeStampSize();
+        if(commandData.size() < timeSize + maskSize)
+        {
+            qWarning() << "Received read channel datacommmand from uC: " << uCId << " is invalid";
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+
+        quint64 time = 0;
+        for (int k = timeSize - 1; k >= 0; k--)
+        {
+            time = (time << 8) | commandData[k];
+        }
+        time = unwrapTime(*cpu, time, timeSize * 8);
+        QVector<uint8_t> mask = commandData.mid(timeSize,maskSize);
+        commandData.remove(0,timeSize + maskSize);
 
-        for (int i = cpu->debugChannels().size(); i >= 0 ; i--)
+        // Values are sent highest channel first, mask is LSB first
+        for (int i = maskSize * 8 - 1; i >= 0 ; i--)
         {
-            if ((mask >> i & 1) == 1)
+            if ((mask[i / 8] >> (i % 8) & 1) == 1)
             {
                 Register* reg = cpu->debugChannels().value(i);
-                if(reg != nullptr)
+                if(reg == nullptr)
                 {
-                    switch (reg->variableType())
-                    {
-                    case Register::VariableType::Bool:
-                    {
-                        reg->receivedNewRegisterValue(toValue<bool>(commandData.mid(0,reg->getVariableTypeSize())),time);
-                        break;
-                    }
-                    case Register::VariableType::Char:
-                    {
-                        reg->receivedNewRegisterValue(toValue<uint8_t>(commandData.mid(0,reg->getVariableTypeSize())),time);
-                        break;
-                    }
-                    default: break;
-                    }
-                    commandData.remove(commandData.size() - reg->getVariableTypeSize() ,reg->getVariableTypeSize());
+                    // Unknown size, the rest of the message can't be dispatched
+                    qWarning() << "Received channel data for unknown debug channel " << i << " from uC: " << uCId;
+                    return;
+                }
+                int size = reg->getVariableTypeSize();
+                if (aggregated(*reg))
+                {
+                    // Min, max and mean of the window
+                    reg->receivedNewEnvelope(reg->valueFromBytes(commandData.mid(0,size)),reg->valueFromBytes(commandData.mid(size,size)),
+                                             reg->valueFromBytes(commandData.mid(2 * size,size)),time);
+                    size *= 3;
                 }
+                else
+                {
+                    reg->receivedNewRegisterValue(reg->valueFromBytes(commandData.mid(0,size)),time);
+                }
+                commandData.remove(0,qMin(size,commandData.size()));
             }
         }
+        cpu->increaseMessageCounter();
     }
 }
 
-void PresentationLayerV0::receivedDebugString(uint8_t uCId, const QVector<uint8_t> &commandData)
+void PresentationLayerV0::receivedCompactData(uint8_t uCId, const QVector<uint8_t> &commandData)
 {
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || m_pendingTimeReset.contains(uCId))
+    {
+        return;
+    }
+    int maskSize = cpu->debugChannelMaskSize();
+    CompactChannelState& state = m_compactChannelState[uCId];
+    state.values.resize(maskSize * 8);
 
-}
+    bool ok = !commandData.isEmpty();
+    int pos = 0;
+    uint8_t flags = commandData.value(pos++);
+    bool keyFrame = (flags & DebugProtocolV0Enums::CompactKeyFrame) != 0;
 
-void PresentationLayerV0::receivedGetInfo(uint8_t uCId,QVector<uint8_t>& commandData)
-{
-    //Check if Cpu exists in list
-    qDebug() << "ReceivedGetInfo";
-    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    // A gap in the sequence numbers means a frame got lost, the values are only valid again after a key frame
+    int sequence = flags & DebugProtocolV0Enums::CompactSequenceMask;
+    if (state.sequence >= 0 && sequence != state.sequence)
+    {
+        state.synced = false;
+    }
+    state.sequence = (sequence + 1) & DebugProtocolV0Enums::CompactSequenceMask;
 
-    if(cpu != nullptr)
+    // A frame holds a record per tick (more than one when the target batches them), only the first can be a key frame
+    for (bool firstRecord = true; ok && pos < commandData.size(); firstRecord = false)
     {
-        // Check if message is too small
-        if (commandData.size() < 2)
+        bool keyRecord = keyFrame && firstRecord;
+
+        // Key frames hold the absolute time, the other records the time since the previous record
+        quint64 time = readVarint(commandData,pos,ok);
+        if (keyRecord)
         {
-            qWarning() << "Invalid GetInfo received";
-            cpu->increaseInvalidMessageCounter();
+            state.time = time;
+            state.synced = true;
+        }
+        else if (state.synced)
+        {
+            state.time += time;
         }
         else
         {
-            QVector<uint8_t> record;
-            for (QVector<uint8_t>::iterator it=commandData.begin(); it != commandData.end(); ++it)
+            return;
+        }
+
+        if(!ok || commandData.size() < pos + maskSize)
+        {
+            qWarning() << "Received compact channel data from uC: " << uCId << " is invalid";
+            cpu->increaseInvalidMessageCounter();
+            state.synced = false;
+            return;
+        }
+        QVector<uint8_t> mask = commandData.mid(pos,maskSize);
+        pos += maskSize;
+        quint64 recordTime = unwrapTime(*cpu, state.time, 64);
+
+        // Values are sent highest channel first, mask is LSB first
+        for (int i = maskSize * 8 - 1; i >= 0 ; i--)
+        {
+            if ((mask[i / 8] >> (i % 8) & 1) == 1)
             {
-                if (*it == DebugProtocolV0Enums::ProtocolChar::RS || it == commandData.end())
+                Register* reg = cpu->debugChannels().value(i);
+                if(reg == nullptr)
                 {
-                    if (record[0] == static_cast<uint8_t>(Register::VariableType::TimeStamp))
+                    qWarning() << "Received channel data for unknown debug channel " << i << " from uC: " << uCId;
+                    state.synced = false;
+                    return;
+                }
+                int size = reg->getVariableTypeSize();
+                // An aggregated channel holds min, max and mean, each relative to the value before it
+                int count = aggregated(*reg) ? 3 : 1;
+                QVector<QVariant> values;
+                for (int n = 0; n < count; n++)
+                {
+                    quint64 value = 0;
+                    if (keyRecord || size == 0 || size > 8)
                     {
-                        //Timestamp is 4 byte
-                        cpu->setVariableTypeSize(Register::VariableType::TimeStamp,int(record[4] << 24 | record[3] << 16 | record[2] << 8 | record[1]));
+                        // Raw value (little endian)
+                        for (int k = qMin(size,8) - 1; k >= 0; k--)
+                        {
+                            value = (value << 8) | commandData.value(pos + k);
+                        }
+                        pos += size;
                     }
                     else
                     {
-                        //Everything else is 1 byte.
-                        cpu->setVariableTypeSize(static_cast<Register::VariableType>(record[0]),record[1]);
+                        quint64 delta = readVarint(commandData,pos,ok);
+                        if (valueFormat(*reg) == DebugProtocolV0Enums::FormatFloat)
+                        {
+                            // XOR with the previous value
+                            value = state.values[i] ^ delta;
+                        }
+                        else
+                        {
+                            // Zig-zag encoded difference with the previous value
+                            value = state.values[i] + ((delta >> 1) ^ (~(delta & 1) + 1));
+                        }
+                    }
+                    if (!ok || pos > commandData.size())
+                    {
+                        qWarning() << "Received compact channel data from uC: " << uCId << " is too short";
+                        cpu->increaseInvalidMessageCounter();
+                        state.synced = false;
+                        return;
+                    }
+                    if (size < 8)
+                    {
+                        value &= (static_cast<quint64>(1) << (size * 8)) - 1;
                     }
-                    record.clear();
+                    state.values[i] = value;
+
+                    QVector<uint8_t> bytes;
+                    for (int k = 0; k < size; k++)
+                    {
+                        bytes.append(static_cast<uint8_t>(k < 8 ? value >> (k * 8) : 0));
+                    }
+                    values.append(reg->valueFromBytes(bytes));
+                }
+                if (count == 3)
+                {
+                    reg->receivedNewEnvelope(values[0],values[1],values[2],recordTime);
                 }
                 else
                 {
-                    record.append(*it);
+                    reg->receivedNewRegisterValue(values[0],recordTime);
                 }
             }
-            cpu->increaseMessageCounter();;
         }
     }
+    cpu->increaseMessageCounter();
 }
 
+void PresentationLayerV0::startCapture(uint8_t uCId, int decimation)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+    debugProtocolMessage.append(DebugProtocolV0Enums::CaptureStart);
+    debugProtocolMessage.append(static_cast<uint8_t>(decimation));
+    debugProtocolMessage.append(static_cast<uint8_t>(decimation >> 8));
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
 
-void PresentationLayerV0::sendGetVersion(uint8_t uCId)
+void PresentationLayerV0::stopCapture(uint8_t uCId)
 {
     QVector<uint8_t> debugProtocolMessage;
-    debugProtocolMessage.append(DebugProtocolV0Enums::GetVersion);
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+    debugProtocolMessage.append(DebugProtocolV0Enums::CaptureStop);
     emit newDebugProtocolCommand(uCId, debugProtocolMessage);
 }
 
-void PresentationLayerV0::sendGetInfo(uint8_t uCId)
+void PresentationLayerV0::armCapture(uint8_t uCId, int decimation)
 {
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr)
+    {
+        return;
+    }
+    const Capture::Trigger& trigger = cpu->capture().trigger();
+    int debugChannel = cpu->debugChannels().indexOf(trigger.reg);
+    if(debugChannel < 0)
+    {
+        qWarning() << "Capture trigger needs a register that is a debug channel";
+        return;
+    }
+
     QVector<uint8_t> debugProtocolMessage;
-    debugProtocolMessage.append(DebugProtocolV0Enums::GetInfo);
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+    debugProtocolMessage.append(DebugProtocolV0Enums::CaptureArm);
+    debugProtocolMessage.append(static_cast<uint8_t>(debugChannel));
+    debugProtocolMessage.append(static_cast<uint8_t>(trigger.mode));
+    debugProtocolMessage.append(valueFormat(*trigger.reg));
+    QVector<uint8_t> level = trigger.reg->bytesFromValue(trigger.level);
+    level.resize(8);
+    debugProtocolMessage.append(level);
+    append32BitValue(debugProtocolMessage, static_cast<uint32_t>(trigger.preCount));
+    append32BitValue(debugProtocolMessage, static_cast<uint32_t>(trigger.postCount));
+    debugProtocolMessage.append(static_cast<uint8_t>(decimation));
+    debugProtocolMessage.append(static_cast<uint8_t>(decimation >> 8));
     emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
 
+void PresentationLayerV0::disarmCapture(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+    debugProtocolMessage.append(DebugProtocolV0Enums::CaptureDisarm);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
 }
 
-void PresentationLayerV0::disableAllConfigChannels(uint8_t uCId, uint8_t nbrOfConfigChannels)
+void PresentationLayerV0::uploadCapture(uint8_t uCId)
 {
-    QVector<uint8_t> newDebugProtocolMessage;
-    for(int i = 0; i < nbrOfConfigChannels; i++)
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu != nullptr)
     {
-        newDebugProtocolMessage.append(DebugProtocolV0Enums::ConfigChannel);
-        newDebugProtocolMessage.append(static_cast<uint8_t>(i));
-        newDebugProtocolMessage.append(static_cast<uint8_t>(Register::ChannelMode::Off));
-        emit newDebugProtocolCommand(uCId,newDebugProtocolMessage);
-        newDebugProtocolMessage.clear();
+        //The upload starts when the status reply tells the capture is done
+        cpu->capture().requestUpload();
+        sendCaptureStatus(uCId);
     }
 }
 
-uint8_t PresentationLayerV0::controlByte(const Register &Register)
+void PresentationLayerV0::sendCaptureStatus(uint8_t uCId)
 {
-    uint8_t control = 0;
-    control |= Register.readWrite() == Register::ReadWrite::Write ? 0x80 : 0x00;
-    control |= static_cast<uint8_t>(Register.source());
-    control |= (Register.derefDepth() & 0x0F);
-    return control;
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+    debugProtocolMessage.append(DebugProtocolV0Enums::CaptureStatus);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
 }
 
+void PresentationLayerV0::sendCaptureReads(uint8_t uCId, Capture& capture)
+{
+    int offset;
+    while ((offset = capture.nextRequest()) >= 0)
+    {
+        QVector<uint8_t> debugProtocolMessage;
+        debugProtocolMessage.append(DebugProtocolV0Enums::Capture);
+        debugProtocolMessage.append(DebugProtocolV0Enums::CaptureRead);
+        append32BitValue(debugProtocolMessage, static_cast<uint32_t>(offset));
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    }
+}
+
+void PresentationLayerV0::receivedCapture(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.size() < 2)
+    {
+        qWarning() << "Received capture command from uC: " << uCId << " is invalid";
+        return;
+    }
+
+    switch(commandData[0])
+    {
+    case DebugProtocolV0Enums::CaptureStatus:
+    {
+        int maskSize = cpu->debugChannelMaskSize();
+        if(commandData.size() < 12 + maskSize)
+        {
+            qWarning() << "Received capture status from uC: " << uCId << " is invalid";
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        int recordSize = commandData[2] | commandData[3] << 8;
+        int recordCount = static_cast<int>(toValue<quint32>(commandData.mid(4,4)));
+
+        //Captured channels, highest channel first (same order as the values in a record)
+        QVector<Register*> channels;
+        for (int i = maskSize * 8 - 1; i >= 0 ; i--)
+        {
+            if ((commandData[8 + i / 8] >> (i % 8) & 1) == 1)
+            {
+                channels.append(cpu->debugChannels().value(i));
+            }
+        }
+        quint32 triggerIndex = toValue<quint32>(commandData.mid(8 + maskSize,4));
+        Capture::State state = static_cast<Capture::State>(commandData[1]);
+        cpu->capture().setStatus(state,recordSize,recordCount,channels,
+                                 triggerIndex == 0xFFFFFFFF ? -1 : static_cast<int>(triggerIndex));
+
+        if (cpu->capture().isUploadRequested() && state == Capture::State::Done)
+        {
+            if (cpu->capture().startUpload())
+            {
+                sendCaptureReads(uCId, cpu->capture());
+            }
+        }
+        break;
+    }
+    case DebugProtocolV0Enums::CaptureStart:
+    case DebugProtocolV0Enums::CaptureArm:
+    {
+        if (commandData[1] != 0)
+        {
+            qWarning() << "Capture could not be started on uC: " << uCId;
+        }
+        sendCaptureStatus(uCId);
+        break;
+    }
+    case DebugProtocolV0Enums::CaptureStop:
+    case DebugProtocolV0Enums::CaptureDisarm:
+    {
+        sendCaptureStatus(uCId);
+        break;
+    }
+    case DebugProtocolV0Enums::CaptureRead:
+    {
+        if(commandData.size() < 5)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        cpu->capture().receivedData(toValue<quint32>(commandData.mid(1,4)), commandData.mid(5));
+        sendCaptureReads(uCId, cpu->capture());
+        break;
+    }
+    default: break;
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::readMemory(uint8_t uCId)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu != nullptr && cpu->memoryTransfer().direction() == MemoryTransfer::Direction::Read)
+    {
+        sendMemoryRequest(uCId, cpu->memoryTransfer(), DebugProtocolV0Enums::MemoryRead);
+    }
+}
+
+void PresentationLayerV0::writeMemory(uint8_t uCId)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || cpu->memoryTransfer().direction() != MemoryTransfer::Direction::Write)
+    {
+        return;
+    }
+
+    //The fragments are sent when the target accepted the write
+    if (cpu->memoryTransfer().isStarted())
+    {
+        sendMemoryWrites(uCId, cpu->memoryTransfer());
+    }
+    else
+    {
+        sendMemoryRequest(uCId, cpu->memoryTransfer(), DebugProtocolV0Enums::MemoryWrite);
+    }
+}
+
+void PresentationLayerV0::sendMemoryRequest(uint8_t uCId, MemoryTransfer& transfer, uint8_t command)
+{
+    if (transfer.reg() == nullptr)
+    {
+        qWarning() << "Memory transfer needs a register for its address";
+        transfer.abort();
+        return;
+    }
+
+    //Block starts at the address of the register, the remainder is requested from the next position
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Memory);
+    debugProtocolMessage.append(command);
+    append32BitValue(debugProtocolMessage, transfer.reg()->offset());
+    debugProtocolMessage.append(controlByte(*transfer.reg()));
+    append32BitValue(debugProtocolMessage, transfer.nextPosition());
+    append32BitValue(debugProtocolMessage, static_cast<uint32_t>(transfer.bytesRemaining()));
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    transfer.requested();
+}
+
+void PresentationLayerV0::sendMemoryWrites(uint8_t uCId, MemoryTransfer& transfer)
+{
+    QVector<uint8_t> fragment;
+    while (!(fragment = transfer.nextWriteFragment()).isEmpty())
+    {
+        QVector<uint8_t> debugProtocolMessage;
+        debugProtocolMessage.append(DebugProtocolV0Enums::Memory);
+        debugProtocolMessage.append(DebugProtocolV0Enums::MemoryWriteData);
+        debugProtocolMessage.append(fragment);
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    }
+}
+
+void PresentationLayerV0::receivedMemory(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.size() < 2)
+    {
+        qWarning() << "Received memory command from uC: " << uCId << " is invalid";
+        return;
+    }
+
+    MemoryTransfer& transfer = cpu->memoryTransfer();
+    switch(commandData[0])
+    {
+    case DebugProtocolV0Enums::MemoryRead:
+    case DebugProtocolV0Enums::MemoryWrite:
+    {
+        //Result and fragment size, the fragments of a read follow
+        if(commandData.size() < 4)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        transfer.started(static_cast<MemoryTransfer::Result>(commandData[1]), commandData[2] | commandData[3] << 8);
+        if (commandData[0] == DebugProtocolV0Enums::MemoryWrite)
+        {
+            sendMemoryWrites(uCId, transfer);
+        }
+        break;
+    }
+    case DebugProtocolV0Enums::MemoryData:
+    {
+        //A lost or corrupted fragment: the remainder is requested again
+        if (!transfer.receivedFragment(commandData.mid(1)))
+        {
+            cpu->increaseInvalidMessageCounter();
+            readMemory(uCId);
+            return;
+        }
+        emit memoryTransferProgress(*cpu, transfer.bytesDone(), transfer.data().size());
+        break;
+    }
+    case DebugProtocolV0Enums::MemoryWriteData:
+    {
+        //Next expected sequence number and the result of the fragment
+        if(commandData.size() < 4)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        transfer.receivedWriteAck(static_cast<quint16>(commandData[1] | commandData[2] << 8),
+                                  static_cast<MemoryTransfer::Result>(commandData[3]));
+        emit memoryTransferProgress(*cpu, transfer.bytesDone(), transfer.data().size());
+        sendMemoryWrites(uCId, transfer);
+        break;
+    }
+    default: break;
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::readStats(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stats);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StatsRead);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::resetStats(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stats);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StatsReset);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::receivedStats(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.size() < 1)
+    {
+        qWarning() << "Received stats command from uC: " << uCId << " is invalid";
+        return;
+    }
+
+    switch(commandData[0])
+    {
+    case DebugProtocolV0Enums::StatsRead:
+    {
+        //Cycles per second and the nbr of phases, 16 bytes per phase and 4 counters
+        if(commandData.size() < 6 || commandData.size() < 6 + commandData[5] * 16 + 16)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        Cpu::DebuggerStats stats;
+        stats.cyclesPerSecond = toValue<quint32>(commandData.mid(1,4));
+        int index = 6;
+        for (int i = 0; i < commandData[5]; i++, index += 16)
+        {
+            Cpu::DebuggerStats::PhaseCycles phase;
+            phase.count = toValue<quint32>(commandData.mid(index,4));
+            phase.min = toValue<quint32>(commandData.mid(index + 4,4));
+            phase.max = toValue<quint32>(commandData.mid(index + 8,4));
+            phase.avg = toValue<quint32>(commandData.mid(index + 12,4));
+            stats.phases.append(phase);
+        }
+        stats.rxBytes = toValue<quint32>(commandData.mid(index,4));
+        stats.rxDropped = toValue<quint32>(commandData.mid(index + 4,4));
+        stats.txBytes = toValue<quint32>(commandData.mid(index + 8,4));
+        stats.txDropped = toValue<quint32>(commandData.mid(index + 12,4));
+        // The decoder errors follow (not sent by older targets)
+        if (commandData.size() >= index + 24)
+        {
+            stats.framingErrors = toValue<quint32>(commandData.mid(index + 16,4));
+            stats.crcErrors = toValue<quint32>(commandData.mid(index + 20,4));
+        }
+        cpu->receivedStats(stats);
+        break;
+    }
+    case DebugProtocolV0Enums::StatsReset:
+    {
+        //Show the cleared statistics
+        readStats(uCId);
+        break;
+    }
+    default: break;
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::commitSchedule(uint8_t uCId)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if (cpu == nullptr || !cpu->hasCapability(capabilityRegisterSchedule))
+    {
+        qWarning() << "Cpu" << uCId << "doesn't support scheduled writes";
+        return;
+    }
+
+    //The steps are sent to the groups that are free, which needs the status of the target first
+    if (cpu->schedule().hasStatus())
+    {
+        sendScheduleSteps(uCId, cpu->schedule(), cpu->maxCommandDataSize());
+    }
+    else
+    {
+        readSchedule(uCId);
+    }
+}
+
+void PresentationLayerV0::cancelSchedule(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Schedule);
+    debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleCancel);
+    debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleAllGroups);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    readSchedule(uCId);
+}
+
+void PresentationLayerV0::readSchedule(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Schedule);
+    debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleStatus);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::sendScheduleSteps(uint8_t uCId, Schedule& schedule, int maxSize)
+{
+    // Add: sub-command and group, per write offset, control byte, size and value. The commit follows
+    // right behind the adds: when an add fails, the target discards the group and refuses its later adds
+    // and the commit until the group is cancelled, so the commit never arms half a step
+    quint64 tick;
+    QVector<Schedule::Write> writes;
+    int group;
+    while ((group = schedule.takeNextStep(tick, writes)) >= 0)
+    {
+        int index = 0;
+        while (index < writes.size())
+        {
+            QVector<uint8_t> debugProtocolMessage;
+            debugProtocolMessage.append(DebugProtocolV0Enums::Schedule);
+            debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleAdd);
+            debugProtocolMessage.append(static_cast<uint8_t>(group));
+            int count = 0;
+            while (index < writes.size())
+            {
+                const Schedule::Write& write = writes[index];
+                if (count > 0 && debugProtocolMessage.size() - 1 + 6 + write.value.size() > maxSize)
+                {
+                    break;
+                }
+                append32BitValue(debugProtocolMessage, write.reg->offset());
+                debugProtocolMessage.append(controlByte(*write.reg));
+                debugProtocolMessage.append(static_cast<uint8_t>(write.value.size()));
+                debugProtocolMessage.append(write.value);
+                count++;
+                index++;
+            }
+            emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+        }
+
+        QVector<uint8_t> debugProtocolMessage;
+        debugProtocolMessage.append(DebugProtocolV0Enums::Schedule);
+        debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleCommit);
+        debugProtocolMessage.append(static_cast<uint8_t>(group));
+        append32BitValue(debugProtocolMessage, static_cast<uint32_t>(tick));
+        emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+    }
+}
+
+void PresentationLayerV0::receivedSchedule(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.size() < 1)
+    {
+        qWarning() << "Received schedule command from uC: " << uCId << " is invalid";
+        return;
+    }
+
+    Schedule& schedule = cpu->schedule();
+    switch(commandData[0])
+    {
+    case DebugProtocolV0Enums::ScheduleStatus:
+    {
+        //Current tick, free writes and the nbr of groups, then state, tick and nbr of writes per group
+        if(commandData.size() < 7 || commandData.size() < 7 + commandData[6] * 6)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        QVector<Schedule::Group> groups;
+        for (int i = 0, index = 7; i < commandData[6]; i++, index += 6)
+        {
+            Schedule::Group group;
+            group.state = static_cast<Schedule::GroupState>(commandData[index]);
+            group.tick = toValue<quint32>(commandData.mid(index + 1,4));
+            group.writeCount = commandData[index + 5];
+            groups.append(group);
+        }
+        schedule.setStatus(toValue<quint32>(commandData.mid(1,4)), commandData[5], groups);
+
+        //Groups that were applied make room for the steps that are waiting
+        sendScheduleSteps(uCId, schedule, cpu->maxCommandDataSize());
+        break;
+    }
+    case DebugProtocolV0Enums::ScheduleAdd:
+    {
+        //Group, result and the nbr of writes that were added
+        if(commandData.size() < 4)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        schedule.added(commandData[1], static_cast<Schedule::Result>(commandData[2]));
+        break;
+    }
+    case DebugProtocolV0Enums::ScheduleCommit:
+    {
+        //Group, result and the current tick
+        if(commandData.size() < 7)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        //A refused group may still hold writes (or refuse adds after a failed add), it is cancelled before it is used again
+        if (schedule.committed(commandData[1], static_cast<Schedule::Result>(commandData[2]), toValue<quint32>(commandData.mid(3,4))))
+        {
+            QVector<uint8_t> debugProtocolMessage;
+            debugProtocolMessage.append(DebugProtocolV0Enums::Schedule);
+            debugProtocolMessage.append(DebugProtocolV0Enums::ScheduleCancel);
+            debugProtocolMessage.append(commandData[1]);
+            emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+        }
+        break;
+    }
+    default: break;
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::startStimulus(uint8_t uCId)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if (cpu == nullptr || !cpu->hasCapability(capabilityStimulus) || cpu->stimulus().reg() == nullptr)
+    {
+        qWarning() << "Cpu" << uCId << "doesn't support a stimulus";
+        return;
+    }
+
+    //The phase-steps of the waveform follow from the time between two samples
+    const Stimulus& stimulus = cpu->stimulus();
+    const Stimulus::Settings& settings = stimulus.settings();
+    const Register& reg = *stimulus.reg();
+    int tick_us = cpu->getVariableTypeSize(Register::VariableType::TimeStamp);
+    quint32 param1;
+    quint32 param2;
+    if (!stimulus.waveParameters(tick_us * 1e-6 * qMax(1, settings.decimation), param1, param2))
+    {
+        qWarning() << "Cpu" << uCId << "has no tick time for the stimulus";
+        return;
+    }
+
+    // Config: waveform, register (offset, control byte, size and format), decimation, period, samples,
+    // offset and amplitude (float), waveform parameters
+    float offset = static_cast<float>(settings.offset);
+    float amplitude = static_cast<float>(settings.amplitude);
+    quint32 value;
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stimulus);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StimulusConfig);
+    debugProtocolMessage.append(static_cast<uint8_t>(settings.waveform));
+    append32BitValue(debugProtocolMessage, reg.offset());
+    debugProtocolMessage.append(controlByte(reg));
+    debugProtocolMessage.append(reg.getVariableTypeSize());
+    debugProtocolMessage.append(valueFormat(reg));
+    debugProtocolMessage.append(static_cast<uint8_t>(qBound(1, settings.decimation, 0xFFFF) & 0xFF));
+    debugProtocolMessage.append(static_cast<uint8_t>(qBound(1, settings.decimation, 0xFFFF) >> 8));
+    append32BitValue(debugProtocolMessage, settings.period);
+    append32BitValue(debugProtocolMessage, settings.samples);
+    memcpy(&value, &offset, 4);
+    append32BitValue(debugProtocolMessage, value);
+    memcpy(&value, &amplitude, 4);
+    append32BitValue(debugProtocolMessage, value);
+    append32BitValue(debugProtocolMessage, param1);
+    append32BitValue(debugProtocolMessage, param2);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+
+    // Start: the tick of the first sample, or the next tick
+    debugProtocolMessage.clear();
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stimulus);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StimulusStart);
+    if (stimulus.startTick() > 0)
+    {
+        append32BitValue(debugProtocolMessage, static_cast<uint32_t>(stimulus.startTick()));
+    }
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::stopStimulus(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stimulus);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StimulusStop);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::readStimulus(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Stimulus);
+    debugProtocolMessage.append(DebugProtocolV0Enums::StimulusStatus);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::receivedStimulus(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr || commandData.size() < 2)
+    {
+        qWarning() << "Received stimulus command from uC: " << uCId << " is invalid";
+        return;
+    }
+
+    Stimulus& stimulus = cpu->stimulus();
+    switch(commandData[0])
+    {
+    case DebugProtocolV0Enums::StimulusStatus:
+    {
+        //State, tick of the first sample, played samples and the size of the table
+        if(commandData.size() < 14)
+        {
+            cpu->increaseInvalidMessageCounter();
+            return;
+        }
+        stimulus.setStatus(static_cast<Stimulus::State>(commandData[1]), toValue<quint32>(commandData.mid(2,4)),
+                           toValue<quint32>(commandData.mid(6,4)), static_cast<int>(toValue<quint32>(commandData.mid(10,4))));
+        break;
+    }
+    case DebugProtocolV0Enums::StimulusConfig:
+    case DebugProtocolV0Enums::StimulusStart:
+    {
+        stimulus.setResult(static_cast<Stimulus::Result>(commandData[1]));
+        break;
+    }
+    default: break;
+    }
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::receivedResetTime(uint8_t uCId)
+{
+    // The target restarted its time (and sends a key frame next), the old time line and compact values are void
+    m_pendingTimeReset.remove(uCId);
+    m_timeLine.remove(uCId);
+    m_compactChannelState.remove(uCId);
+}
+
+void PresentationLayerV0::receivedDebugString(uint8_t uCId, const QVector<uint8_t> &commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr)
+    {
+        return;
+    }
+    QByteArray text;
+    for (uint8_t c : commandData)
+    {
+        text.append(static_cast<char>(c));
+    }
+    cpu->receivedDebugString(QString::fromLatin1(text));
+    cpu->increaseMessageCounter();
+}
+
+void PresentationLayerV0::receivedGetInfo(uint8_t uCId,QVector<uint8_t>& commandData)
+{
+    //Check if Cpu exists in list
+    qDebug() << "ReceivedGetInfo";
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+
+    if(cpu != nullptr)
+    {
+        // Check if message is too small
+        if (commandData.size() < 2)
+        {
+            qWarning() << "Invalid GetInfo received";
+            cpu->increaseInvalidMessageCounter();
+        }
+        else
+        {
+            // Records are type, size_n and a separator. size_n is 1 byte, except for
+            // the known types below, so a value that equals the separator is not a separator.
+            int pos = 0;
+            while (pos < commandData.size())
+            {
+                uint8_t type = commandData[pos++];
+                int valueSize = 1;
+                if (type == static_cast<uint8_t>(Register::VariableType::TimeStamp))
+                {
+                    valueSize = 4;
+                }
+                else if (type == DebugProtocolV0Enums::InfoRecord::ChannelCount ||
+                         type == DebugProtocolV0Enums::InfoRecord::MemoryFragmentSize ||
+                         type == DebugProtocolV0Enums::InfoRecord::MaxCommandDataSize)
+                {
+                    valueSize = 2;
+                }
+                QVector<uint8_t> value = commandData.mid(pos,valueSize);
+                pos += valueSize;
+
+                if (value.size() == valueSize)
+                {
+                    if (type == static_cast<uint8_t>(Register::VariableType::TimeStamp))
+                    {
+                        //Timestamp is 4 byte
+                        cpu->setVariableTypeSize(Register::VariableType::TimeStamp,int(value[3] << 24 | value[2] << 16 | value[1] << 8 | value[0]));
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::ChannelCount)
+                    {
+                        cpu->setMaxDebugChannels(int(value[1] << 8 | value[0]));
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::ChannelEncodings)
+                    {
+                        cpu->setCompactChannelData((value[0] & (1 << DebugProtocolV0Enums::EncodingCompact)) != 0);
+                        cpu->setBatchedChannelData((value[0] & (1 << DebugProtocolV0Enums::EncodingBatched)) != 0);
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::RateGroupCount)
+                    {
+                        cpu->setRateGroupCount(value[0]);
+                        cpu->setExtendedDecimation(true);
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::TimeStampSize)
+                    {
+                        cpu->setTimeStampSize(qBound(1, static_cast<int>(value[0]), 8));
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::MemoryFragmentSize)
+                    {
+                        cpu->setMemoryFragmentSize(int(value[1] << 8 | value[0]));
+                    }
+                    else if (type == DebugProtocolV0Enums::InfoRecord::MaxCommandDataSize)
+                    {
+                        cpu->setMaxCommandDataSize(int(value[1] << 8 | value[0]));
+                    }
+                    else if (type < static_cast<uint8_t>(Register::VariableType::Unknown))
+                    {
+                        //Everything else is 1 byte.
+                        cpu->setVariableTypeSize(static_cast<Register::VariableType>(type),value[0]);
+                    }
+                }
+
+                // Skip to the next record (also skips unknown records)
+                while (pos < commandData.size() && commandData[pos++] != DebugProtocolV0Enums::ProtocolChar::RS) {}
+            }
+            cpu->increaseMessageCounter();
+        }
+        //The capabilities of the Cpu decide over the GetInfo records, firmware without them replies without data
+        cpu->clearCapabilities();
+        sendCapabilityQuery(uCId, 0);
+    }
+}
+
+void PresentationLayerV0::sendCapabilityQuery(uint8_t uCId, uint8_t firstCapability)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::Capabilities);
+    debugProtocolMessage.append(firstCapability);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::receivedCapabilities(uint8_t uCId, const QVector<uint8_t>& commandData)
+{
+    Cpu* cpu = m_cpuListModel.getCpuNodeById(uCId);
+    if(cpu == nullptr)
+    {
+        qWarning() << "Received capabilities from unknown uC: " << uCId;
+        return;
+    }
+    if(commandData.size() < 2)
+    {
+        //Firmware without capabilities: the GetInfo records hold the limits
+        negotiate(*cpu);
+        return;
+    }
+
+    //Index of the first capability and the total, then name size, name, data size and data of each capability
+    int next = commandData[0];
+    int total = commandData[1];
+    int pos = 2;
+    while (pos < commandData.size())
+    {
+        int nameSize = commandData[pos++];
+        QVector<uint8_t> name = commandData.mid(pos, nameSize);
+        pos += nameSize;
+        int dataSize = commandData.value(pos++);
+        QVector<uint8_t> data = commandData.mid(pos, dataSize);
+        pos += dataSize;
+        if (name.size() != nameSize || data.size() != dataSize)
+        {
+            cpu->increaseInvalidMessageCounter();
+            break;
+        }
+        cpu->setCapability(QString::fromLatin1(reinterpret_cast<const char*>(name.constData()), nameSize), data);
+        next++;
+    }
+    cpu->increaseMessageCounter();
+
+    //Ask for the capabilities that didn't fit, a reply without any capability ends the query
+    if (next < total && next > commandData[0])
+    {
+        sendCapabilityQuery(uCId, static_cast<uint8_t>(next));
+    }
+    else
+    {
+        negotiate(*cpu);
+    }
+}
+
+void PresentationLayerV0::negotiate(Cpu& cpu)
+{
+    //Use the limits of the capabilities, and the fastest modes the Cpu supports
+    if (cpu.hasCapability(capabilityQuery))
+    {
+        QVector<uint8_t> trace = cpu.capability(capabilityTrace);
+        if (trace.size() >= 4)
+        {
+            cpu.setMaxDebugChannels(trace[0] | trace[1] << 8);
+            cpu.setRateGroupCount(trace[2]);
+            cpu.setExtendedDecimation(true);
+            cpu.setTimeStampSize(qBound(1, static_cast<int>(trace[3]), 8));
+        }
+        cpu.setCompactChannelData(cpu.hasCapability(capabilityCompact));
+        cpu.setBatchedChannelData(cpu.hasCapability(capabilityCompact) && cpu.hasCapability(capabilityBatch));
+        QVector<uint8_t> memory = cpu.capability(capabilityMemoryTransfer);
+        cpu.setMemoryFragmentSize(memory.size() >= 2 ? memory[0] | memory[1] << 8 : 0);
+        QVector<uint8_t> registerBatch = cpu.capability(capabilityRegisterBatch);
+        cpu.setMaxCommandDataSize(registerBatch.size() >= 2 ? registerBatch[0] | registerBatch[1] << 8 : 0);
+    }
+
+    //Disable All Cpu debugChannels
+    disableAllConfigChannels(cpu.id(),cpu.maxDebugChannels());
+    //Use the compact channel data when the Cpu supports it
+    m_compactChannelState.remove(cpu.id());
+    m_timeLine.remove(cpu.id());
+    m_pendingTimeReset.remove(cpu.id());
+    if (cpu.compactChannelData())
+    {
+        sendChannelDataEncoding(cpu);
+    }
+    //Get the decimation of the Cpu and its rate groups
+    getDecimation(cpu.id());
+}
+
+void PresentationLayerV0::sendChannelDataEncoding(Cpu& cpu)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::ReadChannelData);
+    debugProtocolMessage.append(static_cast<uint8_t>(DebugProtocolV0Enums::TraceMode::On));
+    debugProtocolMessage.append(cpu.compactChannelData() ? DebugProtocolV0Enums::EncodingCompact : DebugProtocolV0Enums::EncodingRaw);
+    if (cpu.compactChannelData() && cpu.batchedChannelData())
+    {
+        // Collect up to channelBatchTicks ticks per frame, the latency is in debug ticks
+        int tick_us = qMax(1, cpu.getVariableTypeSize(Register::VariableType::TimeStamp));
+        int latency = qBound(0, cpu.channelBatchLatency_ms() * 1000 / tick_us, 0xFFFF);
+        debugProtocolMessage.append(static_cast<uint8_t>(qBound(1, cpu.channelBatchTicks(), 255)));
+        debugProtocolMessage.append(static_cast<uint8_t>(latency));
+        debugProtocolMessage.append(static_cast<uint8_t>(latency >> 8));
+    }
+    emit newDebugProtocolCommand(cpu.id(), debugProtocolMessage);
+}
+
+
+void PresentationLayerV0::sendGetVersion(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::GetVersion);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+}
+
+void PresentationLayerV0::sendGetInfo(uint8_t uCId)
+{
+    QVector<uint8_t> debugProtocolMessage;
+    debugProtocolMessage.append(DebugProtocolV0Enums::GetInfo);
+    emit newDebugProtocolCommand(uCId, debugProtocolMessage);
+
+}
+
+void PresentationLayerV0::disableAllConfigChannels(uint8_t uCId, int nbrOfConfigChannels)
+{
+    QVector<uint8_t> newDebugProtocolMessage;
+    for(int i = 0; i < nbrOfConfigChannels; i++)
+    {
+        newDebugProtocolMessage.append(DebugProtocolV0Enums::ConfigChannel);
+        newDebugProtocolMessage.append(static_cast<uint8_t>(i));
+        newDebugProtocolMessage.append(static_cast<uint8_t>(Register::ChannelMode::Off));
+        emit newDebugProtocolCommand(uCId,newDebugProtocolMessage);
+        newDebugProtocolMessage.clear();
+    }
+}
+
+uint8_t PresentationLayerV0::controlByte(const Register &Register)
+{
+    uint8_t control = 0;
+    control |= Register.readWrite() == Register::ReadWrite::Write ? 0x80 : 0x00;
+    control |= static_cast<uint8_t>(Register.source());
+    control |= (Register.derefDepth() & 0x0F);
+    return control;
+}
+
+bool PresentationLayerV0::aggregated(const Register &reg)
+{
+    // The target only aggregates values of at most 8 bytes, and ignores the setting when it doesn't support it
+    return reg.aggregated() && reg.getVariableTypeSize() <= 8 && reg.cpu().hasCapability(capabilityAggregate);
+}
+
+uint8_t PresentationLayerV0::valueFormat(const Register &reg)
+{
+    switch (reg.variableType())
+    {
+    case Register::VariableType::Bool:
+    case Register::VariableType::Char:
+    case Register::VariableType::Pointer:
+        return DebugProtocolV0Enums::FormatUnsigned;
+    case Register::VariableType::Float:
+    case Register::VariableType::Double:
+    case Register::VariableType::LongDouble:
+        return DebugProtocolV0Enums::FormatFloat;
+    default:
+        return DebugProtocolV0Enums::FormatSigned;
+    }
+}
+
+quint64 PresentationLayerV0::unwrapTime(Cpu& cpu, quint64 time, int bits)
+{
+    TimeLine& timeLine = m_timeLine[cpu.id()];
+    quint64 mask = (bits >= 64) ? ~static_cast<quint64>(0) : (static_cast<quint64>(1) << bits) - 1;
+    if (!timeLine.valid)
+    {
+        // The first timestamp starts the timeline and ties it to the wall-clock of the host
+        timeLine.valid = true;
+        timeLine.time = time;
+        cpu.setTimeOrigin(time);
+        return time;
+    }
+
+    // Timestamps within half the range ahead are newer (the target wrapped when they are smaller), others are older
+    quint64 ahead = (time - timeLine.time) & mask;
+    if (ahead <= mask / 2)
+    {
+        timeLine.time += ahead;
+        return timeLine.time;
+    }
+    return timeLine.time - ((timeLine.time - time) & mask);
+}
@@ -19,9 +19,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PRESENTATIONLAYERV0_H
 #define PRESENTATIONLAYERV0_H
 
+#include <QMap>
+#include <QPair>
 #include <QVector>
 #include "../BaseInterface/PresentationLayerBase.h"
 class Register;
+class Capture;
+class MemoryTransfer;
+class Schedule;
 
 
 class PresentationLayerV0 : public PresentationLayerBase
@@ -53,6 +58,20 @@ public slots:
      */
     void writeRegister(const Register& registerToWrite);
 
+    /**
+     * @brief Create debug protocol commands to query several Registers, as many per message as fit.
+     * Cpu`s without the multi-register commands get a query per Register.
+     * @param Registers that need to be queried
+     */
+    void queryRegisters(const QVector<const Register*>& registersToRead);
+
+    /**
+     * @brief Create debug protocol commands to write several Registers, as many per message as fit.
+     * Cpu`s without the multi-register commands get a write per Register.
+     * @param Registers that need to be written
+     */
+    void writeRegisters(const QVector<const Register*>& registersToWrite);
+
     /**
      * @brief Create a debug protocol command to reset the time of a Cpu
      * @param uCId Id of the Cpu where the time needs to be reset from.
@@ -75,22 +94,175 @@ public slots:
      * @brief Create a debug protocol command to set the decimation of a Cpu
      * @param  uCId Cpu where you want to set decimation
      * @param newDecimation decimation that you want to be set.
+     * @param rateGroupDecimations decimation of each rate group, on top of newDecimation
+     * Cpu`s that didn't report rate groups get the 1 byte decimation of the original protocol.
+     */
+    void setDecimation(uint8_t uCId, int newDecimation, const QVector<int>& rateGroupDecimations);
+
+    /**
+     * @brief Create a debug protocol command to start an on-target capture of the active debug channels
+     * @param uCId Cpu that needs to capture
+     * @param decimation Capture every decimation ticks
+     */
+    void startCapture(uint8_t uCId, int decimation);
+
+    /**
+     * @brief Create a debug protocol command to stop the on-target capture
+     * @param uCId Cpu that is capturing
+     */
+    void stopCapture(uint8_t uCId);
+
+    /**
+     * @brief Upload the capture of a Cpu into Cpu::capture() as soon as it is stopped
+     * @param uCId Cpu of which you want the capture
+     */
+    void uploadCapture(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to arm an on-target capture with the trigger of Cpu::capture()
+     * @param uCId Cpu that needs to capture
+     * @param decimation Capture every decimation ticks
+     */
+    void armCapture(uint8_t uCId, int decimation);
+
+    /**
+     * @brief Create a debug protocol command to disarm the on-target capture
+     * @param uCId Cpu that is armed
+     */
+    void disarmCapture(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to read the remainder of the memory block of Cpu::memoryTransfer()
+     * @param uCId Cpu of which you want to read memory
      */
-    void setDecimation(uint8_t uCId, int newDecimation);
+    void readMemory(uint8_t uCId);
+
+    /**
+     * @brief Start writing the memory block of Cpu::memoryTransfer(), or continue sending its fragments
+     * @param uCId Cpu of which you want to write memory
+     */
+    void writeMemory(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to read the CPU-cost statistics of the debugger
+     * @param uCId Cpu of which you want the statistics
+     */
+    void readStats(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to clear the CPU-cost statistics of the debugger
+     * @param uCId Cpu of which you want to clear the statistics
+     */
+    void resetStats(uint8_t uCId);
+
+    /**
+     * @brief Send the pending steps of Cpu::schedule() that fit in the free groups of the target
+     * @param uCId Cpu of which you want to commit the schedule
+     */
+    void commitSchedule(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to cancel all scheduled steps on the target
+     * @param uCId Cpu of which you want to cancel the schedule
+     */
+    void cancelSchedule(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to read the status of the scheduled steps
+     * @param uCId Cpu of which you want the status
+     */
+    void readSchedule(uint8_t uCId);
+
+    /**
+     * @brief Create the debug protocol commands to configure and start the stimulus of Cpu::stimulus()
+     * @param uCId Cpu of which you want to start the stimulus
+     */
+    void startStimulus(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to stop the stimulus generator
+     * @param uCId Cpu of which you want to stop the stimulus
+     */
+    void stopStimulus(uint8_t uCId);
+
+    /**
+     * @brief Create a debug protocol command to read the status of the stimulus generator
+     * @param uCId Cpu of which you want the status
+     */
+    void readStimulus(uint8_t uCId);
+
+signals:
+    /**
+     * @brief Progress of the memory transfer of a Cpu, emitted for every fragment
+     */
+    void memoryTransferProgress(const Cpu& cpu, int bytesDone, int bytesTotal);
 
 private:
     void receivedGetInfo(uint8_t uCId,QVector<uint8_t>& commandData);
     void receivedGetVersion(uint8_t& uCId,const QVector<uint8_t>& commandData);
     void receivedWriteRegister(uint8_t& uCId,const QVector<uint8_t>& commandData);
     void receivedQueryRegister(uint8_t& uCId,const QVector<uint8_t>& commandData);
+    void receivedQueryRegisters(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void sendQueryRegisters(uint8_t uCId, const QVector<const Register*>& registersToRead, int maxSize);
+    void sendWriteRegisters(uint8_t uCId, const QVector<const Register*>& registersToWrite, int maxSize);
     void receivedConfigChannel(uint8_t& uCId,const QVector<uint8_t>& commandData);
     void receivedDecimation(uint8_t uCId,const QVector<uint8_t>& commandData);
     void receivedReadChannelData(uint8_t uCId, QVector<uint8_t> &commandData);
+    void receivedCompactData(uint8_t uCId, const QVector<uint8_t>& commandData);
     void receivedDebugString(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void receivedResetTime(uint8_t uCId);
+    void receivedCapture(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void sendCaptureStatus(uint8_t uCId);
+    void sendCaptureReads(uint8_t uCId, Capture& capture);
+    void receivedMemory(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void sendMemoryRequest(uint8_t uCId, MemoryTransfer& transfer, uint8_t command);
+    void sendMemoryWrites(uint8_t uCId, MemoryTransfer& transfer);
+    void receivedStats(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void sendScheduleSteps(uint8_t uCId, Schedule& schedule, int maxSize);
+    void receivedSchedule(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void receivedStimulus(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void sendCapabilityQuery(uint8_t uCId, uint8_t firstCapability);
+    void receivedCapabilities(uint8_t uCId,const QVector<uint8_t>& commandData);
+    void negotiate(Cpu& cpu);
     void sendGetVersion(uint8_t uCId);
     void sendGetInfo(uint8_t uCId);
-    void disableAllConfigChannels(uint8_t uCId, uint8_t nbrOfConfigChannels);
+    void disableAllConfigChannels(uint8_t uCId, int nbrOfConfigChannels);
+    void sendChannelDataEncoding(Cpu& cpu);
     uint8_t controlByte(const Register& Register);
+    uint8_t valueFormat(const Register& reg);
+    bool aggregated(const Register& reg);
+    quint64 unwrapTime(Cpu& cpu, quint64 time, int bits);
+
+    /**
+     * @brief Decoder state of the compact channel data of one Cpu: values are relative to the previous frame
+     */
+    struct CompactChannelState
+    {
+        bool synced = false;
+        int sequence = -1;
+        quint64 time = 0;
+        QVector<quint64> values;
+    };
+    QMap<uint8_t, CompactChannelState> m_compactChannelState;
+
+    /**
+     * @brief Newest time of the channel data of one Cpu, the timestamps of the target wrap and are unwrapped into 64 bits
+     */
+    struct TimeLine
+    {
+        bool valid = false;
+        quint64 time = 0;
+    };
+    QMap<uint8_t, TimeLine> m_timeLine;
+    QMap<uint8_t, quint32> m_pendingTimeReset;          /**< ResetTime that isn't echoed yet by Cpu id, their channel data still has the old time */
+    quint32 m_timeResetTag = 0;
+
+    /**
+     * @brief Offset and size of each Register of a multi-register query, in the order of the reply
+     */
+    typedef QVector<QPair<quint32,int>> RegisterQuery;
+    QMap<quint16, RegisterQuery> m_registerQueries;     /**< Outstanding queries by Cpu id (MSB) and tag (LSB) */
+    uint8_t m_registerQueryTag = 0;
 };
 
 #endif // PRESENTATIONLAYERV0_H
@@ -90,6 +90,21 @@ void TCP::connectLayers()
         {
             QObject::connect(newCpu,&Cpu::resetTime,m_applicationLayer,&ApplicationLayerBase::resetTime);
             QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::setDecimation),m_applicationLayer,&ApplicationLayerBase::setDecimation);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::startCapture),m_applicationLayer,&ApplicationLayerBase::startCapture);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::stopCapture),m_applicationLayer,&ApplicationLayerBase::stopCapture);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::uploadCapture),m_applicationLayer,&ApplicationLayerBase::uploadCapture);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::armCapture),m_applicationLayer,&ApplicationLayerBase::armCapture);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::disarmCapture),m_applicationLayer,&ApplicationLayerBase::disarmCapture);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::readMemory),m_applicationLayer,&ApplicationLayerBase::readMemory);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::writeMemory),m_applicationLayer,&ApplicationLayerBase::writeMemory);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::readStats),m_applicationLayer,&ApplicationLayerBase::readStats);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::resetStats),m_applicationLayer,&ApplicationLayerBase::resetStats);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::commitSchedule),m_applicationLayer,&ApplicationLayerBase::commitSchedule);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::cancelSchedule),m_applicationLayer,&ApplicationLayerBase::cancelSchedule);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::readSchedule),m_applicationLayer,&ApplicationLayerBase::readSchedule);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::startStimulus),m_applicationLayer,&ApplicationLayerBase::startStimulus);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::stopStimulus),m_applicationLayer,&ApplicationLayerBase::stopStimulus);
+            QObject::connect(newCpu,QOverload<Cpu&>::of(&Cpu::readStimulus),m_applicationLayer,&ApplicationLayerBase::readStimulus);
             m_cpuListModel.append(newCpu);
         }
     });
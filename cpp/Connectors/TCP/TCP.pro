@@ -14,6 +14,10 @@ HEADERS         = TCP.h \
     ../../EmbeddedDebugger/Medium/Register/RegisterListModel.h \
     ../../EmbeddedDebugger/Medium/CPU/Cpu.h \
     ../../EmbeddedDebugger/Medium/CPU/CpuListModel.h \
+    ../../EmbeddedDebugger/Medium/Capture/Capture.h \
+    ../../EmbeddedDebugger/Medium/Memory/MemoryTransfer.h \
+    ../../EmbeddedDebugger/Medium/Schedule/Schedule.h \
+    ../../EmbeddedDebugger/Medium/Stimulus/Stimulus.h \
     ../../EmbeddedDebugger/Medium/Medium.h \
     ../BaseInterface/Common.h \
     ../../Profiles/kconcatenaterowsproxymodel.h \
@@ -21,6 +25,7 @@ HEADERS         = TCP.h \
     Settings.h
 
 SOURCES         = TCP.cpp \
+    ../BaseInterface/ApplicationLayerBase.cpp \
     ../DebugProtocolV0/ApplicationLayerV0.cpp \
     ../DebugProtocolV0/PresentationLayerV0.cpp \
     ../DebugProtocolV0/TransportLayerV0.cpp \
@@ -28,6 +33,10 @@ SOURCES         = TCP.cpp \
     ../../EmbeddedDebugger/Medium/Register/RegisterListModel.cpp \
     ../../EmbeddedDebugger/Medium/CPU/Cpu.cpp \
     ../../EmbeddedDebugger/Medium/CPU/CpuListModel.cpp \
+    ../../EmbeddedDebugger/Medium/Capture/Capture.cpp \
+    ../../EmbeddedDebugger/Medium/Memory/MemoryTransfer.cpp \
+    ../../EmbeddedDebugger/Medium/Schedule/Schedule.cpp \
+    ../../EmbeddedDebugger/Medium/Stimulus/Stimulus.cpp \
     ../../Profiles/kconcatenaterowsproxymodel.cpp \
     Settings.cpp \
     Settings.cpp
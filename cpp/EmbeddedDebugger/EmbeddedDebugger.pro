@@ -33,6 +33,7 @@ SOURCES += \
     ProfileManager/ProfileListModel.cpp \
     ../Profiles/kconcatenaterowsproxymodel.cpp \
     ui/RegisterTab.cpp \
+    ui/StatsTab.cpp \
     ui/ComboBoxDelegate.cpp \
     ui/PushButtonDelegate.cpp
 
@@ -45,13 +46,15 @@ HEADERS += \
     ProfileManager/ProfileListModel.h \
     ../Profiles/kconcatenaterowsproxymodel.h \
     ui/RegisterTab.h \
+    ui/StatsTab.h \
     ui/ComboBoxDelegate.h \
     ui/PushButtonDelegate.h
 
 FORMS += \
         ui\MainWindow.ui \
     ui/ConnectTab.ui \
-    ui/RegisterTab.ui
+    ui/RegisterTab.ui \
+    ui/StatsTab.ui
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
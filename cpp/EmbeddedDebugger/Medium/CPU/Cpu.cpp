@@ -30,9 +30,37 @@ Cpu::Cpu(uint8_t id,const QString& name,const QString& serialNumber,const QStrin
     m_name(name),
     m_serialNumber(serialNumber),
     m_protocolVersion(protocolVersion),
-    m_applicationVersion(applicationVersion)
+    m_applicationVersion(applicationVersion),
+    m_stimulusTable(0, QStringLiteral("Stimulus table"), Register::ReadWrite::Write, Register::VariableType::Char,
+                    Register::Source::StimulusTable, 0, 0, *this)
 {
     qDebug() << "New cpu: " << m_id;
+
+    //A memory transfer that got stuck continues where it was
+    QObject::connect(&m_memoryTransfer,&MemoryTransfer::retry,this,[this]()
+    {
+        if (m_memoryTransfer.direction() == MemoryTransfer::Direction::Read)
+        {
+            emit readMemory(*this);
+        }
+        else
+        {
+            emit writeMemory(*this);
+        }
+    });
+
+    //The schedule reads the status of the target while steps are waiting or armed
+    QObject::connect(&m_schedule,&Schedule::poll,this,[this](){emit readSchedule(*this);});
+
+    //The stimulus of a table starts once its table is uploaded, and reads the status while it is played
+    QObject::connect(&m_memoryTransfer,&MemoryTransfer::finished,this,[this](bool ok)
+    {
+        if (ok && m_memoryTransfer.reg() == &m_stimulusTable)
+        {
+            emit startStimulus(*this);
+        }
+    });
+    QObject::connect(&m_stimulus,&Stimulus::poll,this,[this](){emit readStimulus(*this);});
 }
 
 Cpu::~Cpu()
@@ -78,6 +106,47 @@ int Cpu::nextDebugChannel()
     return -1;
 }
 
+int Cpu::debugChannelMaskSize() const
+{
+    // 1 bit per channel, at least 16 bits
+    return qMax(2, (m_maxDebugChannels + 7) / 8);
+}
+
+void Cpu::setRateGroupCount(int rateGroupCount)
+{
+    // Groups are sampled every tick until the target tells otherwise
+    m_rateGroupDecimations.resize(qMax(1, rateGroupCount));
+    for (int& decimation : m_rateGroupDecimations)
+    {
+        decimation = qMax(1, decimation);
+    }
+}
+
+double Cpu::sampleRate(int rateGroup)
+{
+    // Channel data is sent every decimation ticks, a rate group every rateGroupDecimation of those
+    int tick_us = getVariableTypeSize(Register::VariableType::TimeStamp);
+    if (tick_us <= 0)
+    {
+        return 0.0;
+    }
+    return 1e6 / (static_cast<double>(tick_us) * qMax(1, m_decimation) * rateGroupDecimation(rateGroup));
+}
+
+void Cpu::setTimeOrigin(quint64 time)
+{
+    // The timeline of the Cpu starts now on the host
+    m_timeOrigin = time;
+    m_timeOriginWallClock = QDateTime::currentDateTimeUtc();
+}
+
+QDateTime Cpu::wallClockTime(quint64 time)
+{
+    // Nominal tick time, no correction for a drifting target clock
+    qint64 ticks = static_cast<qint64>(time - m_timeOrigin);
+    qint64 tick_us = getVariableTypeSize(Register::VariableType::TimeStamp);
+    return m_timeOriginWallClock.addMSecs(ticks * tick_us / 1000);
+}
 
 void Cpu::setDecimation(int newDecimation)
 {
@@ -112,6 +181,8 @@ bool Cpu::loadConfiguration()
                 Reg["DerefDepth"].toInt(),
                 Reg["Offset"].toInt(),
                 *this);
+        newRegister->setRateGroup(Reg["RateGroup"].toInt());
+        newRegister->setAggregated(Reg["Aggregate"].toBool());
 
         emit newRegisterFound(newRegister);
     }
@@ -121,6 +192,133 @@ bool Cpu::loadConfiguration()
 void Cpu::receivedDecimation(int decimation)
 {
     m_decimation = decimation;
+    emit decimationChanged();
+}
+
+void Cpu::setRateGroupDecimation(int rateGroup, int decimation)
+{
+    if (rateGroup >= 0 && rateGroup < m_rateGroupDecimations.size())
+    {
+        m_rateGroupDecimations[rateGroup] = qMax(1, decimation);
+        emit setDecimation(*this);
+    }
+}
+
+void Cpu::receivedRateGroupDecimation(int rateGroup, int decimation)
+{
+    if (rateGroup >= 0 && rateGroup < m_rateGroupDecimations.size())
+    {
+        m_rateGroupDecimations[rateGroup] = qMax(1, decimation);
+        emit decimationChanged();
+    }
+}
+
+void Cpu::startCapture(int decimation)
+{
+    m_captureDecimation = decimation;
+    emit startCapture(*this);
 }
 
+void Cpu::stopCapture()
+{
+    emit stopCapture(*this);
+}
+
+void Cpu::uploadCapture()
+{
+    emit uploadCapture(*this);
+}
 
+void Cpu::armCapture(int decimation)
+{
+    m_captureDecimation = decimation;
+    emit armCapture(*this);
+}
+
+void Cpu::disarmCapture()
+{
+    emit disarmCapture(*this);
+}
+
+void Cpu::readMemory(const Register* reg, quint32 position, int size)
+{
+    m_memoryTransfer.abort();
+    m_memoryTransfer.startRead(reg, position, size);
+    emit readMemory(*this);
+}
+
+void Cpu::writeMemory(const Register* reg, quint32 position, const QVector<uint8_t>& data)
+{
+    m_memoryTransfer.abort();
+    m_memoryTransfer.startWrite(reg, position, data);
+    emit writeMemory(*this);
+}
+
+void Cpu::readStats()
+{
+    emit readStats(*this);
+}
+
+void Cpu::resetStats()
+{
+    emit resetStats(*this);
+}
+
+void Cpu::receivedStats(const Cpu::DebuggerStats& stats)
+{
+    m_stats = stats;
+    emit statsChanged();
+}
+
+void Cpu::receivedDebugString(const QString& text)
+{
+    // Traces of the application and reports of the target, like a receive buffer overrun
+    qInfo() << "Cpu" << static_cast<int>(m_id) << ":" << text.trimmed();
+    emit debugStringReceived(text);
+}
+
+void Cpu::scheduleWrite(const Register* reg, const QVariant& value, quint64 tick)
+{
+    m_schedule.addWrite(reg, value, tick);
+}
+
+void Cpu::commitSchedule()
+{
+    emit commitSchedule(*this);
+}
+
+void Cpu::cancelSchedule()
+{
+    m_schedule.clear();
+    emit cancelSchedule(*this);
+}
+
+void Cpu::readSchedule()
+{
+    emit readSchedule(*this);
+}
+
+void Cpu::startStimulus(const Register* reg, const Stimulus::Settings& settings, quint64 startTick)
+{
+    //A new stimulus replaces the one that is played, the target refuses a new table while it is played
+    m_stimulus.setup(reg, settings, startTick);
+    emit stopStimulus(*this);
+    if (settings.waveform == Stimulus::Waveform::Table)
+    {
+        writeMemory(&m_stimulusTable, 0, m_stimulus.tableData());
+    }
+    else
+    {
+        emit startStimulus(*this);
+    }
+}
+
+void Cpu::stopStimulus()
+{
+    emit stopStimulus(*this);
+}
+
+void Cpu::readStimulus()
+{
+    emit readStimulus(*this);
+}
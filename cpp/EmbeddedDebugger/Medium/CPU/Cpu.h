@@ -19,16 +19,48 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CPUNODE_H
 #define CPUNODE_H
 
+#include <QDateTime>
+#include <QMap>
 #include <QObject>
 #include <QVector>
 #include "Medium/Register/RegisterListModel.h"
 #include "Medium/Register/Register.h"
+#include "Medium/Capture/Capture.h"
+#include "Medium/Memory/MemoryTransfer.h"
+#include "Medium/Schedule/Schedule.h"
+#include "Medium/Stimulus/Stimulus.h"
 
 class Cpu : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief CPU-cost of the debugger on the target, read with the Stats command
+     */
+    struct DebuggerStats
+    {
+        enum Phase {DoMain = 0, ChannelData, Decode, Encode, PhaseCount};
+        struct PhaseCycles
+        {
+            quint32 count = 0;
+            quint32 min = 0;
+            quint32 max = 0;
+            quint32 avg = 0;
+        };
+
+        quint32 cyclesPerSecond = 0;   // 0 when the target has no cycle counter
+        QVector<PhaseCycles> phases;
+        quint32 rxBytes = 0;
+        quint32 rxDropped = 0;         // bytes lost by receive buffer overruns
+        quint32 txBytes = 0;
+        quint32 txDropped = 0;         // messages that found no free transmit buffer
+        quint32 framingErrors = 0;     // received messages discarded for a missing STX/ETX or an invalid size
+        quint32 crcErrors = 0;         // received messages discarded for a CRC error
+
+        double microseconds(quint32 cycles) const {return cyclesPerSecond > 0 ? cycles * 1e6 / cyclesPerSecond : 0.0;}
+    };
+
     explicit Cpu(uint8_t id,const QString& name,const QString& serialNumber,const QString& protocolVersion,
                     const QString& applicationVersion, QObject* parent = nullptr);
     virtual ~Cpu();
@@ -50,8 +82,42 @@ public:
     void increaseNbrOfActiveDebugChannels() {m_activeDebugChannels++;}
     void decreaseNbrOfActiveDebugChannels() {m_activeDebugChannels--;}
     int maxDebugChannels() const {return m_maxDebugChannels;}
+    void setMaxDebugChannels(int maxDebugChannels) {m_maxDebugChannels = maxDebugChannels;}
+    int debugChannelMaskSize() const;
+    bool compactChannelData() const {return m_compactChannelData;}
+    void setCompactChannelData(bool compactChannelData) {m_compactChannelData = compactChannelData;}
+    bool batchedChannelData() const {return m_batchedChannelData;}
+    void setBatchedChannelData(bool batchedChannelData) {m_batchedChannelData = batchedChannelData;}
+    int channelBatchTicks() const {return m_channelBatchTicks;}
+    int channelBatchLatency_ms() const {return m_channelBatchLatency_ms;}
+    void setChannelBatch(int ticks, int latency_ms) {m_channelBatchTicks = ticks; m_channelBatchLatency_ms = latency_ms;}
+    int rateGroupCount() const {return m_rateGroupDecimations.size();}
+    void setRateGroupCount(int rateGroupCount);
+    int rateGroupDecimation(int rateGroup) const {return m_rateGroupDecimations.value(rateGroup,1);}
+    const QVector<int>& rateGroupDecimations() const {return m_rateGroupDecimations;}
+    double sampleRate(int rateGroup);
+    bool extendedDecimation() const {return m_extendedDecimation;}
+    void setExtendedDecimation(bool extendedDecimation) {m_extendedDecimation = extendedDecimation;}
+    int timeStampSize() const {return m_timeStampSize;}
+    void setTimeStampSize(int timeStampSize) {m_timeStampSize = timeStampSize;}
+    void setTimeOrigin(quint64 time);
+    QDateTime wallClockTime(quint64 time);
     int  nextDebugChannel();
     QVector<Register*>& debugChannels() {return m_debugChannels;}
+    Capture& capture() {return m_capture;}
+    int captureDecimation() const {return m_captureDecimation;}
+    MemoryTransfer& memoryTransfer() {return m_memoryTransfer;}
+    int memoryFragmentSize() const {return m_memoryFragmentSize;}
+    void setMemoryFragmentSize(int memoryFragmentSize) {m_memoryFragmentSize = memoryFragmentSize;}
+    int maxCommandDataSize() const {return m_maxCommandDataSize;}
+    void setMaxCommandDataSize(int maxCommandDataSize) {m_maxCommandDataSize = maxCommandDataSize;}
+    const DebuggerStats& stats() const {return m_stats;}
+    Schedule& schedule() {return m_schedule;}
+    Stimulus& stimulus() {return m_stimulus;}
+    bool hasCapability(const QString& name) const {return m_capabilities.contains(name);}
+    QVector<uint8_t> capability(const QString& name) const {return m_capabilities.value(name);}
+    void setCapability(const QString& name, const QVector<uint8_t>& limits) {m_capabilities.insert(name, limits);}
+    void clearCapabilities() {m_capabilities.clear();}
 
 signals:
     void resetTime(Cpu& cpu);
@@ -59,12 +125,49 @@ signals:
     void setDecimation(Cpu& cpu);
     void decimationChanged();
     void newRegisterFound(Register* newRegister);
+    void startCapture(Cpu& cpu);
+    void stopCapture(Cpu& cpu);
+    void uploadCapture(Cpu& cpu);
+    void armCapture(Cpu& cpu);
+    void disarmCapture(Cpu& cpu);
+    void readMemory(Cpu& cpu);
+    void writeMemory(Cpu& cpu);
+    void readStats(Cpu& cpu);
+    void resetStats(Cpu& cpu);
+    void statsChanged();
+    void debugStringReceived(const QString& text);
+    void commitSchedule(Cpu& cpu);
+    void cancelSchedule(Cpu& cpu);
+    void readSchedule(Cpu& cpu);
+    void startStimulus(Cpu& cpu);
+    void stopStimulus(Cpu& cpu);
+    void readStimulus(Cpu& cpu);
 
 public slots:
 
     void setDecimation(int newDecimation);
     bool loadConfiguration();
     void receivedDecimation(int decimation);
+    void setRateGroupDecimation(int rateGroup, int decimation);
+    void receivedRateGroupDecimation(int rateGroup, int decimation);
+    void startCapture(int decimation);
+    void stopCapture();
+    void uploadCapture();
+    void armCapture(int decimation);
+    void disarmCapture();
+    void readMemory(const Register* reg, quint32 position, int size);
+    void writeMemory(const Register* reg, quint32 position, const QVector<uint8_t>& data);
+    void readStats();
+    void resetStats();
+    void receivedStats(const Cpu::DebuggerStats& stats);
+    void receivedDebugString(const QString& text);
+    void scheduleWrite(const Register* reg, const QVariant& value, quint64 tick);
+    void commitSchedule();
+    void cancelSchedule();
+    void readSchedule();
+    void startStimulus(const Register* reg, const Stimulus::Settings& settings, quint64 startTick);
+    void stopStimulus();
+    void readStimulus();
 
 private:
     uint8_t m_id = 0;
@@ -74,10 +177,29 @@ private:
     QString m_applicationVersion;
     int m_activeDebugChannels = 0;
     int m_maxDebugChannels = 16;
+    bool m_compactChannelData = false;
+    bool m_batchedChannelData = false;
+    int m_channelBatchTicks = 16;
+    int m_channelBatchLatency_ms = 20;
     int m_decimation = 0;
+    QVector<int> m_rateGroupDecimations = QVector<int>(1,1);
+    bool m_extendedDecimation = false;  // the target accepts a 4 byte decimation and rate groups, older targets only 1 byte
+    int m_timeStampSize = 3;
+    quint64 m_timeOrigin = 0;
+    QDateTime m_timeOriginWallClock;
     int m_messageCounter= 0;
     int m_invalidMessageCounter = 0;
     QVector<Register*> m_debugChannels;
+    Capture m_capture;
+    int m_captureDecimation = 1;
+    MemoryTransfer m_memoryTransfer;
+    int m_memoryFragmentSize = 0;
+    int m_maxCommandDataSize = 0;
+    DebuggerStats m_stats;
+    Schedule m_schedule;
+    Stimulus m_stimulus;
+    Register m_stimulusTable;           // target of the memory transfer that uploads the table of the stimulus
+    QMap<QString,QVector<uint8_t>> m_capabilities;
     QVector<QPair<Register::VariableType,int>> m_variableTypeSizes;
 
 };
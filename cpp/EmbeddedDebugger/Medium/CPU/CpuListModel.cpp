@@ -39,7 +39,7 @@ int CpuListModel::rowCount(const QModelIndex &parent) const
 int CpuListModel::columnCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return 6;
+    return 14;
 }
 
 QVariant CpuListModel::data(const QModelIndex &index, int role) const
@@ -73,6 +73,19 @@ QVariant CpuListModel::data(const QModelIndex &index, int role) const
 
             returnValue = messageCount; break;
         }
+        case 6:
+            returnValue = phaseData(*cpu, Cpu::DebuggerStats::DoMain); break;
+        case 7:
+            returnValue = phaseData(*cpu, Cpu::DebuggerStats::ChannelData); break;
+        case 8:
+            returnValue = phaseData(*cpu, Cpu::DebuggerStats::Decode); break;
+        case 9:
+            returnValue = phaseData(*cpu, Cpu::DebuggerStats::Encode); break;
+        case 10:
+            returnValue = QString::number(cpu->stats().rxBytes) + " (" + QString::number(cpu->stats().rxDropped) + "/" +
+                    QString::number(cpu->stats().framingErrors) + "/" + QString::number(cpu->stats().crcErrors) + ")"; break;
+        case 11:
+            returnValue = QString::number(cpu->stats().txBytes) + " (" + QString::number(cpu->stats().txDropped) + ")"; break;
         default:  break;
         }
 
@@ -118,6 +131,46 @@ QVariant CpuListModel::headerData(int section, Qt::Orientation orientation, int
             returnValue = tr("Invalid message count");
             break;
         }
+        case 6:
+        {
+            returnValue = tr("DoMain avg/max [us]");
+            break;
+        }
+        case 7:
+        {
+            returnValue = tr("Channel data avg/max [us]");
+            break;
+        }
+        case 8:
+        {
+            returnValue = tr("Decode avg/max [us]");
+            break;
+        }
+        case 9:
+        {
+            returnValue = tr("Encode avg/max [us]");
+            break;
+        }
+        case 10:
+        {
+            returnValue = tr("Received bytes (dropped/framing/CRC)");
+            break;
+        }
+        case 11:
+        {
+            returnValue = tr("Sent bytes (dropped messages)");
+            break;
+        }
+        case 12:
+        {
+            returnValue = tr("Read statistics");
+            break;
+        }
+        case 13:
+        {
+            returnValue = tr("Reset statistics");
+            break;
+        }
         default:
             break;
         }
@@ -126,6 +179,55 @@ QVariant CpuListModel::headerData(int section, Qt::Orientation orientation, int
     return returnValue;
 }
 
+Qt::ItemFlags CpuListModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::ItemIsEnabled;
+    if (index.column() == readStatsColumn || index.column() == resetStatsColumn)
+    {
+        return Qt::ItemIsEnabled | Qt::ItemIsEditable;
+    }
+    else
+    {
+        return Qt::ItemIsEnabled;
+    }
+}
+
+bool CpuListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    Q_UNUSED(value);
+    if (index.isValid() &&
+            index.row() < m_cpuNodes.size() &&
+            index.row() >= 0 &&
+            (role == Qt::DisplayRole ||
+             role == Qt::EditRole))
+    {
+        // The buttons request the statistics, the columns are updated when they are received
+        if (index.column() == readStatsColumn)
+        {
+            m_cpuNodes.at(index.row())->readStats();
+            return true;
+        }
+        if (index.column() == resetStatsColumn)
+        {
+            m_cpuNodes.at(index.row())->resetStats();
+            return true;
+        }
+    }
+    return false;
+}
+
+QVariant CpuListModel::phaseData(const Cpu& cpu, int phase) const
+{
+    const Cpu::DebuggerStats& stats = cpu.stats();
+    if (phase >= stats.phases.size() || stats.phases.at(phase).count == 0)
+    {
+        return QString("-");
+    }
+    return QString("%1 / %2").arg(stats.microseconds(stats.phases.at(phase).avg), 0, 'f', 1)
+                             .arg(stats.microseconds(stats.phases.at(phase).max), 0, 'f', 1);
+}
+
 void CpuListModel::insert(int index, Cpu* cpuNode)
 {
     if(index < 0 || contains(cpuNode->id()))
@@ -137,6 +239,14 @@ void CpuListModel::insert(int index, Cpu* cpuNode)
     cpuNode->setParent(this); //Set the parent of the object cpuNode to this listModel
     m_cpuNodes.insert(index,cpuNode);
     connect(cpuNode,&Cpu::newRegisterFound,this,&CpuListModel::newRegisterFound);
+    connect(cpuNode,&Cpu::statsChanged,this,[this,cpuNode]()
+    {
+        int row = m_cpuNodes.indexOf(cpuNode);
+        if (row >= 0)
+        {
+            emit dataChanged(this->index(row, firstStatsColumn), this->index(row, readStatsColumn - 1));
+        }
+    });
     cpuNode->loadConfiguration();
     endInsertRows();
 }
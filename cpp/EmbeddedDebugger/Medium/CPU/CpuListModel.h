@@ -34,6 +34,13 @@ public:
     int columnCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+
+    // Columns with the CPU-cost statistics of the debugger, followed by a read and a reset button
+    static const int firstStatsColumn = 6;
+    static const int readStatsColumn = 12;
+    static const int resetStatsColumn = 13;
 
     void insert(int index, Cpu* cpuNode);
     void append(Cpu* cpuNode);
@@ -45,6 +52,8 @@ signals:
     void newRegisterFound(Register* newRegister);
 
 private:
+    QVariant phaseData(const Cpu& cpu, int phase) const;
+
     QVector<Cpu*> m_cpuNodes;
 };
 
@@ -0,0 +1,151 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Capture.h"
+#include "Medium/Register/Register.h"
+#include <QDebug>
+#include <algorithm>
+
+Capture::Capture(QObject *parent) :
+    QObject(parent)
+{
+
+}
+
+QVector<QPair<quint32,QVariant>> Capture::series(const Register* reg) const
+{
+    QVector<QPair<quint32,QVariant>> series;
+    int index = m_channels.indexOf(const_cast<Register*>(reg));
+    if (index >= 0)
+    {
+        series.reserve(m_samples.size());
+        for (const Sample& sample : m_samples)
+        {
+            series.append(qMakePair(sample.tick, sample.values.value(index)));
+        }
+    }
+    return series;
+}
+
+void Capture::setStatus(Capture::State state, int recordSize, int recordCount, const QVector<Register*>& channels, int triggerIndex)
+{
+    m_state = state;
+    m_recordSize = recordSize;
+    m_recordCount = recordCount;
+    m_channels = channels;
+    m_triggerIndex = triggerIndex;
+    emit stateChanged();
+}
+
+bool Capture::startUpload()
+{
+    m_uploadRequested = false;
+
+    // Record is a 4 byte tick followed by the values of the captured channels
+    int expectedSize = 4;
+    for (Register* reg : qAsConst(m_channels))
+    {
+        if (reg == nullptr)
+        {
+            qWarning() << "Capture contains a debug channel that is unknown";
+            return false;
+        }
+        expectedSize += reg->getVariableTypeSize();
+    }
+    if (m_state != State::Done || expectedSize != m_recordSize)
+    {
+        qWarning() << "Capture can't be uploaded, record size: " << m_recordSize << " expected: " << expectedSize;
+        return false;
+    }
+
+    m_data.fill(0, m_recordSize * m_recordCount);
+    m_samples.clear();
+    m_bytesReceived = 0;
+    m_nextOffset = 0;
+    m_blockSize = 0;
+    m_requestsInFlight = 0;
+    m_uploading = true;
+    return true;
+}
+
+int Capture::nextRequest()
+{
+    // The block size is known after the first reply, until then only 1 request is sent
+    if (!m_uploading || m_nextOffset >= m_data.size() ||
+        m_requestsInFlight >= (m_blockSize == 0 ? 1 : m_maxRequestsInFlight))
+    {
+        return -1;
+    }
+    int offset = m_nextOffset;
+    m_nextOffset += m_blockSize;
+    m_requestsInFlight++;
+    return offset;
+}
+
+void Capture::receivedData(quint32 offset, const QVector<uint8_t>& data)
+{
+    if (!m_uploading)
+    {
+        return;
+    }
+    m_requestsInFlight = qMax(0, m_requestsInFlight - 1);
+
+    if (data.isEmpty() || int(offset) >= m_data.size())
+    {
+        qWarning() << "Capture upload aborted at offset: " << offset;
+        m_uploading = false;
+        return;
+    }
+    if (m_blockSize == 0)
+    {
+        m_blockSize = data.size();
+        m_nextOffset = data.size();
+    }
+
+    int size = qMin(data.size(), m_data.size() - int(offset));
+    std::copy(data.constBegin(), data.constBegin() + size, m_data.begin() + offset);
+    m_bytesReceived += size;
+    emit uploadProgress(m_bytesReceived, m_data.size());
+
+    if (m_bytesReceived >= m_data.size())
+    {
+        m_uploading = false;
+        decodeRecords();
+        emit uploadFinished();
+    }
+}
+
+void Capture::decodeRecords()
+{
+    m_samples.reserve(m_recordCount);
+    for (int record = 0; record < m_recordCount; record++)
+    {
+        int pos = record * m_recordSize;
+        Sample sample;
+        sample.tick = quint32(m_data[pos]) | quint32(m_data[pos + 1]) << 8 | quint32(m_data[pos + 2]) << 16 | quint32(m_data[pos + 3]) << 24;
+        pos += 4;
+        for (Register* reg : qAsConst(m_channels))
+        {
+            int size = reg->getVariableTypeSize();
+            sample.values.append(reg->valueFromBytes(m_data.mid(pos, size)));
+            pos += size;
+        }
+        m_samples.append(sample);
+    }
+}
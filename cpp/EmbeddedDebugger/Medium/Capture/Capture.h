@@ -0,0 +1,160 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariant>
+#include <QPair>
+class Register;
+
+/**
+ * @brief On-target capture (oscilloscope mode) of a Cpu.
+ * The target records every tick of the active debug channels in a RAM buffer,
+ * after the capture has stopped the records are uploaded in blocks and reassembled here.
+ */
+class Capture : public QObject
+{
+    Q_OBJECT
+public:
+    enum class State{
+        Idle = 0x00,
+        Running = 0x01,
+        Done = 0x02,
+        Armed = 0x03,
+        Triggered = 0x04
+    };
+
+    enum class TriggerMode{
+        Rising = 0x00,
+        Falling = 0x01,
+        Above = 0x02,
+        Below = 0x03,
+        Change = 0x04
+    };
+
+    /**
+     * @brief Trigger that is evaluated on the target every captured tick
+     */
+    struct Trigger
+    {
+        Register* reg = nullptr;    /**< Debug channel that is checked */
+        TriggerMode mode = TriggerMode::Rising;
+        QVariant level;             /**< Level in the type of reg */
+        int preCount = 0;           /**< Number of records before the trigger */
+        int postCount = 1;          /**< Number of records from the trigger on */
+    };
+
+    /**
+     * @brief Single captured tick, values are in the order of channels()
+     */
+    struct Sample
+    {
+        quint32 tick;
+        QVector<QVariant> values;
+    };
+
+    explicit Capture(QObject* parent = nullptr);
+
+    State state() const {return m_state;}
+    int recordSize() const {return m_recordSize;}
+    int recordCount() const {return m_recordCount;}
+    const QVector<Register*>& channels() const {return m_channels;}
+    const QVector<Sample>& samples() const {return m_samples;}
+    bool isUploading() const {return m_uploading;}
+    bool isUploadRequested() const {return m_uploadRequested;}
+    const Trigger& trigger() const {return m_trigger;}
+    void setTrigger(const Trigger& trigger) {m_trigger = trigger;}
+
+    /**
+     * @brief Index in samples() of the trigger record
+     * @return index, or -1 when the capture was not triggered
+     */
+    int triggerIndex() const {return m_triggerIndex;}
+
+    /**
+     * @brief Captured values of a single Register
+     * @param reg Register that was captured
+     * @return Tick and value of every captured sample, empty when the Register is not captured
+     */
+    QVector<QPair<quint32,QVariant>> series(const Register* reg) const;
+
+    /**
+     * @brief Store the capture status reported by the target
+     * @param state State of the capture on the target
+     * @param recordSize Size of a record (tick and values) in bytes
+     * @param recordCount Number of records in the capture buffer
+     * @param channels Registers of the captured channels, highest channel first
+     * @param triggerIndex Record of the trigger, -1 when not triggered
+     */
+    void setStatus(State state, int recordSize, int recordCount, const QVector<Register*>& channels, int triggerIndex);
+
+    /**
+     * @brief Mark that the records need to be uploaded as soon as the capture is done
+     */
+    void requestUpload() {m_uploadRequested = true;}
+
+    /**
+     * @brief Start uploading the records of a stopped capture
+     * @return false when the channels don't match the record size
+     */
+    bool startUpload();
+
+    /**
+     * @brief Next byte offset to request from the target, a few requests are kept in flight
+     * @return offset, or -1 when no request needs to be sent now
+     */
+    int nextRequest();
+
+    /**
+     * @brief Store a block of uploaded records
+     * @param offset Byte offset of the block
+     * @param data Raw record data
+     */
+    void receivedData(quint32 offset, const QVector<uint8_t>& data);
+
+signals:
+    void stateChanged();
+    void uploadProgress(int bytesReceived, int bytesTotal);
+    void uploadFinished();
+
+private:
+    void decodeRecords();
+
+    static const int m_maxRequestsInFlight = 4;
+
+    State m_state = State::Idle;
+    int m_recordSize = 0;
+    int m_recordCount = 0;
+    QVector<Register*> m_channels;
+    Trigger m_trigger;
+    int m_triggerIndex = -1;
+    QVector<Sample> m_samples;
+    QVector<uint8_t> m_data;
+    bool m_uploadRequested = false;
+    bool m_uploading = false;
+    int m_bytesReceived = 0;
+    int m_nextOffset = 0;
+    int m_blockSize = 0;
+    int m_requestsInFlight = 0;
+};
+
+#endif // CAPTURE_H
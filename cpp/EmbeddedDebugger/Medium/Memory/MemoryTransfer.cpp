@@ -0,0 +1,238 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "MemoryTransfer.h"
+#include <QDebug>
+#include <algorithm>
+
+MemoryTransfer::MemoryTransfer(QObject *parent) :
+    QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(m_timeout_ms);
+    QObject::connect(&m_timer,&QTimer::timeout,this,&MemoryTransfer::timeout);
+}
+
+void MemoryTransfer::startRead(const Register* reg, quint32 position, int size)
+{
+    m_direction = Direction::Read;
+    m_register = reg;
+    m_position = position;
+    m_data.fill(0, size);
+    m_bytesDone = 0;
+    m_fragmentSize = 0;
+    m_sequence = 0;
+    m_sequenceBase = 0;
+    m_ignoreErrors = 0;
+}
+
+void MemoryTransfer::startWrite(const Register* reg, quint32 position, const QVector<uint8_t>& data)
+{
+    m_direction = Direction::Write;
+    m_register = reg;
+    m_position = position;
+    m_data = data;
+    m_bytesDone = 0;
+    m_fragmentSize = 0;
+    m_sequence = 0;
+    m_sequenceBase = 0;
+    m_ignoreErrors = 0;
+}
+
+void MemoryTransfer::abort()
+{
+    if (isBusy())
+    {
+        finish(false);
+    }
+}
+
+void MemoryTransfer::requested()
+{
+    // The target numbers the fragments of every read request from 0, fragments still in flight
+    // of the previous request are ignored
+    if (m_direction == Direction::Read)
+    {
+        m_sequence = 0;
+        m_resync = true;
+    }
+    m_timer.start();
+}
+
+void MemoryTransfer::started(Result result, int fragmentSize)
+{
+    if (!isBusy())
+    {
+        return;
+    }
+    if (result != Result::Ok || fragmentSize <= 0)
+    {
+        qWarning() << "Memory transfer refused by the target, result: " << static_cast<int>(result);
+        finish(false);
+        return;
+    }
+    m_fragmentSize = fragmentSize;
+    m_timer.start();
+}
+
+bool MemoryTransfer::receivedFragment(const QVector<uint8_t>& fragment)
+{
+    if (m_direction != Direction::Read)
+    {
+        return true;
+    }
+
+    // Sequence number (2 bytes), data and the CRC over both
+    if (fragment.size() < 5)
+    {
+        return false;
+    }
+    quint16 crc = static_cast<quint16>(fragment[fragment.size() - 2] | fragment[fragment.size() - 1] << 8);
+    if (crc16(fragment.constData(), fragment.size() - 2) != crc)
+    {
+        qWarning() << "Memory fragment with a CRC error at position: " << nextPosition();
+        return false;
+    }
+    int sequence = fragment[0] | fragment[1] << 8;
+    if (m_resync)
+    {
+        if (sequence != 0)
+        {
+            return true;
+        }
+        m_resync = false;
+    }
+    if (sequence != m_sequence)
+    {
+        qWarning() << "Memory fragment lost at position: " << nextPosition();
+        return false;
+    }
+
+    int size = qMin(fragment.size() - 4, bytesRemaining());
+    std::copy(fragment.constBegin() + 2, fragment.constBegin() + 2 + size, m_data.begin() + m_bytesDone);
+    m_bytesDone += size;
+    m_sequence++;
+    m_timer.start();
+    emit progress(m_bytesDone, m_data.size());
+
+    if (bytesRemaining() == 0)
+    {
+        finish(true);
+    }
+    return true;
+}
+
+QVector<uint8_t> MemoryTransfer::nextWriteFragment()
+{
+    QVector<uint8_t> fragment;
+    int offset = m_sequence * m_fragmentSize;
+    if (m_direction != Direction::Write || !isStarted() || offset >= m_data.size() ||
+        m_sequence - m_sequenceBase >= m_maxFragmentsInFlight)
+    {
+        return fragment;
+    }
+
+    fragment.append(static_cast<uint8_t>(m_sequence));
+    fragment.append(static_cast<uint8_t>(m_sequence >> 8));
+    fragment.append(m_data.mid(offset, m_fragmentSize));
+    quint16 crc = crc16(fragment.constData(), fragment.size());
+    fragment.append(static_cast<uint8_t>(crc));
+    fragment.append(static_cast<uint8_t>(crc >> 8));
+    m_sequence++;
+    return fragment;
+}
+
+void MemoryTransfer::receivedWriteAck(quint16 nextSequence, Result result)
+{
+    if (m_direction != Direction::Write)
+    {
+        return;
+    }
+    if (result == Result::Invalid || result == Result::NoTransfer)
+    {
+        qWarning() << "Memory write aborted by the target, result: " << static_cast<int>(result);
+        finish(false);
+        return;
+    }
+
+    if (nextSequence > m_sequenceBase)
+    {
+        m_sequenceBase = qMin(static_cast<int>(nextSequence), m_sequence);
+        m_bytesDone = qMin(m_sequenceBase * m_fragmentSize, m_data.size());
+        m_timer.start();
+        emit progress(m_bytesDone, m_data.size());
+    }
+
+    // Go back to the fragment the target expects, the fragments that were sent after it are
+    // discarded by the target as well and their errors don't cause another go back
+    if (result != Result::Ok)
+    {
+        if (m_ignoreErrors > 0)
+        {
+            m_ignoreErrors--;
+        }
+        else
+        {
+            m_ignoreErrors = qMax(0, m_sequence - m_sequenceBase - 1);
+            m_sequence = m_sequenceBase;
+        }
+    }
+
+    if (bytesRemaining() == 0)
+    {
+        finish(true);
+    }
+}
+
+quint16 MemoryTransfer::crc16(const uint8_t* data, int size)
+{
+    quint16 crc = 0xFFFF;
+    for (int i = 0; i < size; i++)
+    {
+        crc ^= static_cast<quint16>(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ 0x1021) : static_cast<quint16>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void MemoryTransfer::finish(bool ok)
+{
+    m_timer.stop();
+    m_direction = Direction::None;
+    m_fragmentSize = 0;
+    emit finished(ok);
+}
+
+void MemoryTransfer::timeout()
+{
+    // Request the remainder again: a read from the next position, a write from the first fragment
+    // that is not acknowledged (or the whole write when the request itself got lost)
+    if (m_direction == Direction::Write)
+    {
+        m_sequence = m_sequenceBase;
+        m_ignoreErrors = 0;
+    }
+    if (isBusy())
+    {
+        emit retry();
+    }
+}
@@ -0,0 +1,148 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef MEMORYTRANSFER_H
+#define MEMORYTRANSFER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+class Register;
+
+/**
+ * @brief Block transfer of target memory of a Cpu, starting at the address of a Register.
+ * A read is streamed by the target and a write is sent by the host, both in fragments with a
+ * sequence number and a CRC-16. A lost or corrupted fragment makes the transfer continue from
+ * the last fragment that was received (read) or acknowledged (write).
+ */
+class MemoryTransfer : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Direction{
+        None,
+        Read,
+        Write
+    };
+
+    enum class Result{
+        Ok = 0x00,
+        Invalid = 0x01,
+        CrcError = 0x02,
+        SequenceError = 0x03,
+        NoTransfer = 0x04
+    };
+
+    explicit MemoryTransfer(QObject* parent = nullptr);
+
+    Direction direction() const {return m_direction;}
+    bool isBusy() const {return m_direction != Direction::None;}
+    bool isStarted() const {return m_fragmentSize > 0;}
+    const Register* reg() const {return m_register;}
+    const QVector<uint8_t>& data() const {return m_data;}
+    int bytesDone() const {return m_bytesDone;}
+
+    /**
+     * @brief Position (relative to the Register) of the first byte that still needs to be transferred
+     */
+    quint32 nextPosition() const {return m_position + static_cast<quint32>(m_bytesDone);}
+    int bytesRemaining() const {return m_data.size() - m_bytesDone;}
+
+    /**
+     * @brief Prepare reading size bytes from position bytes after the address of reg
+     */
+    void startRead(const Register* reg, quint32 position, int size);
+
+    /**
+     * @brief Prepare writing data from position bytes after the address of reg
+     */
+    void startWrite(const Register* reg, quint32 position, const QVector<uint8_t>& data);
+
+    /**
+     * @brief Abort the transfer, finished() is emitted with false
+     */
+    void abort();
+
+    /**
+     * @brief The read or write of nextPosition() is requested from the target
+     */
+    void requested();
+
+    /**
+     * @brief Reply of the target on the read or write request
+     * @param result memoryOk when the target accepted the request
+     * @param fragmentSize Number of data bytes per fragment
+     */
+    void started(Result result, int fragmentSize);
+
+    /**
+     * @brief Store a fragment of a read
+     * @param fragment Sequence number, data and CRC
+     * @return false when a fragment was lost or corrupted, the remainder then needs to be requested again
+     */
+    bool receivedFragment(const QVector<uint8_t>& fragment);
+
+    /**
+     * @brief Next fragment of a write to send, a few fragments are kept in flight
+     * @return Sequence number, data and CRC, empty when no fragment needs to be sent now
+     */
+    QVector<uint8_t> nextWriteFragment();
+
+    /**
+     * @brief Acknowledge of a write fragment, after an error the fragments from nextSequence on are sent again
+     * @param nextSequence Sequence number that the target expects next
+     * @param result Result of the fragment
+     */
+    void receivedWriteAck(quint16 nextSequence, Result result);
+
+    /**
+     * @brief CRC-16/CCITT (polynomial 0x1021, start with 0xFFFF) as used by the fragments
+     */
+    static quint16 crc16(const uint8_t* data, int size);
+
+signals:
+    void progress(int bytesDone, int bytesTotal);
+    void finished(bool ok);
+
+    /**
+     * @brief The target didn't respond in time, the remainder needs to be requested again
+     */
+    void retry();
+
+private:
+    void finish(bool ok);
+    void timeout();
+
+    static const int m_maxFragmentsInFlight = 4;
+    static const int m_timeout_ms = 1000;
+
+    Direction m_direction = Direction::None;
+    const Register* m_register = nullptr;
+    quint32 m_position = 0;
+    QVector<uint8_t> m_data;
+    int m_bytesDone = 0;
+    int m_fragmentSize = 0;
+    int m_sequence = 0;             /**< Read: next expected fragment, write: next fragment to send */
+    int m_sequenceBase = 0;         /**< Write: first fragment that is not acknowledged */
+    int m_ignoreErrors = 0;         /**< Write: errors of fragments that were already in flight when going back */
+    bool m_resync = false;          /**< Read: fragments of the previous request are ignored until the first one */
+    QTimer m_timer;
+};
+
+#endif // MEMORYTRANSFER_H
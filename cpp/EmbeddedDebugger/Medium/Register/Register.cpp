@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Register.h"
 #include "Medium/CPU/Cpu.h"
 #include <QDebug>
+#include <cstring>
 
 Register::Register(uint id, QString name, Register::ReadWrite readWrite, Register::VariableType variableType, Register::Source source, uint derefDepth, uint offset, Cpu& cpu) :
     m_id(id),
@@ -38,7 +39,130 @@ Register::Register(uint id, QString name, Register::ReadWrite readWrite, Registe
 
 int Register::getVariableTypeSize() const
 {
-    m_cpu.getVariableTypeSize(m_variableType);
+    return m_cpu.getVariableTypeSize(m_variableType);
+}
+
+void Register::setRateGroup(int rateGroup)
+{
+    m_rateGroup = rateGroup;
+    // An active debug channel needs to be configured again to move to the new group
+    if (m_channelMode != Register::ChannelMode::Off)
+    {
+        emit configDebugChannel(*this);
+    }
+}
+
+void Register::setAggregated(bool aggregated)
+{
+    m_aggregated = aggregated;
+    // An active debug channel needs to be configured again to send the window instead of the value, or back
+    if (m_channelMode != Register::ChannelMode::Off)
+    {
+        emit configDebugChannel(*this);
+    }
+}
+
+void Register::clearEnvelopeSeries()
+{
+    m_envelopeSeries.clear();
+}
+
+double Register::sampleRate() const
+{
+    return m_cpu.sampleRate(m_rateGroup);
+}
+
+QDateTime Register::wallClockTime() const
+{
+    return m_cpu.wallClockTime(m_lastRegisterValueTimestamp);
+}
+
+QVariant Register::valueFromBytes(const QVector<uint8_t>& data) const
+{
+    // Raw target memory (little endian), integer types are interpreted by their size on the target
+    quint64 raw = 0;
+    for (int i = qMin(data.size(), 8) - 1; i >= 0; i--)
+    {
+        raw = (raw << 8) | data[i];
+    }
+
+    switch (m_variableType)
+    {
+    case Register::VariableType::Bool:
+    {
+        return QVariant(raw != 0);
+    }
+    case Register::VariableType::Char:
+    {
+        return QVariant::fromValue(static_cast<uint8_t>(raw));
+    }
+    case Register::VariableType::Float:
+    {
+        quint32 raw32 = static_cast<quint32>(raw);
+        float value;
+        memcpy(&value, &raw32, sizeof(value));
+        return QVariant(value);
+    }
+    case Register::VariableType::Double:
+    case Register::VariableType::LongDouble:
+    {
+        double value;
+        memcpy(&value, &raw, sizeof(value));
+        return QVariant(value);
+    }
+    case Register::VariableType::Short:
+    case Register::VariableType::Int:
+    case Register::VariableType::Long:
+    {
+        switch (data.size())
+        {
+        case 1: return QVariant(static_cast<int>(static_cast<qint8>(raw)));
+        case 2: return QVariant(static_cast<int>(static_cast<qint16>(raw)));
+        case 4: return QVariant(static_cast<qint32>(raw));
+        default: return QVariant(static_cast<qint64>(raw));
+        }
+    }
+    default:
+    {
+        return QVariant();
+    }
+    }
+}
+
+QVector<uint8_t> Register::bytesFromValue(const QVariant& value) const
+{
+    // Raw target memory (little endian) in the size of the variable type on the target
+    quint64 raw = 0;
+    switch (m_variableType)
+    {
+    case Register::VariableType::Float:
+    {
+        float floatValue = value.toFloat();
+        quint32 raw32;
+        memcpy(&raw32, &floatValue, sizeof(raw32));
+        raw = raw32;
+        break;
+    }
+    case Register::VariableType::Double:
+    case Register::VariableType::LongDouble:
+    {
+        double doubleValue = value.toDouble();
+        memcpy(&raw, &doubleValue, sizeof(raw));
+        break;
+    }
+    default:
+    {
+        raw = static_cast<quint64>(value.toLongLong());
+        break;
+    }
+    }
+
+    QVector<uint8_t> bytes;
+    for (int i = 0; i < getVariableTypeSize() && i < 8; i++)
+    {
+        bytes.append(static_cast<uint8_t>(raw >> (8 * i)));
+    }
+    return bytes;
 }
 
 void Register::configDebugChannel(Register::ChannelMode newChannelMode)
@@ -66,6 +190,26 @@ void Register::setValue(const QVariant &value)
 
 }
 
+void Register::scheduleValue(const QVariant &value, quint64 tick)
+{
+    // Written by the target at the tick, together with the other values of that tick (after Cpu::commitSchedule())
+    m_cpu.scheduleWrite(this, value, tick);
+}
+
+void Register::stimulate(const Stimulus::Settings& settings, quint64 startTick)
+{
+    // Written by the target every settings.decimation ticks, before the debug channels of the tick are sampled
+    m_cpu.startStimulus(this, settings, startTick);
+}
+
+void Register::stopStimulus()
+{
+    if (m_cpu.stimulus().reg() == this)
+    {
+        m_cpu.stopStimulus();
+    }
+}
+
 void Register::queryRegister()
 {
     emit queryRegister(*this);
@@ -135,7 +279,7 @@ void Register::receivedNewRegisterValue(QVariant newRegisterValue)
     }
 }
 
-void Register::receivedNewRegisterValue(QVariant newRegisterValue, uint timeStamp)
+void Register::receivedNewRegisterValue(QVariant newRegisterValue, quint64 timeStamp)
 {
     if (m_registerValue != newRegisterValue)
     {
@@ -144,3 +288,15 @@ void Register::receivedNewRegisterValue(QVariant newRegisterValue, uint timeStam
         emit registerDataChanged(*this);
     }
 }
+
+void Register::receivedNewEnvelope(QVariant min, QVariant max, QVariant mean, quint64 timeStamp)
+{
+    // Every window is kept (also when it equals the previous one), the mean is the value of the Register
+    if (m_envelopeSeries.size() >= maxEnvelopeSeries)
+    {
+        m_envelopeSeries.remove(0, m_envelopeSeries.size() - maxEnvelopeSeries + 1);
+    }
+    m_envelopeSeries.append({min, max, mean, timeStamp});
+    emit envelopeReceived(*this);
+    receivedNewRegisterValue(std::move(mean), timeStamp);
+}
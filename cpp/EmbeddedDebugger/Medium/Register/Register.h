@@ -19,9 +19,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef REGISTER_H
 #define REGISTER_H
 
+#include <QDateTime>
 #include <QVariant>
 #include <QObject>
 #include <QPair>
+#include <QVector>
+#include "Medium/Stimulus/Stimulus.h"
 class Cpu;
 
 class Register : public QObject
@@ -47,6 +50,7 @@ public:
         HandWrittenIndex = 0x10,
         SimulinkCApiOffset = 0x40,
         SimulinkCApiIndex = 0x50,
+        StimulusTable = 0x60,       // waveform table of the stimulus generator, only for memory transfers
         AbsoluteAddress = 0x70,
         Unknown,
     };
@@ -68,6 +72,17 @@ public:
 
     };
 
+    // Min, max and mean of the values of an aggregated debug channel since its previous sample (the window)
+    struct Envelope
+    {
+        QVariant min;
+        QVariant max;
+        QVariant mean;
+        quint64 timeStamp;
+    };
+
+    static const int maxEnvelopeSeries = 100000;    // oldest envelopes are dropped beyond this
+
     Register(uint id, QString name, Register::ReadWrite readWrite, Register::VariableType variableType, Register::Source source, uint derefDepth, uint offset, Cpu& cpu);
 
     uint id() const {return m_id;}
@@ -80,11 +95,24 @@ public:
     uint derefDepth() const {return m_derefDepth;}
     uint32_t offset() const {return m_offset;}
     uint timeStampUnits() const {return m_timeStampUnits;}
+    int rateGroup() const {return m_rateGroup;}
+    void setRateGroup(int rateGroup);
+    bool aggregated() const {return m_aggregated;}
+    void setAggregated(bool aggregated);
+    const QVector<Register::Envelope>& envelopeSeries() const {return m_envelopeSeries;}
+    void clearEnvelopeSeries();
+    double sampleRate() const;
     QVariant value() const {return m_registerValue;}
-    uint timeStamp() const {return m_lastRegisterValueTimestamp;}
+    quint64 timeStamp() const {return m_lastRegisterValueTimestamp;}
+    QDateTime wallClockTime() const;
     Cpu& cpu() const {return m_cpu;}
+    QVariant valueFromBytes(const QVector<uint8_t>& data) const;
+    QVector<uint8_t> bytesFromValue(const QVariant& value) const;
     void configDebugChannel(ChannelMode newChannelMode);
     void setValue(const QVariant &value);
+    void scheduleValue(const QVariant &value, quint64 tick);
+    void stimulate(const Stimulus::Settings& settings, quint64 startTick = 0);
+    void stopStimulus();
     void queryRegister();
 
     static Register::ReadWrite ReadWritefromString(const QString& enumString);
@@ -96,13 +124,15 @@ public:
 
 public slots:
     void receivedNewRegisterValue(QVariant newRegisterValue);
-    void receivedNewRegisterValue(QVariant newRegisterValue, uint timeStamp);
+    void receivedNewRegisterValue(QVariant newRegisterValue, quint64 timeStamp);
+    void receivedNewEnvelope(QVariant min, QVariant max, QVariant mean, quint64 timeStamp);
 
 signals:
     void configDebugChannel(Register& Register);
     void writeRegister(Register& Register);
     void queryRegister(Register& Register);
     void registerDataChanged(Register& Register);
+    void envelopeReceived(Register& Register);
 
 private:
     uint m_id;
@@ -114,8 +144,11 @@ private:
     uint m_derefDepth = 0;
     uint32_t m_offset = 0;
     uint m_timeStampUnits = 0;
+    int m_rateGroup = 0;
+    bool m_aggregated = false;
+    QVector<Register::Envelope> m_envelopeSeries;
     QVariant m_registerValue;
-    uint m_lastRegisterValueTimestamp = 0;
+    quint64 m_lastRegisterValueTimestamp = 0;
     Cpu& m_cpu;
 };
 
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Medium/Register/Register.h"
 #include "Medium/CPU/Cpu.h"
 #include <QDebug>
+#include <QTimer>
 
 RegisterListModel::RegisterListModel(QObject* parent)
 {
@@ -280,9 +281,37 @@ Register *RegisterListModel::getRegisterByCpuIdAndOffset(uint8_t uCId, int32_t o
 void RegisterListModel::registerDataChanged(Register &Register)
 {
     int row = m_registers.indexOf(&Register);
-    QModelIndex startOfRow = this->index(row, 0);
-    QModelIndex endOfRow   = this->index(row, columnCount(QModelIndex()));
+    if (row < 0)
+    {
+        return;
+    }
+
+    // Rows that change in the same event-loop iteration (e.g. a multi-register query) are updated together
+    if (m_firstChangedRow < 0)
+    {
+        m_firstChangedRow = row;
+        m_lastChangedRow = row;
+        QTimer::singleShot(0, this, &RegisterListModel::emitRowsChanged);
+    }
+    else
+    {
+        m_firstChangedRow = qMin(m_firstChangedRow, row);
+        m_lastChangedRow = qMax(m_lastChangedRow, row);
+    }
+}
 
+void RegisterListModel::emitRowsChanged()
+{
+    // The model may have been cleared in the meantime
+    int lastRow = qMin(m_lastChangedRow, m_registers.size() - 1);
+    QModelIndex startOfRow = this->index(m_firstChangedRow, 0);
+    QModelIndex endOfRow   = this->index(lastRow, columnCount(QModelIndex()) - 1);
+    m_firstChangedRow = -1;
+    m_lastChangedRow = -1;
+    if (!startOfRow.isValid() || !endOfRow.isValid())
+    {
+        return;
+    }
 
-    emit dataChanged(startOfRow,endOfRow, {Qt::DisplayRole}); //TODO: CHECK THIS HACK
+    emit dataChanged(startOfRow,endOfRow, {Qt::DisplayRole});
 }
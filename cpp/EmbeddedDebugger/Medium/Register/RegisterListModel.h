@@ -53,7 +53,11 @@ private slots:
     void registerDataChanged(Register& Register);
 
 private:
+    void emitRowsChanged();
+
     QVector<Register*> m_registers;
+    int m_firstChangedRow = -1;     /**< Rows that changed in this event-loop iteration, -1 when none */
+    int m_lastChangedRow = -1;
 };
 
 #endif // REGISTERLISTMODEL_H
@@ -0,0 +1,178 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "Schedule.h"
+#include "Medium/Register/Register.h"
+#include <QDebug>
+
+Schedule::Schedule(QObject *parent) :
+    QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(m_pollInterval_ms);
+    QObject::connect(&m_timer,&QTimer::timeout,this,&Schedule::poll);
+}
+
+void Schedule::addWrite(const Register* reg, const QVariant& value, quint64 tick)
+{
+    // A later write of the same Register in the same step replaces the earlier one
+    QVector<Write>& writes = m_pendingSteps[tick];
+    Write write;
+    write.reg = reg;
+    write.value = reg->bytesFromValue(value);
+    for (Write& existing : writes)
+    {
+        if (existing.reg == reg)
+        {
+            existing = write;
+            return;
+        }
+    }
+    writes.append(write);
+}
+
+void Schedule::clear()
+{
+    m_pendingSteps.clear();
+    m_stepOfGroup.clear();
+    m_writesInFlight.clear();
+    m_failedGroups.clear();
+    m_armedGroups.clear();
+    m_timer.stop();
+}
+
+void Schedule::setStatus(quint32 targetTick, int freeWrites, const QVector<Group>& groups)
+{
+    m_targetTick = targetTick;
+    m_groups = groups;
+
+    // Writes that are still in flight may not be counted by the target yet
+    m_freeWrites = freeWrites;
+    for (int writeCount : m_writesInFlight)
+    {
+        m_freeWrites -= writeCount;
+    }
+
+    // The steps of groups that are no longer armed are applied (or cancelled by the target)
+    for (int group : QVector<int>(m_armedGroups))
+    {
+        if (group >= groups.size() || groups[group].state == GroupState::Armed)
+        {
+            continue;
+        }
+        quint64 tick = m_stepOfGroup.value(group);
+        if (groups[group].state == GroupState::Applied)
+        {
+            emit stepApplied(tick, tick + static_cast<qint32>(groups[group].tick - static_cast<quint32>(tick)));
+        }
+        else
+        {
+            qWarning() << "Scheduled step of tick" << tick << "was cancelled by the target";
+        }
+        freeGroup(group);
+    }
+
+    if (isBusy())
+    {
+        m_timer.start();
+    }
+    emit statusChanged();
+}
+
+int Schedule::takeNextStep(quint64& tick, QVector<Write>& writes)
+{
+    while (hasStatus() && !m_pendingSteps.isEmpty())
+    {
+        // A step that needs more writes than the target has can never be sent
+        int writeCount = m_pendingSteps.first().size();
+        if (writeCount > m_freeWrites)
+        {
+            if (!m_stepOfGroup.isEmpty())
+            {
+                return -1;
+            }
+            tick = m_pendingSteps.firstKey();
+            m_pendingSteps.remove(tick);
+            emit stepFailed(tick, Result::Full);
+            continue;
+        }
+
+        // The earliest step goes to the first group that is free on both sides
+        for (int group = 0; group < m_groups.size(); group++)
+        {
+            if (!m_stepOfGroup.contains(group) && m_groups[group].state != GroupState::Armed &&
+                m_groups[group].state != GroupState::Failed)
+            {
+                tick = m_pendingSteps.firstKey();
+                writes = m_pendingSteps.take(tick);
+                m_stepOfGroup.insert(group, tick);
+                m_writesInFlight.insert(group, writeCount);
+                m_freeWrites -= writeCount;
+                return group;
+            }
+        }
+        return -1;
+    }
+    return -1;
+}
+
+void Schedule::added(int group, Result result)
+{
+    if (result != Result::Ok && m_stepOfGroup.contains(group))
+    {
+        m_failedGroups.insert(group, result);
+    }
+}
+
+bool Schedule::committed(int group, Result result, quint32 targetTick)
+{
+    m_targetTick = targetTick;
+    if (!m_stepOfGroup.contains(group))
+    {
+        return false;
+    }
+    m_writesInFlight.remove(group);
+
+    // The result of a failed add wins over the result of the commit of the discarded group
+    result = m_failedGroups.value(group, result);
+    if (result == Result::Ok)
+    {
+        m_armedGroups.append(group);
+        if (!m_timer.isActive())
+        {
+            m_timer.start();
+        }
+        return false;
+    }
+    qWarning() << "Scheduled step of tick" << m_stepOfGroup.value(group) << "was refused by the target:" << static_cast<int>(result);
+    emit stepFailed(m_stepOfGroup.value(group), result);
+    freeGroup(group);
+
+    // A busy group is armed with a step that isn't ours, it is left alone
+    return result != Result::Busy;
+}
+
+void Schedule::freeGroup(int group)
+{
+    m_stepOfGroup.remove(group);
+    m_writesInFlight.remove(group);
+    m_failedGroups.remove(group);
+    m_armedGroups.removeAll(group);
+}
@@ -0,0 +1,167 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+class Register;
+
+/**
+ * @brief Register writes of a Cpu that the target applies at an exact tick.
+ * The writes with the same tick form a step, the target applies all writes of a step in that
+ * tick (before it samples the debug channels of the tick). Steps are committed in the groups of
+ * the target, a step waits on the host until a group is free, so a longer sequence of steps can
+ * be scheduled ahead of time.
+ */
+class Schedule : public QObject
+{
+    Q_OBJECT
+public:
+    enum class GroupState{
+        Open = 0x00,
+        Armed = 0x01,
+        Applied = 0x02,
+        Failed = 0x03       /**< An add failed, the group refuses adds and commits until it is cancelled */
+    };
+
+    enum class Result{
+        Ok = 0x00,
+        Invalid = 0x01,
+        Full = 0x02,
+        Busy = 0x03,
+        Late = 0x04,
+        Failed = 0x05       /**< An earlier add of the group failed */
+    };
+
+    /**
+     * @brief Write of a step, the value in the raw target format of the Register
+     */
+    struct Write
+    {
+        const Register* reg = nullptr;
+        QVector<uint8_t> value;
+    };
+
+    /**
+     * @brief Group of the target as reported by its status
+     */
+    struct Group
+    {
+        GroupState state = GroupState::Open;
+        quint32 tick = 0;           /**< Tick of an armed group, or the tick an applied group was applied at */
+        int writeCount = 0;
+    };
+
+    explicit Schedule(QObject* parent = nullptr);
+
+    const QMap<quint64,QVector<Write>>& pendingSteps() const {return m_pendingSteps;}
+    const QVector<Group>& groups() const {return m_groups;}
+    bool hasStatus() const {return !m_groups.isEmpty();}
+    bool isBusy() const {return !m_pendingSteps.isEmpty() || m_stepOfGroup.size() > 0;}
+    quint32 targetTick() const {return m_targetTick;}
+
+    /**
+     * @brief Add a write to the step of tick, it is sent with the next commit
+     * @param reg Register to write
+     * @param value Value in the type of reg
+     * @param tick Tick of the target at which the value is written
+     */
+    void addWrite(const Register* reg, const QVariant& value, quint64 tick);
+
+    /**
+     * @brief Forget the steps that are not sent yet and the groups that are in use
+     */
+    void clear();
+
+    /**
+     * @brief Store the status reported by the target, groups that are no longer armed are free again
+     * @param targetTick Current tick of the target
+     * @param freeWrites Number of writes the target can still hold
+     * @param groups State of every group of the target
+     */
+    void setStatus(quint32 targetTick, int freeWrites, const QVector<Group>& groups);
+
+    /**
+     * @brief Take the earliest pending step out of the pending steps, when a group and enough writes are free
+     * @param tick Tick of the step
+     * @param writes Writes of the step
+     * @return Group that the step is sent in, or -1 when no step can be sent now
+     */
+    int takeNextStep(quint64& tick, QVector<Write>& writes);
+
+    /**
+     * @brief Reply of the target on adding writes of a step, a failed add discards the group on the target
+     * and the group refuses the next adds and the commit, so no part of the step is applied
+     * @param group Group of the step
+     * @param result Result of the target
+     */
+    void added(int group, Result result);
+
+    /**
+     * @brief Reply of the target on committing a step, the step is dropped when it is not armed
+     * @param group Group of the step
+     * @param result Result of the target
+     * @param targetTick Current tick of the target
+     * @return True when the step was refused and the group isn't armed, the group then needs to be cancelled
+     * on the target before it is used again
+     */
+    bool committed(int group, Result result, quint32 targetTick);
+
+signals:
+    void statusChanged();
+
+    /**
+     * @brief A step was applied by the target
+     * @param tick Tick of the step
+     * @param appliedTick Tick at which the target applied it
+     */
+    void stepApplied(quint64 tick, quint64 appliedTick);
+
+    /**
+     * @brief A step was refused by the target, e.g. because its tick had already passed
+     */
+    void stepFailed(quint64 tick, Schedule::Result result);
+
+    /**
+     * @brief The status of the target needs to be read, to send the next steps
+     */
+    void poll();
+
+private:
+    void freeGroup(int group);
+
+    static const int m_pollInterval_ms = 50;
+
+    QMap<quint64,QVector<Write>> m_pendingSteps;
+    QVector<Group> m_groups;
+    QMap<int,quint64> m_stepOfGroup;    /**< Groups that hold a step that is sent and not yet applied */
+    QMap<int,int> m_writesInFlight;     /**< Number of writes of the groups of which the commit is not yet replied */
+    QMap<int,Result> m_failedGroups;    /**< Groups of which an add failed, they are free after the commit reply */
+    QVector<int> m_armedGroups;         /**< Groups that the target armed, they are free when no longer armed */
+    int m_freeWrites = 0;
+    quint32 m_targetTick = 0;
+    QTimer m_timer;
+};
+
+#endif // SCHEDULE_H
@@ -0,0 +1,121 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Stimulus.h"
+#include "Medium/Register/Register.h"
+#include <QtMath>
+
+Stimulus::Stimulus(QObject *parent) :
+    QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(m_pollInterval_ms);
+    QObject::connect(&m_timer,&QTimer::timeout,this,&Stimulus::poll);
+}
+
+void Stimulus::setup(const Register* reg, const Settings& settings, quint64 startTick)
+{
+    m_register = reg;
+    m_settings = settings;
+    m_startTick = startTick;
+    if (m_settings.waveform == Waveform::Table)
+    {
+        m_settings.period = static_cast<quint32>(m_settings.table.size());
+    }
+}
+
+QVector<uint8_t> Stimulus::tableData() const
+{
+    QVector<uint8_t> data;
+    for (const QVariant& value : m_settings.table)
+    {
+        data.append(m_register->bytesFromValue(value));
+    }
+    return data;
+}
+
+bool Stimulus::waveParameters(double sampleTime_s, quint32& param1, quint32& param2) const
+{
+    param1 = 0;
+    param2 = 0;
+    switch (m_settings.waveform)
+    {
+    case Waveform::Sine:
+    {
+        param1 = phaseStep(m_settings.frequency_Hz, sampleTime_s);
+        break;
+    }
+    case Waveform::Chirp:
+    {
+        // The phase-step changes linearly from the start to the end frequency within a sweep
+        quint32 sweep = m_settings.period > 0 ? m_settings.period : m_settings.samples;
+        param1 = phaseStep(m_settings.frequency_Hz, sampleTime_s);
+        if (sweep > 1)
+        {
+            double delta = (m_settings.endFrequency_Hz - m_settings.frequency_Hz) * sampleTime_s * 4294967296.0 * 65536.0 / (sweep - 1);
+            param2 = static_cast<quint32>(static_cast<qint32>(qRound64(qBound(-2147483648.0, delta, 2147483647.0))));
+        }
+        break;
+    }
+    case Waveform::Prbs:
+    {
+        param1 = m_settings.prbsTaps;
+        param2 = m_settings.prbsSeed;
+        break;
+    }
+    case Waveform::Square:
+    {
+        param1 = phaseStep(m_settings.frequency_Hz, sampleTime_s);
+        param2 = static_cast<quint32>(qBound(0.0, m_settings.dutyCycle, 1.0) * 4294967295.0);
+        break;
+    }
+    default: break;
+    }
+    return sampleTime_s > 0.0 || m_settings.waveform == Waveform::Table || m_settings.waveform == Waveform::Prbs;
+}
+
+void Stimulus::setStatus(State state, quint32 firstTick, quint32 played, int tableSize)
+{
+    m_hasStatus = true;
+    m_state = state;
+    m_firstTick = firstTick;
+    m_played = played;
+    m_tableSize = tableSize;
+    if (state == State::Armed || state == State::Running)
+    {
+        m_timer.start();
+    }
+    emit statusChanged();
+}
+
+void Stimulus::setResult(Result result)
+{
+    if (result != Result::Ok)
+    {
+        emit failed(result);
+    }
+    m_timer.start();
+}
+
+quint32 Stimulus::phaseStep(double frequency_Hz, double sampleTime_s)
+{
+    // 2^32 is a full cycle, negative frequencies run backwards
+    double cycles = frequency_Hz * sampleTime_s;
+    return static_cast<quint32>(qRound64((cycles - qFloor(cycles)) * 4294967296.0) & 0xFFFFFFFF);
+}
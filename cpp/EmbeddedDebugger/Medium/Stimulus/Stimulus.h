@@ -0,0 +1,148 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+class Register;
+
+/**
+ * @brief Stimulus generator of a Cpu, which writes a waveform into a Register every few ticks.
+ * The target writes a sample before it samples the debug channels of the tick, so the stimulus
+ * and the response have the same timestamps. A table waveform is uploaded with a memory transfer
+ * before the generator is started, the other waveforms are computed by the target.
+ */
+class Stimulus : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Waveform{
+        Table = 0x00,
+        Sine = 0x01,
+        Chirp = 0x02,
+        Prbs = 0x03,
+        Square = 0x04
+    };
+
+    enum class State{
+        Idle = 0x00,
+        Armed = 0x01,
+        Running = 0x02,
+        Done = 0x03
+    };
+
+    enum class Result{
+        Ok = 0x00,
+        Invalid = 0x01,
+        Busy = 0x02
+    };
+
+    /**
+     * @brief Waveform and timing of a stimulus, a sample is offset + amplitude * waveform (-1...1)
+     */
+    struct Settings
+    {
+        Waveform waveform = Waveform::Sine;
+        double offset = 0.0;
+        double amplitude = 1.0;
+        double frequency_Hz = 1.0;      /**< Sine and square, the start of a chirp */
+        double endFrequency_Hz = 1.0;   /**< Chirp, reached after period samples (or samples when period is 0) */
+        double dutyCycle = 0.5;         /**< Square, 0...1 */
+        quint32 prbsTaps = 0x48000000;  /**< PRBS, feedback taps of the Galois LFSR (PRBS-31) */
+        quint32 prbsSeed = 1;           /**< PRBS, not 0 */
+        int decimation = 1;             /**< A sample every decimation ticks */
+        quint32 period = 0;             /**< Samples after which the waveform restarts, 0 = never (the table size for a table) */
+        quint32 samples = 0;            /**< Samples to play, 0 = until stopped */
+        QVector<QVariant> table;        /**< Table, values in the type of the Register */
+    };
+
+    explicit Stimulus(QObject* parent = nullptr);
+
+    const Register* reg() const {return m_register;}
+    const Settings& settings() const {return m_settings;}
+    quint64 startTick() const {return m_startTick;}
+    bool hasStatus() const {return m_hasStatus;}
+    State state() const {return m_state;}
+    quint32 firstTick() const {return m_firstTick;}
+    quint32 played() const {return m_played;}
+    int tableSize() const {return m_tableSize;}
+
+    /**
+     * @brief Store the stimulus that is started next
+     * @param reg Register to write, it needs to be writable
+     * @param settings Waveform and timing
+     * @param startTick Tick of the target of the first sample, 0 for the next tick
+     */
+    void setup(const Register* reg, const Settings& settings, quint64 startTick);
+
+    /**
+     * @brief Raw table in the target format of reg(), as uploaded to the table of the target
+     */
+    QVector<uint8_t> tableData() const;
+
+    /**
+     * @brief Parameters p1 and p2 of the waveform in the units of the target
+     * @param sampleTime_s Time between two samples (tick time * decimation)
+     * @param param1 Phase-step (2^32 = 1 cycle) or PRBS taps
+     * @param param2 Change of the phase-step (2^-16 units), duty-cycle (2^32 = 100%) or PRBS seed
+     * @return False when the sample time isn't known
+     */
+    bool waveParameters(double sampleTime_s, quint32& param1, quint32& param2) const;
+
+    /**
+     * @brief Store the status reported by the target, it is read again while the generator is armed or running
+     */
+    void setStatus(State state, quint32 firstTick, quint32 played, int tableSize);
+
+    /**
+     * @brief Reply of the target on the config or start of the stimulus
+     */
+    void setResult(Result result);
+
+signals:
+    void statusChanged();
+    void failed(Stimulus::Result result);
+
+    /**
+     * @brief The status of the target needs to be read
+     */
+    void poll();
+
+private:
+    static quint32 phaseStep(double frequency_Hz, double sampleTime_s);
+
+    static const int m_pollInterval_ms = 100;
+
+    const Register* m_register = nullptr;
+    Settings m_settings;
+    quint64 m_startTick = 0;
+    bool m_hasStatus = false;
+    State m_state = State::Idle;
+    quint32 m_firstTick = 0;
+    quint32 m_played = 0;
+    int m_tableSize = 0;
+    QTimer m_timer;
+};
+
+#endif // STIMULUS_H
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "ui_ConnectTab.h"
 #include "Core.h"
 #include "ProfileManager/ProfileManager.h"
+#include "Medium/CPU/CpuListModel.h"
 #include <QDebug>
 #include <QHeaderView>
 #include <QMenu>
@@ -48,6 +49,12 @@ void ConnectTab::init()
 {
     ui->profileCombobox->setModel(&Core::Instance().profileManager().profileList());
     ui->cpuTableView->setModel(Core::Instance().profileManager().cpuListModel());
+
+    // The statistics have their own tab, they can be shown through the header menu
+    for (int i = CpuListModel::firstStatsColumn; i < ui->cpuTableView->model()->columnCount(); i++)
+    {
+        ui->cpuTableView->setColumnHidden(i, true);
+    }
 }
 
 void ConnectTab::on_connectButton_clicked()
@@ -0,0 +1,82 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StatsTab.h"
+#include "ui_StatsTab.h"
+#include "Core.h"
+#include "ProfileManager/ProfileManager.h"
+#include "Medium/CPU/CpuListModel.h"
+#include <QDebug>
+
+StatsTab::StatsTab(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::StatsTab),
+    m_readButtonDelegate(tr("Read")),
+    m_resetButtonDelegate(tr("Reset"))
+{
+    ui->setupUi(this);
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &StatsTab::readAllStats);
+}
+
+StatsTab::~StatsTab()
+{
+    delete ui;
+}
+
+void StatsTab::init()
+{
+    ui->statsTableView->setModel(Core::Instance().profileManager().cpuListModel());
+    ui->statsTableView->setItemDelegateForColumn(CpuListModel::readStatsColumn, &m_readButtonDelegate);
+    ui->statsTableView->setItemDelegateForColumn(CpuListModel::resetStatsColumn, &m_resetButtonDelegate);
+
+    // Only the id and name of the Cpu next to its statistics
+    for (int i = 2; i < CpuListModel::firstStatsColumn; i++)
+    {
+        ui->statsTableView->setColumnHidden(i, true);
+    }
+    connect(ui->statsTableView->model(), &QAbstractItemModel::rowsInserted, this, [&](){
+        for (int i = 0; i < ui->statsTableView->model()->rowCount(); i++)
+        {
+            ui->statsTableView->openPersistentEditor(ui->statsTableView->model()->index(i, CpuListModel::readStatsColumn));
+            ui->statsTableView->openPersistentEditor(ui->statsTableView->model()->index(i, CpuListModel::resetStatsColumn));
+        }
+    });
+}
+
+void StatsTab::on_autoRefreshCheckBox_toggled(bool checked)
+{
+    if (checked)
+    {
+        readAllStats();
+        m_refreshTimer.start();
+    }
+    else
+    {
+        m_refreshTimer.stop();
+    }
+}
+
+void StatsTab::readAllStats()
+{
+    QAbstractItemModel* model = ui->statsTableView->model();
+    for (int i = 0; i < model->rowCount(); i++)
+    {
+        model->setData(model->index(i, CpuListModel::readStatsColumn), true);
+    }
+}
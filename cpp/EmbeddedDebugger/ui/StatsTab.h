@@ -0,0 +1,54 @@
+/*
+Embedded Debugger PC Application which can be used to debug embedded systems at a high level.
+Copyright (C) 2019 DEMCON advanced mechatronics B.V.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STATSTAB_H
+#define STATSTAB_H
+
+#include <QTimer>
+#include <QWidget>
+#include "PushButtonDelegate.h"
+
+namespace Ui {
+class StatsTab;
+}
+
+/**
+ * @brief Shows the CPU-cost statistics of the debugger on each Cpu
+ */
+class StatsTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StatsTab(QWidget *parent = nullptr);
+    ~StatsTab();
+
+    void init();
+
+private slots:
+    void on_autoRefreshCheckBox_toggled(bool checked);
+    void readAllStats();
+
+private:
+    Ui::StatsTab *ui;
+    PushButtonDelegate m_readButtonDelegate;
+    PushButtonDelegate m_resetButtonDelegate;
+    QTimer m_refreshTimer;
+};
+
+#endif // STATSTAB_H